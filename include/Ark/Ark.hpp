@@ -16,6 +16,10 @@
 #include <Ark/Constants.hpp>
 #include <Ark/Utils.hpp>
 #include <Ark/VM/VM.hpp>
+#include <Ark/VM/VMPool.hpp>
+#include <Ark/VM/RegisterVM.hpp>
 #include <Ark/Compiler/Compiler.hpp>
+#include <Ark/Compiler/CppEmitter.hpp>
+#include <Ark/Compiler/RegisterCompiler.hpp>
 
 #endif
@@ -41,10 +41,54 @@ namespace Ark::internal::Builtins
         Value removeAtList(std::vector<Value>& n, Ark::VM* vm);  // list:removeAt, 2 arguments -- DEPRECATED
         Value sliceList(std::vector<Value>& n, Ark::VM* vm);     // list:slice, 4 arguments
         Value sort_(std::vector<Value>& n, Ark::VM* vm);         // list:sort, 1 argument
+        Value sortBy(std::vector<Value>& n, Ark::VM* vm);        // list:sortBy, 2 arguments
+        Value map_(std::vector<Value>& n, Ark::VM* vm);          // list:map, 2 arguments
+        Value filter(std::vector<Value>& n, Ark::VM* vm);        // list:filter, 2 arguments
+        Value reduce(std::vector<Value>& n, Ark::VM* vm);        // list:reduce, 2 arguments
+        Value pmap(std::vector<Value>& n, Ark::VM* vm);          // list:pmap, 2 arguments
         Value fill(std::vector<Value>& n, Ark::VM* vm);          // list:fill, 2 arguments
         Value setListAt(std::vector<Value>& n, Ark::VM* vm);     // list:setAt, 3 arguments
     }
 
+    namespace Dict
+    {
+        Value dict(std::vector<Value>& n, Ark::VM* vm);      // dict, multiple arguments
+        Value get(std::vector<Value>& n, Ark::VM* vm);       // dict:get, 2 or 3 arguments
+        Value set(std::vector<Value>& n, Ark::VM* vm);       // dict:set, 3 arguments
+        Value remove(std::vector<Value>& n, Ark::VM* vm);    // dict:remove, 2 arguments
+        Value contains(std::vector<Value>& n, Ark::VM* vm);  // dict:contains?, 2 arguments
+        Value keys(std::vector<Value>& n, Ark::VM* vm);      // dict:keys, 1 argument
+        Value size(std::vector<Value>& n, Ark::VM* vm);      // dict:size, 1 argument
+    }
+
+    namespace Set
+    {
+        Value new_(std::vector<Value>& n, Ark::VM* vm);          // set:new, multiple arguments
+        Value fromList(std::vector<Value>& n, Ark::VM* vm);      // set:fromList, 1 argument
+        Value toList(std::vector<Value>& n, Ark::VM* vm);        // set:toList, 1 argument
+        Value contains(std::vector<Value>& n, Ark::VM* vm);      // set:contains?, 2 arguments
+        Value add(std::vector<Value>& n, Ark::VM* vm);           // set:add, 2 arguments
+        Value remove(std::vector<Value>& n, Ark::VM* vm);        // set:remove, 2 arguments
+        Value size(std::vector<Value>& n, Ark::VM* vm);          // set:size, 1 argument
+        Value union_(std::vector<Value>& n, Ark::VM* vm);        // set:union, 2 arguments
+        Value intersection(std::vector<Value>& n, Ark::VM* vm);  // set:intersection, 2 arguments
+        Value difference(std::vector<Value>& n, Ark::VM* vm);    // set:difference, 2 arguments
+    }
+
+    namespace Array
+    {
+        Value fromList(std::vector<Value>& n, Ark::VM* vm);  // array:fromList, 1 argument
+        Value toList(std::vector<Value>& n, Ark::VM* vm);    // array:toList, 1 argument
+        Value sum(std::vector<Value>& n, Ark::VM* vm);       // array:sum, 1 argument
+        Value dot(std::vector<Value>& n, Ark::VM* vm);       // array:dot, 2 arguments
+        Value min_(std::vector<Value>& n, Ark::VM* vm);      // array:min, 1 argument
+        Value max_(std::vector<Value>& n, Ark::VM* vm);      // array:max, 1 argument
+        Value scale(std::vector<Value>& n, Ark::VM* vm);     // array:scale, 2 arguments
+        Value add(std::vector<Value>& n, Ark::VM* vm);       // array:add, 2 arguments
+        Value map(std::vector<Value>& n, Ark::VM* vm);       // array:map, 2 arguments
+        Value sort_(std::vector<Value>& n, Ark::VM* vm);     // array:sort, 1 argument
+    }
+
     namespace IO
     {
         Value print(std::vector<Value>& n, Ark::VM* vm);        // print, multiple arguments
@@ -71,6 +115,13 @@ namespace Ark::internal::Builtins
         Value exit_(std::vector<Value>& n, Ark::VM* vm);    // sys:exit, 1 argument
     }
 
+    namespace Async
+    {
+        Value async_(std::vector<Value>& n, Ark::VM* vm);  // async, 1 or more arguments
+        Value await_(std::vector<Value>& n, Ark::VM* vm);  // await, 1 argument
+        Value yield_(std::vector<Value>& n, Ark::VM* vm);  // yield, 0 argument
+    }
+
     namespace String
     {
         Value format(std::vector<Value>& n, Ark::VM* vm);       // str:format, multiple arguments
@@ -52,6 +52,26 @@
 #define LIST_SORT_ARITY "list:sort needs 1 argument: a list"
 #define LIST_SORT_TE0 "list:sort: list must be a List"
 
+#define LIST_SORTBY_ARITY "list:sortBy needs 2 arguments: list, key"
+#define LIST_SORTBY_TE0 "list:sortBy: list must be a List"
+#define LIST_SORTBY_TE1 "list:sortBy: key must be a Function"
+
+#define LIST_MAP_ARITY "list:map needs 2 arguments: list, function"
+#define LIST_MAP_TE0 "list:map: list must be a List"
+#define LIST_MAP_TE1 "list:map: function must be a Function"
+
+#define LIST_FILTER_ARITY "list:filter needs 2 arguments: list, predicate"
+#define LIST_FILTER_TE0 "list:filter: list must be a List"
+#define LIST_FILTER_TE1 "list:filter: predicate must be a Function"
+
+#define LIST_REDUCE_ARITY "list:reduce needs 2 arguments: list, function"
+#define LIST_REDUCE_TE0 "list:reduce: list must be a List"
+#define LIST_REDUCE_TE1 "list:reduce: function must be a Function"
+#define LIST_REDUCE_EMPTY "list:reduce: list can not be empty"
+#define LIST_PMAP_ARITY "list:pmap needs 2 arguments: list, function"
+#define LIST_PMAP_TE0 "list:pmap: list must be a List"
+#define LIST_PMAP_TE1 "list:pmap: function must be a Function"
+
 #define LIST_FILL_ARITY "list:fill needs 2 arguments: size, value"
 #define LIST_FILL_TE0 "list:fill: size must be a Number"
 
@@ -59,6 +79,100 @@
 #define LIST_SETAT_TE0 "list:setAt: list must be a List"
 #define LIST_SETAT_TE1 "list:setAt: index must be a Number"
 
+// Dict
+
+#define DICT_ARITY "dict needs an even number of arguments: key, value, [...]"
+#define DICT_TE0 "dict: keys must be Numbers (not NaN) or Strings"
+
+#define DICT_GET_ARITY "dict:get needs 2 to 3 arguments: dict, key, [default]"
+#define DICT_GET_TE0 "dict:get: dict must be a Dict"
+#define DICT_GET_TE1 "dict:get: key must be a Number (not NaN) or a String"
+
+#define DICT_SET_ARITY "dict:set needs 3 arguments: dict, key, value"
+#define DICT_SET_TE0 "dict:set: dict must be a Dict"
+#define DICT_SET_TE1 "dict:set: key must be a Number (not NaN) or a String"
+
+#define DICT_REMOVE_ARITY "dict:remove needs 2 arguments: dict, key"
+#define DICT_REMOVE_TE0 "dict:remove: dict must be a Dict"
+#define DICT_REMOVE_TE1 "dict:remove: key must be a Number (not NaN) or a String"
+
+#define DICT_CONTAINS_ARITY "dict:contains? needs 2 arguments: dict, key"
+#define DICT_CONTAINS_TE0 "dict:contains?: dict must be a Dict"
+
+#define DICT_KEYS_ARITY "dict:keys needs 1 argument: dict"
+#define DICT_KEYS_TE0 "dict:keys: dict must be a Dict"
+
+#define DICT_SIZE_ARITY "dict:size needs 1 argument: dict"
+#define DICT_SIZE_TE0 "dict:size: dict must be a Dict"
+
+// Set
+
+#define SET_FROMLIST_ARITY "set:fromList needs 1 argument: list"
+#define SET_FROMLIST_TE0 "set:fromList: list must be a List"
+
+#define SET_TOLIST_ARITY "set:toList needs 1 argument: set"
+#define SET_TOLIST_TE0 "set:toList: set must be a Set"
+
+#define SET_CONTAINS_ARITY "set:contains? needs 2 arguments: set, value"
+#define SET_CONTAINS_TE0 "set:contains?: set must be a Set"
+
+#define SET_ADD_ARITY "set:add needs 2 arguments: set, value"
+#define SET_ADD_TE0 "set:add: set must be a Set"
+
+#define SET_REMOVE_ARITY "set:remove needs 2 arguments: set, value"
+#define SET_REMOVE_TE0 "set:remove: set must be a Set"
+
+#define SET_SIZE_ARITY "set:size needs 1 argument: set"
+#define SET_SIZE_TE0 "set:size: set must be a Set"
+
+#define SET_UNION_ARITY "set:union needs 2 arguments: a, b"
+#define SET_UNION_TE "set:union: a and b must be Sets"
+
+#define SET_INTERSECTION_ARITY "set:intersection needs 2 arguments: a, b"
+#define SET_INTERSECTION_TE "set:intersection: a and b must be Sets"
+
+#define SET_DIFFERENCE_ARITY "set:difference needs 2 arguments: a, b"
+#define SET_DIFFERENCE_TE "set:difference: a and b must be Sets"
+
+// Array
+
+#define ARRAY_FROMLIST_ARITY "array:fromList needs 1 argument: list"
+#define ARRAY_FROMLIST_TE0 "array:fromList: list must be a List of Numbers"
+
+#define ARRAY_TOLIST_ARITY "array:toList needs 1 argument: array"
+#define ARRAY_TOLIST_TE0 "array:toList: array must be an Array"
+
+#define ARRAY_SUM_ARITY "array:sum needs 1 argument: array"
+#define ARRAY_SUM_TE0 "array:sum: array must be an Array"
+
+#define ARRAY_DOT_ARITY "array:dot needs 2 arguments: a, b"
+#define ARRAY_DOT_TE "array:dot: a and b must be Arrays"
+#define ARRAY_DOT_SIZE "array:dot: a and b must have the same size"
+
+#define ARRAY_MIN_ARITY "array:min needs 1 argument: array"
+#define ARRAY_MIN_TE0 "array:min: array must be an Array"
+#define ARRAY_MIN_EMPTY "array:min: array can not be empty"
+
+#define ARRAY_MAX_ARITY "array:max needs 1 argument: array"
+#define ARRAY_MAX_TE0 "array:max: array must be an Array"
+#define ARRAY_MAX_EMPTY "array:max: array can not be empty"
+
+#define ARRAY_SCALE_ARITY "array:scale needs 2 arguments: array, factor"
+#define ARRAY_SCALE_TE0 "array:scale: array must be an Array"
+#define ARRAY_SCALE_TE1 "array:scale: factor must be a Number"
+
+#define ARRAY_ADD_ARITY "array:add needs 2 arguments: a, b"
+#define ARRAY_ADD_TE0 "array:add: a must be an Array"
+#define ARRAY_ADD_TE1 "array:add: b must be an Array or a Number"
+#define ARRAY_ADD_SIZE "array:add: a and b must have the same size"
+
+#define ARRAY_MAP_ARITY "array:map needs 2 arguments: array, function"
+#define ARRAY_MAP_TE0 "array:map: array must be an Array"
+#define ARRAY_MAP_TE1 "array:map: function must be a math function returning a Number, like math:cos"
+
+#define ARRAY_SORT_ARITY "array:sort needs 1 argument: array"
+#define ARRAY_SORT_TE0 "array:sort: array must be an Array"
+
 // Mathematics
 
 #define MATH_ARITY(name) (name " needs 1 argument: value")
@@ -95,4 +209,14 @@
 #define SYS_EXIT_ARITY "sys:exit needs 1 argument: exit code"
 #define SYS_EXIT_TE0 "sys:exit: exit code must be a Number"
 
+// Coroutines
+
+#define ASYNC_ASYNC_ARITY "async needs at least 1 argument: function"
+#define ASYNC_ASYNC_TE0 "async: function must be a Function"
+
+#define ASYNC_AWAIT_ARITY "await needs 1 argument: task"
+#define ASYNC_AWAIT_TE0 "await: task must be a Number"
+
+#define ASYNC_YIELD_ARITY "yield doesn't take any argument"
+
 // Time
@@ -33,6 +33,7 @@
 namespace Ark
 {
     class State;
+    class RegisterCompiler;
 
     /**
      * @brief The ArkScript bytecode compiler
@@ -78,7 +79,15 @@ namespace Ark
          */
         const bytecode_t& bytecode() noexcept;
 
+        /**
+         * @brief Count the instructions in the generated code pages
+         * 
+         * @return std::size_t 
+         */
+        std::size_t instructionsCount() const noexcept;
+
         friend class Ark::State;
+        friend class Ark::RegisterCompiler;
 
     private:
         Parser m_parser;
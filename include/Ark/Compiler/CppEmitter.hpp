@@ -0,0 +1,74 @@
+/**
+ * @file CppEmitter.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Translates ArkScript bytecode to C++, to build the code pages ahead of time
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_COMPILER_CPPEMITTER_HPP
+#define ARK_COMPILER_CPPEMITTER_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cinttypes>
+
+#include <Ark/Platform.hpp>
+#include <Ark/Compiler/BytecodeReader.hpp>
+
+namespace Ark
+{
+    class State;
+
+    /**
+     * @brief Generates a C++ function per code page, using the same protocol as the JIT (see NativePage_t)
+     * @details The generated file must be built as a shared library linked against ArkReactor,
+     *          then loaded with State::loadNativePages (or `ark file.ark --native module`).
+     *          Numbers arithmetic, comparisons, jumps, symbols, constants and builtins loading are translated,
+     *          every other instruction is handed back to the interpreter.
+     *
+     */
+    class ARK_API CppEmitter
+    {
+    public:
+        /**
+         * @brief Construct a new CppEmitter object
+         *
+         * @param state a state holding the bytecode to translate
+         */
+        explicit CppEmitter(const State& state) noexcept;
+
+        /**
+         * @brief Write the C++ code
+         *
+         * @param os
+         */
+        void emit(std::ostream& os) const;
+
+        /**
+         * @brief Write the C++ code to a file
+         *
+         * @param file
+         * @return true on success
+         * @return false if the file couldn't be written
+         */
+        bool saveTo(const std::string& file) const;
+
+    private:
+        const State& m_state;
+
+        /**
+         * @brief Generate the function for a given code page
+         *
+         * @param os
+         * @param page_id
+         */
+        void emitPage(std::ostream& os, std::size_t page_id) const;
+    };
+}
+
+#endif
@@ -61,7 +61,9 @@ namespace Ark::internal
         CONCAT_IN_PLACE = 0x16,
         POP_LIST = 0x17,
         POP_LIST_IN_PLACE = 0x18,
-        LAST_COMMAND = 0x18,
+        DICT_SET_IN_PLACE = 0x19,
+        DICT_REMOVE_IN_PLACE = 0x1a,
+        LAST_COMMAND = 0x1a,
 
         FIRST_OPERATOR = 0x20,
         ADD = 0x20,
@@ -93,6 +95,22 @@ namespace Ark::internal
 
         LAST_INSTRUCTION = 0x38
     };
+
+    /**
+     * @brief Size in bytes of an instruction in a code page, including its argument
+     *
+     * @param inst
+     * @return uint8_t 3 for the commands taking a 2 bytes argument, 1 otherwise
+     */
+    inline uint8_t instructionSize(Inst_t inst) noexcept
+    {
+        if (inst >= Instruction::FIRST_COMMAND && inst <= Instruction::LAST_COMMAND &&
+            inst != Instruction::RET && inst != Instruction::HALT && inst != Instruction::SAVE_ENV &&
+            inst != Instruction::POP_LIST && inst != Instruction::POP_LIST_IN_PLACE &&
+            inst != Instruction::DICT_SET_IN_PLACE && inst != Instruction::DICT_REMOVE_IN_PLACE)
+            return 3;
+        return 1;
+    }
 }
 
 #endif
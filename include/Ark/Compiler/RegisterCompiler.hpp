@@ -0,0 +1,186 @@
+/**
+ * @file RegisterCompiler.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Generates register based bytecode (three-address code) from the AST, for the RegisterVM
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_COMPILER_REGISTERCOMPILER_HPP
+#define ARK_COMPILER_REGISTERCOMPILER_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cinttypes>
+#include <unordered_map>
+
+#include <Ark/Platform.hpp>
+#include <Ark/Compiler/Node.hpp>
+#include <Ark/VM/Value.hpp>
+
+namespace Ark
+{
+    class Compiler;
+
+    namespace internal
+    {
+        /**
+         * @brief The register based instructions
+         * @details Every instruction takes up to 3 operands, `a` being the destination.
+         *          Registers are relative to the frame of the current function, the arguments
+         *          of a function being its first registers.
+         *
+         */
+        enum RegisterInstruction : uint8_t
+        {
+            R_NOP = 0x00,
+            R_LOADK,   ///< R[a] = K[b]
+            R_MOVE,    ///< R[a] = R[b]
+            R_GETG,    ///< R[a] = G[b]
+            R_SETG,    ///< G[a] = RK[b]
+            R_JUMP,    ///< ip = a
+            R_JUMPT,   ///< if RK[a] is true, ip = b
+            R_JUMPF,   ///< if RK[a] is false, ip = b
+            R_CALL,    ///< R[a] = R[a](R[a + 1], ..., R[a + b])
+            R_RET,     ///< return RK[a]
+            R_HALT,
+            R_ADD,     ///< R[a] = RK[b] + RK[c]
+            R_SUB,
+            R_MUL,
+            R_DIV,
+            R_MOD,
+            R_GT,
+            R_LT,
+            R_LE,
+            R_GE,
+            R_NEQ,
+            R_EQ,
+            R_AND,
+            R_OR,
+            R_NOT,     ///< R[a] = not RK[b]
+            R_TO_STR   ///< R[a] = toString RK[b]
+        };
+
+        /// operands with this bit set (RK) refer to the constants table instead of a register
+        constexpr uint16_t RegisterConstantBit = 0x8000;
+
+        struct RegisterInst
+        {
+            RegisterInstruction op;
+            uint16_t a;
+            uint16_t b;
+            uint16_t c;
+        };
+
+        struct RegisterPage
+        {
+            std::vector<RegisterInst> code;
+            uint16_t arity = 0;      ///< number of arguments, held by the first registers
+            uint16_t registers = 0;  ///< number of registers needed by the frame
+        };
+    }
+
+    /**
+     * @brief Compiles the AST to register based bytecode
+     * @details Handles a subset of the language: numbers, strings, builtins, global variables,
+     *          functions without captures (their variables living in registers), if, while, set, let, mut, begin,
+     *          calls, arithmetic, comparison and logical operators, toString.
+     *          A CompilationError is thrown on everything else.
+     *
+     */
+    class ARK_API RegisterCompiler
+    {
+    public:
+        /**
+         * @brief Construct a new RegisterCompiler object
+         *
+         * @param compiler a compiler which has been fed with the code, its AST is used
+         */
+        explicit RegisterCompiler(const Compiler& compiler) noexcept;
+
+        /**
+         * @brief Start the compilation
+         *
+         */
+        void compile();
+
+        /**
+         * @brief Count the generated instructions
+         *
+         * @return std::size_t
+         */
+        std::size_t instructionsCount() const noexcept;
+
+        /**
+         * @brief Display the generated code in a human readable way
+         *
+         * @param os
+         */
+        void display(std::ostream& os) const;
+
+        friend class RegisterVM;
+
+    private:
+        /**
+         * @brief Registers allocation of the function being compiled
+         *
+         */
+        struct Frame
+        {
+            std::size_t page;
+            std::unordered_map<std::string, uint16_t> locals;
+            std::vector<std::string> constants;  ///< locals defined with let
+            uint16_t top = 0;                    ///< first free register
+            uint16_t reserved = 0;               ///< registers below are used by arguments and locals, they are never freed
+        };
+
+        const internal::Node& m_ast;
+        std::vector<internal::RegisterPage> m_pages;
+        std::vector<Value> m_constants;
+        std::vector<std::string> m_globals;
+        std::vector<std::string> m_defined_globals;
+        std::vector<std::string> m_constant_globals;  ///< globals defined with let
+        std::vector<Frame> m_frames;
+
+        /**
+         * @brief Compile a node
+         *
+         * @param x
+         * @param dst register receiving the value of the node, -1 if it isn't needed
+         */
+        void compile(const internal::Node& x, int dst);
+
+        /**
+         * @brief Compile a node and get an operand (register or constant) holding its value
+         * @details A temporary register is allocated if needed, it's up to the caller to free it
+         *
+         * @param x
+         * @return uint16_t
+         */
+        uint16_t operand(const internal::Node& x);
+
+        void compileSymbol(const internal::Node& x, int dst);
+        void compileIf(const internal::Node& x, int dst);
+        void compileWhile(const internal::Node& x, int dst);
+        void compileLetMut(internal::Keyword n, const internal::Node& x, int dst);
+        void compileSet(const internal::Node& x, int dst);
+        void compileFunction(const internal::Node& x, int dst);
+        void compileOperator(std::size_t op, const internal::Node& x, int dst);
+        void handleCalls(const internal::Node& x, int dst);
+
+        uint16_t allocate();
+        void release(uint16_t top) noexcept;
+        std::size_t emit(internal::RegisterInstruction op, uint16_t a = 0, uint16_t b = 0, uint16_t c = 0);
+        uint16_t addConstant(const Value& value);
+        uint16_t addGlobal(const std::string& name);
+        void loadNil(int dst);
+
+        [[noreturn]] void throwCompilerError(const std::string& message, const internal::Node& node);
+    };
+}
+
+#endif
@@ -53,6 +53,10 @@ inline std::optional<internal::Instruction> Compiler::isSpecific(const std::stri
         return internal::Instruction::POP_LIST;
     else if (name == "pop!")
         return internal::Instruction::POP_LIST_IN_PLACE;
+    else if (name == "dict:set!")
+        return internal::Instruction::DICT_SET_IN_PLACE;
+    else if (name == "dict:remove!")
+        return internal::Instruction::DICT_REMOVE_IN_PLACE;
 
     return {};
 }
@@ -0,0 +1,57 @@
+/**
+ * @file Constants.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Constants used by ArkScript
+ * @version 0.1
+ * @date 2020-10-27
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+
+#ifndef INCLUDE_ARK_CONSTANTS_HPP_IN
+#define INCLUDE_ARK_CONSTANTS_HPP_IN
+
+// clang-format off
+constexpr int ARK_VERSION_MAJOR = 3;
+constexpr int ARK_VERSION_MINOR = 1;
+constexpr int ARK_VERSION_PATCH = 1;
+// clang-format on
+constexpr int ARK_VERSION = (ARK_VERSION_MAJOR << 16) + (ARK_VERSION_MINOR << 8) + ARK_VERSION_PATCH;
+constexpr char ARK_VERSION_STR[3] = { ARK_VERSION_MAJOR + '0', ARK_VERSION_MINOR + '0', ARK_VERSION_PATCH + '0' };
+
+#define ARK_COMPILATION_OPTIONS "-fsanitize=address -fno-omit-frame-pointer"
+#define ARK_COMPILER "GNU"
+#define ARK_CACHE_DIRNAME "__arkscript__"
+#define ARK_NO_NAME_FILE "FILE"
+
+#if defined(_WIN32) || defined(_WIN64)
+#    define ARK_PLATFORM_NAME "Windows"
+#elif defined(__APPLE__) || defined(__MACH__)
+#    define ARK_PLATFORM_NAME "Mac OSX"
+#elif defined(__linux__)
+#    define ARK_PLATFORM_NAME "Linux"
+#elif defined(__FreeBSD__)
+#    define ARK_PLATFORM_NAME "FreeBSD"
+#elif defined(__unix) || defined(__unix__)
+#    define ARK_PLATFORM_NAME "Unix"
+#else
+#    define ARK_PLATFORM_NAME "Other"
+#endif
+
+#include <cinttypes>
+
+namespace Ark
+{
+    // Compiler options
+    constexpr uint16_t FeatureRemoveUnusedVars = 1 << 4;
+    // VM options
+    constexpr uint16_t FeatureJIT = 1 << 5;                  ///< compile hot code pages to native code, needs ARK_JIT
+    constexpr uint16_t FeatureSharedCaptures = 1 << 6;       ///< closures share the variables they capture with the frame defining them, instead of copying them
+    constexpr uint16_t FeatureDeferredDestruction = 1 << 7;  ///< destroy the large dead lists, dicts and sets on a background thread
+
+    // Default features for the VM x Compiler x Parser
+    constexpr uint16_t DefaultFeatures = FeatureRemoveUnusedVars | FeatureJIT;
+}
+
+#endif
@@ -67,6 +67,26 @@ namespace Ark
         }
     };
 
+    /**
+     * @brief Triggered by a VM when the memory used by its objects went over its limit
+     * 
+     */
+    class MemoryLimitError : public std::exception
+    {
+    public:
+        explicit MemoryLimitError(std::size_t limit) :
+            m_msg("MemoryLimitError: the objects of the VM use more than " + std::to_string(limit) + " bytes")
+        {}
+
+        virtual const char* what() const throw()
+        {
+            return m_msg.c_str();
+        }
+
+    protected:
+        std::string m_msg;
+    };
+
     /**
      * @brief An assertion error, only triggered from ArkScript code through (assert expr error-message)
      * 
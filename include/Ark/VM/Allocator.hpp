@@ -0,0 +1,335 @@
+/**
+ * @file Allocator.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Allocators used by a virtual machine for the objects it creates
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_ALLOCATOR_HPP
+#define ARK_VM_ALLOCATOR_HPP
+
+#include <atomic>
+#include <array>
+#include <cinttypes>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    namespace internal
+    {
+        class MemoryMeter;
+    }
+
+    /**
+     * @brief Memory given to the objects created by a VM: scopes, list buffers, dict and set tables, arrays
+     * @details Set with VM::setAllocator, it's used by the VM while it runs, and the objects are given back to the
+     *          allocator which created them, whichever VM or thread destroys them. Thus deallocate must be thread
+     *          safe when the values are shared with other threads (list:pmap, FeatureDeferredDestruction).
+     *          The elements of the lists and the characters of the strings still use the global allocator,
+     *          since they are exposed as standard containers to the builtins and plugins.
+     *
+     */
+    class ARK_API Allocator
+    {
+    public:
+        Allocator() noexcept;
+        virtual ~Allocator() = default;
+
+        /**
+         * @brief Allocate a block of memory
+         * @details Throws std::bad_alloc if the allocator is out of memory
+         *
+         * @param size in bytes
+         * @param alignment a power of two
+         * @return void*
+         */
+        void* allocate(std::size_t size, std::size_t alignment);
+
+        /**
+         * @brief Give back a block of memory
+         *
+         * @param ptr a block returned by allocate
+         * @param size the size given to allocate
+         * @param alignment the alignment given to allocate
+         */
+        void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept;
+
+        /**
+         * @brief Count memory taken from the global allocator as if it was allocated here
+         * @details Used for the memory of the standard containers held by the objects of the allocator (the elements
+         *          of the lists, the tables of the dicts and sets) and for the sizes reported by the UserTypes
+         *
+         * @param size in bytes
+         */
+        void charge(std::size_t size) noexcept;
+
+        /**
+         * @brief Stop counting memory given to charge
+         *
+         * @param size in bytes
+         */
+        void release(std::size_t size) noexcept;
+
+        /**
+         * @brief Number of bytes allocated and not given back yet
+         *
+         * @return std::size_t
+         */
+        std::size_t bytesInUse() const noexcept;
+
+        /**
+         * @brief Number of bytes allocated since the allocator was created
+         *
+         * @return std::size_t
+         */
+        std::size_t bytesAllocated() const noexcept;
+
+        /**
+         * @brief Get the allocator of the VM running on this thread
+         *
+         * @return Allocator* nullptr for the global allocator
+         */
+        static Allocator* current() noexcept;
+
+        /**
+         * @brief Destroy the allocator once nothing uses it anymore, to be called once on an allocator created with new
+         * @details The allocator is deleted when the last block is given back and the last meter charging it is gone,
+         *          thus its owner can let go of it while the values it created are still used
+         *
+         */
+        void destroyWhenUnused() noexcept;
+
+    protected:
+        virtual void* doAllocate(std::size_t size, std::size_t alignment) = 0;
+        virtual void doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept = 0;
+
+    private:
+        friend class internal::MemoryMeter;
+
+        void hold() noexcept;
+        void drop() noexcept;
+
+        std::atomic<std::size_t> m_in_use;
+        std::atomic<std::size_t> m_allocated;
+        std::atomic<std::size_t> m_users;  ///< blocks, meters, and 1 until destroyWhenUnused, the allocator is deleted at 0
+    };
+
+    /**
+     * @brief Allocator calling a malloc and free pair, std::malloc and std::free by default
+     * @details The blocks must be aligned on alignof(std::max_align_t)
+     *
+     */
+    class ARK_API MallocAllocator : public Allocator
+    {
+    public:
+        using Malloc_t = void* (*)(std::size_t);
+        using Free_t = void (*)(void*);
+
+        MallocAllocator(Malloc_t malloc = &std::malloc, Free_t free = &std::free) noexcept;
+
+    protected:
+        void* doAllocate(std::size_t size, std::size_t alignment) override;
+        void doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept override;
+
+    private:
+        Malloc_t m_malloc;
+        Free_t m_free;
+    };
+
+    /**
+     * @brief Allocator keeping the blocks of up to 256 bytes in free lists, one per size class (multiples of 16)
+     * @details The small blocks are cut in chunks of 64KB, which are only freed with the allocator, and the larger
+     *          ones come from the global allocator. Thread safe.
+     *
+     */
+    class ARK_API PoolAllocator : public Allocator
+    {
+    public:
+        static constexpr std::size_t Granularity = 16;
+        static constexpr std::size_t MaxBlockSize = 256;
+        static constexpr std::size_t ChunkSize = 64 * 1024;
+
+        PoolAllocator() noexcept;
+        ~PoolAllocator() override;
+
+    protected:
+        void* doAllocate(std::size_t size, std::size_t alignment) override;
+        void doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept override;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        std::mutex m_mutex;
+        std::array<FreeBlock*, MaxBlockSize / Granularity> m_free_lists;
+        std::vector<void*> m_chunks;
+    };
+
+    /**
+     * @brief Allocator giving consecutive parts of large chunks, which are all freed at once
+     * @details Deallocating does nothing, the memory is given back by reset or when the allocator is destroyed,
+     *          thus the objects created with it must be gone by then. Allocating isn't thread safe.
+     *
+     */
+    class ARK_API ArenaAllocator : public Allocator
+    {
+    public:
+        static constexpr std::size_t DefaultChunkSize = 64 * 1024;
+
+        ArenaAllocator(std::size_t chunk_size = DefaultChunkSize) noexcept;
+        ~ArenaAllocator() override;
+
+        /**
+         * @brief Free the memory of all the objects allocated, keeping the first chunk to start again
+         *
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Number of bytes taken from the global allocator
+         *
+         * @return std::size_t
+         */
+        std::size_t bytesReserved() const noexcept;
+
+    protected:
+        void* doAllocate(std::size_t size, std::size_t alignment) override;
+        void doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept override;
+
+    private:
+        std::size_t m_chunk_size;
+        std::vector<std::pair<void*, std::size_t>> m_chunks;  ///< memory and size of the chunks
+        char* m_next;
+        char* m_end;
+    };
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief Make an allocator the current one on this thread, until the guard is destroyed
+     *
+     */
+    class ARK_API AllocatorGuard
+    {
+    public:
+        AllocatorGuard(Allocator* allocator) noexcept;
+        ~AllocatorGuard();
+
+        AllocatorGuard(const AllocatorGuard&) = delete;
+        AllocatorGuard& operator=(const AllocatorGuard&) = delete;
+
+    private:
+        Allocator* m_previous;
+    };
+
+    /**
+     * @brief Memory of a standard container, charged to the current allocator when the meter was created
+     * @details A copy charges the current allocator too, starting from 0 bytes. The allocator is kept alive by the meter
+     *
+     */
+    class ARK_API MemoryMeter
+    {
+    public:
+        MemoryMeter() noexcept;
+        MemoryMeter(const MemoryMeter&) noexcept;
+        ~MemoryMeter();
+
+        MemoryMeter& operator=(const MemoryMeter&) = delete;
+
+        /**
+         * @brief Charge or release the difference with the size given last time
+         *
+         * @param bytes
+         */
+        inline void update(std::size_t bytes) noexcept;
+
+    private:
+        Allocator* m_allocator;
+        std::size_t m_charged;
+    };
+
+    /**
+     * @brief Standard allocator going through an Ark::Allocator, or the global allocator when it's nullptr
+     *
+     * @tparam T
+     */
+    template <typename T>
+    class AllocatorAdaptor
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        AllocatorAdaptor(Allocator* allocator = nullptr) noexcept :
+            m_allocator(allocator)
+        {}
+
+        template <typename U>
+        AllocatorAdaptor(const AllocatorAdaptor<U>& other) noexcept :
+            m_allocator(other.allocator())
+        {}
+
+        inline T* allocate(std::size_t n);
+        inline void deallocate(T* ptr, std::size_t n) noexcept;
+
+        Allocator* allocator() const noexcept { return m_allocator; }
+
+    private:
+        Allocator* m_allocator;
+    };
+
+    /**
+     * @brief Deleter of a std::unique_ptr to an allocator which can be used by the values after its owner
+     *
+     */
+    struct DestroyWhenUnused
+    {
+        void operator()(Allocator* allocator) const noexcept
+        {
+            allocator->destroyWhenUnused();
+        }
+    };
+
+    template <typename T, typename U>
+    inline bool operator==(const AllocatorAdaptor<T>& A, const AllocatorAdaptor<U>& B) noexcept
+    {
+        return A.allocator() == B.allocator();
+    }
+
+    template <typename T, typename U>
+    inline bool operator!=(const AllocatorAdaptor<T>& A, const AllocatorAdaptor<U>& B) noexcept
+    {
+        return !(A == B);
+    }
+
+    /**
+     * @brief Create an object shared through a std::shared_ptr with the current allocator
+     *
+     * @tparam T
+     * @tparam Args
+     * @param args arguments given to the constructor of T
+     * @return std::shared_ptr<T>
+     */
+    template <typename T, typename... Args>
+    inline std::shared_ptr<T> makeShared(Args&&... args);
+
+#include "inline/Allocator.inl"
+}
+
+#endif
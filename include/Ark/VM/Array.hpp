@@ -0,0 +1,77 @@
+/**
+ * @file Array.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Subtype of the value type, handling packed arrays of numbers
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_ARRAY_HPP
+#define ARK_VM_ARRAY_HPP
+
+#include <memory>
+#include <vector>
+
+#include <Ark/Platform.hpp>
+
+namespace Ark::internal
+{
+    /**
+     * @brief Contiguous buffer of doubles, used by the array:* builtins
+     * @details A list of numbers stores a 32 bytes Value per element, an array only 8 bytes, which can be
+     *          processed with vector instructions. Like lists, the buffer is shared between the copies of
+     *          an array and copied when one of them is modified.
+     *
+     */
+    class ARK_API Array
+    {
+    public:
+        /**
+         * @brief Construct an empty array
+         *
+         */
+        Array() noexcept;
+
+        /**
+         * @brief Construct an array from the given numbers
+         *
+         * @param data
+         */
+        explicit Array(std::vector<double>&& data) noexcept;
+
+        /**
+         * @brief Number of elements in the array
+         *
+         * @return std::size_t
+         */
+        inline std::size_t size() const noexcept;
+
+        /**
+         * @brief Read only access to the elements
+         *
+         * @return const std::vector<double>&
+         */
+        inline const std::vector<double>& get() const noexcept;
+
+        /**
+         * @brief Get the elements to modify them, copying them first if the buffer is shared with another array
+         *
+         * @return std::vector<double>&
+         */
+        inline std::vector<double>& mut();
+
+        friend ARK_API bool operator==(const Array& A, const Array& B) noexcept;
+        friend ARK_API bool operator<(const Array& A, const Array& B) noexcept;
+        friend class HeapWalker;
+
+    private:
+        std::shared_ptr<std::vector<double>> m_data;
+    };
+}
+
+#include "inline/Array.inl"
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file Coroutine.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Coroutines run by a single virtual machine, switching between them when they are suspended
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_COROUTINE_HPP
+#define ARK_VM_COROUTINE_HPP
+
+#include <chrono>
+#include <cinttypes>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Scope.hpp>
+
+namespace Ark::internal
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief A control flow of an ArkScript program, with its own stack segment and scope chain
+     * @details The one running uses the stack and the registers of the VM, the other ones keep the part of the stack
+     *          they were using and their registers here until they are resumed.
+     *
+     */
+    struct Coroutine
+    {
+        enum class Status
+        {
+            Created,   ///< the function wasn't called yet
+            Ready,     ///< waiting for its turn
+            Running,
+            Sleeping,  ///< waiting for its wake up time
+            Waiting,   ///< waiting for another coroutine to finish
+            Reading,   ///< waiting for a file descriptor to be readable
+            Done
+        };
+
+        Status status = Status::Created;
+
+        Value function;                     ///< only used by a Created coroutine
+        std::vector<Value> arguments;       ///< only used by a Created coroutine
+        Value result;                       ///< value returned by the function once Done
+        std::optional<Value> resume_value;  ///< replaces the nil returned by the builtin which suspended the coroutine
+        std::vector<uint32_t> waiting;      ///< coroutines waiting for this one to finish
+
+        // saved registers
+        std::vector<Value> stack;
+        std::vector<Scope_t> locals;
+        std::vector<uint8_t> scope_count_to_delete;
+        std::optional<Scope_t> saved_scope;
+        int ip = 0;
+        std::size_t pp = 0;
+        uint16_t fc = 1;
+        std::size_t until_frame_count = 1;
+    };
+
+    /**
+     * @brief Coroutines of a VM, and the order in which they run
+     * @details The coroutine 0 is the main control flow of the VM. The scheduler is created by the first call to
+     *          `async`, thus it doesn't cost anything to the programs which don't use coroutines.
+     *
+     */
+    struct Scheduler
+    {
+        using WakeUp = std::pair<Clock::time_point, uint32_t>;
+
+        struct PendingRead
+        {
+            uint32_t coroutine;
+            int fd;
+            std::function<Value()> read;
+        };
+
+        std::unordered_map<uint32_t, Coroutine> coroutines;
+        Scope_t globals;  ///< scope of the global variables, used by all the coroutines
+        std::deque<uint32_t> ready;
+        std::priority_queue<WakeUp, std::vector<WakeUp>, std::greater<WakeUp>> sleeping;
+        std::vector<PendingRead> reading;
+        uint32_t current = 0;
+        uint32_t next_id = 1;
+        bool switch_requested = false;  ///< the current coroutine was suspended by a builtin
+    };
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file CycleCollector.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Collector of the scopes kept alive by reference cycles through closures
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_CYCLECOLLECTOR_HPP
+#define ARK_VM_CYCLECOLLECTOR_HPP
+
+#include <chrono>
+#include <cinttypes>
+#include <memory>
+#include <vector>
+
+#include <Ark/VM/Scope.hpp>
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    constexpr std::size_t ArkCycleCollectorThreshold = 1024;  ///< minimum number of closure scopes tracked before a collection
+
+    /**
+     * @brief Statistics of the cycle collector of a VM
+     *
+     */
+    struct CycleCollectorStats
+    {
+        std::size_t collections = 0;
+        std::size_t scopes_collected = 0;
+        std::chrono::nanoseconds last_pause { 0 };
+        std::chrono::nanoseconds max_pause { 0 };
+        std::chrono::nanoseconds total_pause { 0 };
+    };
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief Frees the scopes of closures which are only referenced by each other
+     * @details A closure stored in the scope it captured (directly, or through lists, dictionaries, sets and other
+     *          closures) keeps it alive forever. The scopes captured by closures are tracked, and a collection
+     *          does a trial deletion over the graph they reach: the references found inside the graph are
+     *          subtracted from the reference counts, the nodes which still have references come from the outside
+     *          (variables, stack, other threads) and are kept alive with everything they reach, and the others
+     *          are garbage. Their scopes are emptied, which breaks the cycles and frees them.
+     *
+     *          A collection runs when the number of tracked scopes reaches twice the number of scopes alive after
+     *          the previous one, so that its cost is amortized over the closures created.
+     *
+     */
+    class CycleCollector
+    {
+    public:
+        CycleCollector() noexcept;
+
+        /**
+         * @brief Track the scope of a new closure
+         *
+         * @param scope
+         */
+        inline void track(const Scope_t& scope);
+
+        /**
+         * @brief Check if enough closures were created since the last collection to run a new one
+         *
+         * @return bool
+         */
+        inline bool shouldCollect() const noexcept;
+
+        /**
+         * @brief Free the scopes only referenced by cycles
+         * @details Must be called between two instructions, when the C++ code doesn't hold raw pointers on values
+         *
+         * @return std::size_t number of scopes freed
+         */
+        std::size_t collect();
+
+        /**
+         * @brief Forget the tracked scopes which were freed
+         *
+         */
+        void purge();
+
+        /**
+         * @brief Forget the tracked scopes, without freeing them
+         *
+         */
+        void clear() noexcept;
+
+        inline const CycleCollectorStats& stats() const noexcept;
+
+    private:
+        std::vector<std::weak_ptr<Scope>> m_tracked;
+        std::size_t m_threshold;
+        CycleCollectorStats m_stats;
+    };
+
+#include "inline/CycleCollector.inl"
+}
+
+#endif
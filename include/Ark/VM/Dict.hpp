@@ -0,0 +1,119 @@
+/**
+ * @file Dict.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Subtype of the value type, handling hash maps
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_DICT_HPP
+#define ARK_VM_DICT_HPP
+
+#include <memory>
+#include <vector>
+#include <cinttypes>
+
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    class Value;
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief Hash map with Number and String keys
+     * @details The entries are stored in insertion order in a vector, and found through an open addressing
+     *          index (linear probing). Like lists, the table is shared between the copies of a dictionary
+     *          and copied when one of them is modified.
+     *
+     */
+    class ARK_API Dict
+    {
+    public:
+        struct Entry;
+
+        /**
+         * @brief Construct an empty dictionary
+         *
+         */
+        Dict() noexcept;
+
+        /**
+         * @brief Number of keys in the dictionary
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const noexcept;
+
+        /**
+         * @brief The entries of the dictionary, in insertion order (the last entry takes the place of a removed one)
+         *
+         * @return const std::vector<Entry>&
+         */
+        const std::vector<Entry>& entries() const noexcept;
+
+        /**
+         * @brief Memory used by the table of the dictionary, in bytes
+         *
+         * @return std::size_t
+         */
+        std::size_t bytes() const noexcept;
+
+        /**
+         * @brief Find the value associated to a key
+         *
+         * @param key
+         * @return const Value* nullptr if the key isn't in the dictionary
+         */
+        const Value* get(const Value& key) const;
+
+        /**
+         * @brief Associate a value to a key, replacing the previous one
+         *
+         * @param key must be a Number or a String, otherwise a TypeError is thrown
+         * @param value
+         */
+        void set(const Value& key, const Value& value);
+
+        /**
+         * @brief Remove a key from the dictionary
+         *
+         * @param key
+         * @return true if the key was in the dictionary
+         */
+        bool remove(const Value& key);
+
+        /**
+         * @brief Check if a value can be used as a key
+         *
+         * @param key
+         * @return true if it's a Number other than NaN or a String
+         */
+        static bool isHashable(const Value& key) noexcept;
+
+        friend ARK_API bool operator==(const Dict& A, const Dict& B) noexcept;
+        friend ARK_API bool operator<(const Dict& A, const Dict& B) noexcept;
+        friend class CycleCollector;
+        friend class Reclaimer;
+        friend class HeapWalker;
+
+    private:
+        struct Table;
+
+        std::shared_ptr<Table> m_table;
+
+        /**
+         * @brief Get the table to modify it, copying it first if it's shared with another dictionary
+         *
+         * @return Table&
+         */
+        Table& mut();
+    };
+}
+
+#endif
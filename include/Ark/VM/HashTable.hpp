@@ -0,0 +1,202 @@
+/**
+ * @file HashTable.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Open addressing hash table used by the Dict and Set value types
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_HASHTABLE_HPP
+#define ARK_VM_HASHTABLE_HPP
+
+#include <vector>
+#include <cinttypes>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Allocator.hpp>
+
+namespace Ark::internal
+{
+    /**
+     * @brief Entries stored contiguously in insertion order, found through an index using linear probing
+     * @details An entry must have a `Value key` and a `std::size_t hash` field
+     *
+     * @tparam Entry
+     */
+    template <typename Entry>
+    struct HashTable
+    {
+        static constexpr int32_t EmptySlot = -1;
+        static constexpr int32_t RemovedSlot = -2;
+        static constexpr std::size_t MinCapacity = 8;
+
+        std::vector<Entry> entries;
+        std::vector<int32_t> index;  ///< position of the entries, EmptySlot or RemovedSlot
+        std::size_t removed = 0;     ///< number of RemovedSlot in the index
+        MemoryMeter meter;           ///< memory of the entries and the index
+
+        HashTable() = default;
+
+        HashTable(const HashTable& other) :
+            entries(other.entries), index(other.index), removed(other.removed)
+        {
+            measure();
+        }
+
+        /**
+         * @brief Update the memory counted by the meter, after the entries or the index grew
+         *
+         */
+        void measure() noexcept
+        {
+            meter.update(bytes());
+        }
+
+        /**
+         * @brief Get the memory of the entries and the index
+         *
+         * @return std::size_t
+         */
+        std::size_t bytes() const noexcept
+        {
+            return entries.capacity() * sizeof(Entry) + index.capacity() * sizeof(int32_t);
+        }
+
+        /**
+         * @brief Compute the hash of a key, with its bits mixed so that linear probing works on the low bits
+         *
+         * @param key
+         * @return std::size_t
+         */
+        static std::size_t hashOf(const Value& key) noexcept
+        {
+            uint64_t x = static_cast<uint64_t>(key.hash()) + 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return static_cast<std::size_t>(x ^ (x >> 31));
+        }
+
+        /**
+         * @brief Find the position of a key in the entries
+         *
+         * @param key
+         * @param hash
+         * @return int32_t a negative number if it isn't in the table
+         */
+        int32_t position(const Value& key, std::size_t hash) const noexcept
+        {
+            if (entries.empty())
+                return EmptySlot;
+            return index[find(key, hash)];
+        }
+
+        /**
+         * @brief Find the slot of the index where a key is, or the slot where it should be inserted
+         *
+         * @param key
+         * @param hash
+         * @return std::size_t
+         */
+        std::size_t find(const Value& key, std::size_t hash) const noexcept
+        {
+            const std::size_t mask = index.size() - 1;
+            std::size_t insert_at = index.size();
+
+            for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask)
+            {
+                const int32_t i = index[slot];
+                if (i == EmptySlot)
+                    return (insert_at != index.size()) ? insert_at : slot;
+                else if (i == RemovedSlot)
+                {
+                    if (insert_at == index.size())
+                        insert_at = slot;
+                }
+                else if (entries[i].hash == hash && entries[i].key == key)
+                    return slot;
+            }
+        }
+
+        /**
+         * @brief Find the slot where to insert a key, growing the index if needed
+         *
+         * @param key
+         * @param hash
+         * @return std::size_t
+         */
+        std::size_t prepare(const Value& key, std::size_t hash)
+        {
+            if ((entries.size() + removed + 1) * 4 >= index.size() * 3)
+                rehash();
+            return find(key, hash);
+        }
+
+        /**
+         * @brief Add an entry in a slot given by prepare, which must not be used by another entry
+         *
+         * @param slot
+         * @param entry
+         */
+        void insert(std::size_t slot, Entry&& entry)
+        {
+            if (index[slot] == RemovedSlot)
+                --removed;
+            index[slot] = static_cast<int32_t>(entries.size());
+            entries.push_back(std::move(entry));
+            measure();
+        }
+
+        /**
+         * @brief Remove the entry from a used slot
+         * @details The last entry takes the place of the removed one, to keep them contiguous
+         *
+         * @param slot
+         */
+        void erase(std::size_t slot)
+        {
+            const std::size_t i = static_cast<std::size_t>(index[slot]);
+            index[slot] = RemovedSlot;
+            ++removed;
+
+            if (const std::size_t last = entries.size() - 1; i != last)
+            {
+                const std::size_t mask = index.size() - 1;
+                std::size_t last_slot = entries[last].hash & mask;
+                while (index[last_slot] != static_cast<int32_t>(last))
+                    last_slot = (last_slot + 1) & mask;
+
+                index[last_slot] = static_cast<int32_t>(i);
+                entries[i] = std::move(entries[last]);
+            }
+            entries.pop_back();
+        }
+
+        /**
+         * @brief Create a new index, big enough to hold the entries and a new one
+         *
+         */
+        void rehash()
+        {
+            std::size_t capacity = MinCapacity;
+            while (capacity * 3 <= (entries.size() + 1) * 4)
+                capacity *= 2;
+
+            index.assign(capacity, EmptySlot);
+            removed = 0;
+
+            const std::size_t mask = capacity - 1;
+            for (std::size_t i = 0, end = entries.size(); i < end; ++i)
+            {
+                std::size_t slot = entries[i].hash & mask;
+                while (index[slot] != EmptySlot)
+                    slot = (slot + 1) & mask;
+                index[slot] = static_cast<int32_t>(i);
+            }
+        }
+    };
+}
+
+#endif
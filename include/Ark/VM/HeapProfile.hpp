@@ -0,0 +1,123 @@
+/**
+ * @file HeapProfile.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Census of the objects alive in a virtual machine
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_HEAPPROFILE_HPP
+#define ARK_VM_HEAPPROFILE_HPP
+
+#include <array>
+#include <cinttypes>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Scope.hpp>
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    /**
+     * @brief Number and sizes of a group of objects
+     * @details The shallow size is the memory of the objects themselves, the retained size adds the memory of
+     *          everything they are the only ones to hold, which would be freed with them
+     *
+     */
+    struct HeapStats
+    {
+        std::size_t count = 0;
+        std::size_t shallow = 0;
+        std::size_t retained = 0;
+    };
+
+    /**
+     * @brief Objects reachable from the stack, the scopes, the coroutines and the constants of a VM
+     * @details A shared object is counted once. The values stored in place (numbers, booleans, nil, functions) are
+     *          counted without a size, their memory being the one of the list or scope holding them
+     *
+     */
+    struct ARK_API HeapProfile
+    {
+        std::array<HeapStats, types_to_str.size()> by_type;  ///< indexed by ValueType
+        HeapStats frames;                                    ///< scopes of the functions running
+        std::map<internal::PageAddr_t, HeapStats> closures;  ///< scopes of the closures, by code page of their function
+        std::map<std::string, std::size_t> globals;          ///< retained size of each global variable, 0 if its object is shared
+
+        /**
+         * @brief Get the total of the objects, all retained by the VM
+         *
+         * @return HeapStats
+         */
+        HeapStats total() const noexcept;
+
+        /**
+         * @brief Write the profile as lines of space separated columns, in the same order from one run to another
+         *
+         * @param os
+         */
+        void write(std::ostream& os) const;
+    };
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief Visits the objects reachable from some values, adding them to a profile
+     *
+     */
+    class HeapWalker
+    {
+    public:
+        explicit HeapWalker(HeapProfile& profile) noexcept;
+
+        /**
+         * @brief Add a value and what it holds to the profile, unless it was already visited
+         *
+         * @param value
+         * @return std::size_t its retained size, 0 if it was already visited
+         */
+        std::size_t walk(const Value& value);
+
+        /**
+         * @brief Add the scope of a running function and its variables to the profile, unless it was already visited
+         *
+         * @param scope
+         * @param on_variable called with the symbol id and the retained size of each variable
+         * @return std::size_t its retained size, 0 if it was already visited
+         */
+        std::size_t walkFrame(const Scope_t& scope, const std::function<void(uint16_t, std::size_t)>& on_variable = nullptr);
+
+    private:
+        HeapProfile& m_profile;
+        std::unordered_set<const void*> m_visited;
+
+        /**
+         * @brief Check if a value holds the only reference to its object, which is retained by the holder of the value
+         *
+         * @param value
+         * @return bool
+         */
+        static bool isExclusive(const Value& value) noexcept;
+
+        /**
+         * @brief Add a scope and its variables to some stats
+         *
+         * @param scope
+         * @param stats
+         * @param on_variable called with the symbol id and the retained size of each variable, if given
+         * @return std::size_t its retained size, 0 if it was already visited
+         */
+        std::size_t walkScope(const Scope_t& scope, HeapStats& stats, const std::function<void(uint16_t, std::size_t)>& on_variable);
+    };
+}
+
+#endif
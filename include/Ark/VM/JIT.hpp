@@ -0,0 +1,110 @@
+/**
+ * @file JIT.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Baseline x86-64 compiler for hot code pages
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_JIT_HPP
+#define ARK_VM_JIT_HPP
+
+#include <vector>
+#include <cinttypes>
+#include <cstddef>
+
+#include <Ark/VM/Native.hpp>
+#include <Ark/Compiler/BytecodeReader.hpp>
+
+namespace Ark::internal
+{
+    /// Number of calls after which a code page is compiled to native code
+    constexpr unsigned ArkJITCallThreshold = 64;
+
+    /**
+     * @brief Baseline compiler, turning hot code pages into x86-64 code
+     * @details Numbers arithmetic, comparisons and jumps are compiled inline, loading symbols, constants
+     *          and builtins calls back into the VM, and every other instruction is handed back to the
+     *          interpreter. Only available when ArkScript is built with ARK_JIT on an x86-64 platform,
+     *          otherwise no page is ever compiled and the interpreter is used.
+     *
+     */
+    class JIT
+    {
+    public:
+        /**
+         * @brief Construct a new JIT object
+         *
+         * @param vm the virtual machine which will run the generated code
+         */
+        explicit JIT(VM* vm) noexcept;
+
+        /**
+         * @brief Destroy the JIT object, releasing the generated code
+         *
+         */
+        ~JIT();
+
+        JIT(const JIT&) = delete;
+        JIT& operator=(const JIT&) = delete;
+
+        /**
+         * @brief Check if the JIT can generate code on this platform
+         *
+         * @return true
+         * @return false
+         */
+        static bool available() noexcept;
+
+        /**
+         * @brief Count a call to a code page, compiling it when it becomes hot
+         *
+         * @param page the bytecode of the page
+         * @param page_id the page address
+         * @return NativePage_t the native code of the page, nullptr if it isn't hot yet
+         */
+        NativePage_t hit(const bytecode_t& page, std::size_t page_id);
+
+        /**
+         * @brief Compile a code page to native code
+         *
+         * @param page the bytecode of the page
+         * @return NativePage_t nullptr if the compilation is not supported
+         */
+        NativePage_t compile(const bytecode_t& page);
+
+        /**
+         * @brief Return the number of pages compiled so far
+         *
+         * @return std::size_t
+         */
+        inline std::size_t compiledPages() const noexcept { return m_blocks.size(); }
+
+    private:
+        struct Layout
+        {
+            int32_t value_size;   ///< sizeof(Value)
+            int32_t type;         ///< offset of the type tag in a Value
+            int32_t number;       ///< offset of the double in a Value holding a Number
+            int32_t reference;    ///< offset of the pointer in a Value holding a Reference
+            int32_t vm_sp;        ///< offset of the stack pointer in the VM
+            int32_t vm_ip;        ///< offset of the instruction pointer in the VM
+            int32_t vm_countdown; ///< offset of the budget countdown in the VM
+        };
+
+        struct CodeBlock
+        {
+            void* memory;
+            std::size_t size;
+        };
+
+        Layout m_layout;
+        std::vector<unsigned> m_calls;
+        std::vector<CodeBlock> m_blocks;
+    };
+}
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file Native.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Entry points used by code pages compiled to native code
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_NATIVE_HPP
+#define ARK_VM_NATIVE_HPP
+
+#include <cinttypes>
+#include <cstddef>
+
+#include <Ark/VM/Value.hpp>
+
+namespace Ark
+{
+    class VM;
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief A code page compiled to native code
+     * @details The function starts executing the page at the given instruction pointer and
+     *          returns as soon as it meets an instruction it can not handle by itself. The
+     *          VM instruction pointer is then left on this instruction, so that the interpreter
+     *          can execute it.
+     *
+     * @param vm the virtual machine running the page
+     * @param stack a pointer to the first value of the VM stack
+     * @param ip the instruction pointer to start from
+     */
+    using NativePage_t = void (*)(VM* vm, Value* stack, int ip);
+
+    /**
+     * @brief Code pages translated ahead of time (ark --emit-cpp) and built as a shared library
+     * @details The shared library exports a `getNativePages` function returning a pointer to this structure.
+     *
+     */
+    struct NativeModule
+    {
+        const char* hash;           ///< hexadecimal sha256 of the bytecode the pages were translated from
+        std::size_t count;          ///< number of code pages
+        const NativePage_t* pages;  ///< one function per code page
+    };
+
+    /**
+     * @brief Operations given to the native code, to work on the VM internals
+     * @details Every operation returning a boolean returns false when it can not do its job,
+     *          without modifying the VM, so that the instruction can be handed back to the
+     *          interpreter which will do the error handling.
+     *
+     */
+    struct NativeOps
+    {
+        /**
+         * @brief Push a reference to a variable on the stack (LOAD_SYMBOL)
+         *
+         * @param vm
+         * @param id the symbol id
+         * @return true on success
+         * @return false if the variable is unbound
+         */
+        static inline bool loadSymbol(VM* vm, uint16_t id);
+
+        /**
+         * @brief Push a constant on the stack (LOAD_CONST)
+         *
+         * @param vm
+         * @param id the constant id
+         * @return true on success
+         * @return false if the closure couldn't be created
+         */
+        static inline bool loadConst(VM* vm, uint16_t id);
+
+        /**
+         * @brief Pop a value and store it in an existing variable (STORE)
+         *
+         * @param vm
+         * @param id the symbol id
+         * @return true on success
+         * @return false if the variable is unbound or constant, or if its value should go to the reclaimer
+         */
+        static inline bool store(VM* vm, uint16_t id);
+
+        /**
+         * @brief Push a builtin on the stack (BUILTIN)
+         *
+         * @param vm
+         * @param id the builtin id
+         */
+        static inline void builtin(VM* vm, uint16_t id);
+
+        /**
+         * @brief Replace a stack value by a Number
+         *
+         * @param slot the stack slot to write
+         * @param number
+         */
+        static inline void setNumber(Value* slot, double number);
+
+        /**
+         * @brief Replace a stack value by true or false
+         *
+         * @param slot the stack slot to write
+         * @param value
+         */
+        static inline void setBool(Value* slot, bool value);
+
+        /**
+         * @brief Read the two numbers on top of the stack, without popping them
+         *
+         * @param vm
+         * @param a the second value on the stack
+         * @param b the value on top of the stack
+         * @return true on success
+         * @return false if the values aren't numbers
+         */
+        static inline bool numbers(VM* vm, double& a, double& b);
+
+        /**
+         * @brief Replace the two values on top of the stack by a Number
+         *
+         * @param vm
+         * @param number
+         */
+        static inline void reduceNumber(VM* vm, double number);
+
+        /**
+         * @brief Replace the two values on top of the stack by true or false
+         *
+         * @param vm
+         * @param value
+         */
+        static inline void reduceBool(VM* vm, bool value);
+
+        /**
+         * @brief Remove values from the top of the stack
+         *
+         * @param vm
+         * @param count
+         */
+        static inline void drop(VM* vm, uint16_t count);
+
+        /**
+         * @brief Pop a value and check its type (POP_JUMP_IF_TRUE, POP_JUMP_IF_FALSE)
+         *
+         * @param vm
+         * @param type ValueType::True or ValueType::False
+         * @return true if the value had the given type
+         */
+        static inline bool popIs(VM* vm, ValueType type);
+
+        /**
+         * @brief Count the instructions of a loop iteration, on a backward jump
+         *
+         * @param vm
+         * @param instructions from the target of the jump to the jump
+         * @return true if the loop can go on
+         * @return false if the interpreter must check the budget
+         */
+        static inline bool spend(VM* vm, int32_t instructions);
+
+        /**
+         * @brief Hand the execution back to the interpreter
+         *
+         * @param vm
+         * @param ip the instruction to resume from
+         */
+        static inline void leave(VM* vm, int ip);
+    };
+}
+
+#endif
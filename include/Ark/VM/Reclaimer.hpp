@@ -0,0 +1,104 @@
+/**
+ * @file Reclaimer.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Destruction of the large dead values on a background thread
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_RECLAIMER_HPP
+#define ARK_VM_RECLAIMER_HPP
+
+#include <condition_variable>
+#include <cinttypes>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Scope.hpp>
+
+namespace Ark
+{
+    constexpr std::size_t ArkReclaimerThreshold = 4096;  ///< number of elements from which a dead list, dict or set is destroyed in the background
+}
+
+namespace Ark::internal
+{
+    struct NativeOps;
+
+    /**
+     * @brief Destroys the large values given up by a VM on a background thread
+     * @details Destroying a list, a dict or a set takes a time proportional to its size, and the VM would pause
+     *          when a large one dies (a variable is overwritten, or a function returns). The values owning their
+     *          elements alone, of at least ArkReclaimerThreshold elements, are moved to a queue instead and
+     *          destroyed by a thread started with the first one. The values they hold can be shared with the VM,
+     *          as their reference counts are atomic.
+     *
+     */
+    class Reclaimer
+    {
+    public:
+        Reclaimer() noexcept;
+
+        /**
+         * @brief Destroy the Reclaimer object, after the values given to it
+         *
+         */
+        ~Reclaimer();
+
+        /**
+         * @brief Take a value about to be overwritten if it's large, to destroy it in the background
+         *
+         * @param value left nil if it was taken
+         * @return true if the value was taken
+         */
+        bool take(Value& value);
+
+        /**
+         * @brief Take the large variables of a scope about to be destroyed
+         * @details Nothing is taken if the scope is still used elsewhere or if closures share its variables
+         *
+         * @param scope
+         */
+        void takeFrom(const Scope_t& scope);
+
+        /**
+         * @brief Get the number of values taken
+         *
+         * @return std::size_t
+         */
+        inline std::size_t taken() const noexcept;
+
+    private:
+        friend struct NativeOps;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake_up;
+        std::vector<Value> m_queue;
+        std::thread m_thread;  ///< started with the first value taken
+        bool m_stop;
+        std::size_t m_taken;
+
+        /**
+         * @brief Check if destroying a value would take a long time
+         *
+         * @param value
+         * @return true if the value owns at least ArkReclaimerThreshold elements, directly or through a closure
+         */
+        static bool isLarge(const Value& value) noexcept;
+
+        /**
+         * @brief Destroy the values in the queue until the reclaimer is destroyed
+         *
+         */
+        void run();
+    };
+
+#include "inline/Reclaimer.inl"
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file RegisterVM.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief A second execution engine, running the register based bytecode
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_REGISTERVM_HPP
+#define ARK_VM_REGISTERVM_HPP
+
+#include <vector>
+#include <string>
+#include <cinttypes>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/Compiler/RegisterCompiler.hpp>
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    /**
+     * @brief Runs the code generated by the RegisterCompiler
+     * @details Each function call gets a window of registers, starting right after the register holding
+     *          the called function, so that the arguments don't need to be copied.
+     *
+     */
+    class ARK_API RegisterVM
+    {
+    public:
+        /**
+         * @brief Construct a new RegisterVM object
+         *
+         * @param compiler a compiler which has already compiled the code
+         */
+        explicit RegisterVM(const RegisterCompiler& compiler) noexcept;
+
+        /**
+         * @brief Run the bytecode
+         *
+         * @return int the exit code (default to 0 if no error)
+         */
+        int run() noexcept;
+
+        /**
+         * @brief Retrieve a global variable
+         *
+         * @param name the variable name
+         * @return Value& nil if it couldn't be found
+         */
+        Value& operator[](const std::string& name) noexcept;
+
+        /**
+         * @brief Number of instructions executed by the last run
+         *
+         * @return unsigned long long
+         */
+        unsigned long long executedInstructions() const noexcept;
+
+    private:
+        /**
+         * @brief Where to go back when returning from a function
+         *
+         */
+        struct Frame
+        {
+            std::size_t page;
+            std::size_t ip;
+            std::size_t base;
+        };
+
+        static constexpr std::size_t MaxFrames = 65536;
+
+        const RegisterCompiler& m_compiler;
+        std::vector<Value> m_registers;
+        std::vector<Value> m_globals;
+        std::vector<Frame> m_frames;
+        unsigned long long m_executed;
+        Value m_no_value;
+
+        void safeRun();
+
+        [[noreturn]] void throwVMError(const std::string& message);
+    };
+}
+
+#endif
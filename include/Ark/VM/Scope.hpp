@@ -14,12 +14,77 @@
 
 #include <vector>
 #include <utility>
+#include <memory>
 #include <cinttypes>
 
 #include <Ark/VM/Value.hpp>
+#include <Ark/VM/Allocator.hpp>
+
+namespace Ark
+{
+    class VMPool;
+}
 
 namespace Ark::internal
 {
+    class Scope;
+
+    /**
+     * @brief A variable captured by closures, shared by them and the frame defining it
+     * @details The upvalue is open while the frame exists, and its value is the variable of the frame. Once the
+     *          frame is destroyed, the value is moved into the upvalue, which is closed.
+     * 
+     */
+    class Upvalue
+    {
+    public:
+        /**
+         * @brief Construct an open upvalue
+         * 
+         * @param frame the scope holding the variable
+         * @param index the index of the variable in the scope
+         */
+        Upvalue(Scope* frame, std::size_t index) noexcept;
+
+        /**
+         * @brief Get the value of the captured variable
+         * 
+         * @return Value* 
+         */
+        inline Value* get() noexcept;
+
+        /**
+         * @brief Get the value of the captured variable
+         * 
+         * @return const Value* 
+         */
+        inline const Value* get() const noexcept;
+
+        /**
+         * @brief Check if the frame defining the variable still exists
+         * 
+         * @return true if the value is the one of the frame
+         * @return false if the value is held by the upvalue
+         */
+        inline bool isOpen() const noexcept;
+
+        /**
+         * @brief Move the value of the variable out of its frame
+         * 
+         */
+        void close() noexcept;
+
+        friend class Scope;
+        friend class Ark::VMPool;
+
+    private:
+        Scope* m_frame;  ///< nullptr once closed
+        std::size_t m_index;
+        Value m_closed;
+    };
+
+    using Upvalue_t = std::shared_ptr<Upvalue>;
+
     /**
      * @brief A class to handle the VM scope more efficiently
      * 
@@ -27,12 +92,35 @@ namespace Ark::internal
     class Scope
     {
     public:
+        using Variables_t = std::vector<std::pair<uint16_t, Value>, AllocatorAdaptor<std::pair<uint16_t, Value>>>;
+
         /**
-         * @brief Construct a new Scope object
+         * @brief Construct a new Scope object, using the current allocator
          * 
          */
         Scope() noexcept;
 
+        /**
+         * @brief Copy the variables of a scope, the upvalues opened on it stay with it
+         * 
+         * @param other 
+         */
+        Scope(const Scope& other);
+
+        /**
+         * @brief Replace the variables of the scope, closing the upvalues opened on it
+         * 
+         * @param other 
+         * @return Scope& 
+         */
+        Scope& operator=(const Scope& other);
+
+        /**
+         * @brief Destroy the Scope object, closing the upvalues opened on it
+         * 
+         */
+        ~Scope();
+
         /**
          * @brief Put a value in the scope
          * 
@@ -49,6 +137,22 @@ namespace Ark::internal
          */
         void push_back(uint16_t id, const Value& val) noexcept;
 
+        /**
+         * @brief Put a variable shared with another scope in the scope
+         * 
+         * @param id The symbol id of the variable
+         * @param upvalue The variable
+         */
+        void capture(uint16_t id, const Upvalue_t& upvalue);
+
+        /**
+         * @brief Get the upvalue of a variable of the scope, creating it the first time it's captured
+         * 
+         * @param id The symbol id of the variable
+         * @return Upvalue_t nullptr if the variable can not be found
+         */
+        Upvalue_t upvalue(uint16_t id);
+
         /**
          * @brief Check if the scope has a specific symbol in memory
          * 
@@ -81,11 +185,47 @@ namespace Ark::internal
          */
         const std::size_t size() const noexcept;
 
+        /**
+         * @brief Call a function on each variable of the scope, the captured ones included
+         * 
+         * @param function called with the symbol id and the value of each variable
+         */
+        template <typename F>
+        void forEach(F&& function) const
+        {
+            for (const auto& [id, value] : m_data)
+                function(id, value);
+            for (const auto& [id, upvalue] : m_upvalues)
+                function(id, *upvalue->get());
+        }
+
         friend class Ark::VM;
+        friend class Ark::VMPool;
+        friend class Upvalue;
+        friend class CycleCollector;
+        friend class Reclaimer;
+        friend class HeapWalker;
 
     private:
-        std::vector<std::pair<uint16_t, Value>> m_data;
+        Variables_t m_data;
+        std::vector<std::pair<uint16_t, Upvalue_t>> m_upvalues;  ///< variables captured from other scopes
+        std::vector<Upvalue_t> m_open;                           ///< upvalues of the variables of this scope
     };
+
+    inline Value* Upvalue::get() noexcept
+    {
+        return m_frame != nullptr ? &m_frame->m_data[m_index].second : &m_closed;
+    }
+
+    inline const Value* Upvalue::get() const noexcept
+    {
+        return m_frame != nullptr ? &m_frame->m_data[m_index].second : &m_closed;
+    }
+
+    inline bool Upvalue::isOpen() const noexcept
+    {
+        return m_frame != nullptr;
+    }
 }
 
 #endif
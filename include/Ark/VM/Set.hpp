@@ -0,0 +1,109 @@
+/**
+ * @file Set.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Subtype of the value type, handling hash sets
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_SET_HPP
+#define ARK_VM_SET_HPP
+
+#include <memory>
+#include <vector>
+
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    class Value;
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief Hash set of values, using Value::hash
+     * @details Uses the same table as Dict: the elements are stored in insertion order, and the table
+     *          is shared between the copies of a set until one of them is modified.
+     *
+     */
+    class ARK_API Set
+    {
+    public:
+        struct Entry;
+
+        /**
+         * @brief Construct an empty set
+         *
+         */
+        Set() noexcept;
+
+        /**
+         * @brief Number of elements in the set
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const noexcept;
+
+        /**
+         * @brief The elements of the set, in insertion order (the last element takes the place of a removed one)
+         *
+         * @return const std::vector<Entry>&
+         */
+        const std::vector<Entry>& entries() const noexcept;
+
+        /**
+         * @brief Memory used by the table of the set, in bytes
+         *
+         * @return std::size_t
+         */
+        std::size_t bytes() const noexcept;
+
+        /**
+         * @brief Check if a value is in the set
+         *
+         * @param value
+         * @return true if it's in the set
+         */
+        bool contains(const Value& value) const noexcept;
+
+        /**
+         * @brief Add a value to the set
+         *
+         * @param value
+         * @return true if it wasn't already in the set
+         */
+        bool insert(const Value& value);
+
+        /**
+         * @brief Remove a value from the set
+         *
+         * @param value
+         * @return true if it was in the set
+         */
+        bool remove(const Value& value);
+
+        friend ARK_API bool operator==(const Set& A, const Set& B) noexcept;
+        friend ARK_API bool operator<(const Set& A, const Set& B) noexcept;
+        friend class CycleCollector;
+        friend class Reclaimer;
+        friend class HeapWalker;
+
+    private:
+        struct Table;
+
+        std::shared_ptr<Table> m_table;
+
+        /**
+         * @brief Get the table to modify it, copying it first if it's shared with another set
+         *
+         * @return Table&
+         */
+        Table& mut();
+    };
+}
+
+#endif
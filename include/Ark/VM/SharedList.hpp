@@ -0,0 +1,154 @@
+/**
+ * @file SharedList.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief Reference counted list buffer, copied on write
+ * @version 0.2
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_SHAREDLIST_HPP
+#define ARK_VM_SHAREDLIST_HPP
+
+#include <memory>
+#include <vector>
+#include <cinttypes>
+
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    class Value;
+}
+
+namespace Ark::internal
+{
+    /**
+     * @brief The storage of a List value
+     * @details Copying a list only copies a pointer to its buffer, which is shared until one of the copies is modified.
+     *          The buffer is copied at this moment, unless it is used by a single value, then it's modified in place.
+     *
+     *          A list can also be a slice of another list's buffer (tail, list:slice), which doesn't copy the elements
+     *          either. The slice gets its own buffer when it's modified or read as a std::vector.
+     *
+     */
+    class ARK_API SharedList
+    {
+    public:
+        /**
+         * @brief Construct an empty list
+         *
+         */
+        SharedList() noexcept;
+
+        /**
+         * @brief Construct a list from the given elements
+         *
+         * @param data
+         */
+        explicit SharedList(std::vector<Value>&& data) noexcept;
+
+        /**
+         * @brief Create a slice of the list, sharing its buffer
+         *
+         * @param offset index of the first element of the slice
+         * @param length number of elements in the slice
+         * @return SharedList
+         */
+        SharedList view(std::size_t offset, std::size_t length) const noexcept;
+
+        /**
+         * @brief Number of elements in the list
+         *
+         * @return std::size_t
+         */
+        inline std::size_t size() const noexcept;
+
+        /**
+         * @brief Check if the list is empty
+         *
+         * @return true if it has no elements
+         */
+        inline bool empty() const noexcept;
+
+        /**
+         * @brief Pointer to the first element, to read the list without copying it
+         *
+         * @return const Value*
+         */
+        inline const Value* begin() const noexcept;
+
+        /**
+         * @brief Pointer past the last element
+         *
+         * @return const Value*
+         */
+        inline const Value* end() const noexcept;
+
+        /**
+         * @brief Read an element, without bounds checking
+         *
+         * @param i
+         * @return const Value&
+         */
+        inline const Value& operator[](std::size_t i) const noexcept;
+
+        /**
+         * @brief Read only access to the elements, as a std::vector
+         * @details A slice gets its own buffer first
+         *
+         * @return const std::vector<Value>&
+         */
+        inline const std::vector<Value>& get() const;
+
+        /**
+         * @brief Get the elements to modify them, copying them first if the buffer is shared or if the list is a slice
+         * @details The memory of the elements is counted by the allocator of the list when they're modified, thus
+         *          the growth due to a modification is counted by the next one
+         *
+         * @return std::vector<Value>&
+         */
+        inline std::vector<Value>& mut();
+
+        /**
+         * @brief Check if the buffer is used by a single list
+         *
+         * @return true if the list can be modified in place
+         */
+        inline bool unique() const noexcept;
+
+        friend ARK_API bool operator==(const SharedList& A, const SharedList& B) noexcept;
+        friend ARK_API bool operator<(const SharedList& A, const SharedList& B) noexcept;
+        friend class CycleCollector;
+        friend class Reclaimer;
+        friend class HeapWalker;
+
+    private:
+        // m_size is Whole when the list uses all of its buffer, so that the buffer can grow without updating it.
+        // The offset and size are stored on 32 bits to keep a Value on 32 bytes.
+        // They are mutable because reading a slice as a std::vector gives it its own buffer
+        static constexpr uint32_t Whole = UINT32_MAX;
+
+        mutable std::shared_ptr<std::vector<Value>> m_data;
+        mutable uint32_t m_offset;
+        mutable uint32_t m_size;
+
+        SharedList(const std::shared_ptr<std::vector<Value>>& data, uint32_t offset, uint32_t size) noexcept;
+
+        /**
+         * @brief Copy the elements in a new buffer, owned by this list only
+         *
+         */
+        void detach() const;
+
+        /**
+         * @brief Update the memory of the elements counted by the allocator which created the buffer
+         *
+         */
+        void measure() const noexcept;
+    };
+}
+
+#endif
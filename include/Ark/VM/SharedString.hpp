@@ -0,0 +1,281 @@
+/**
+ * @file SharedString.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief String storage of the values: short strings are stored inline, the longer ones are shared
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_SHAREDSTRING_HPP
+#define ARK_VM_SHAREDSTRING_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <mutex>
+#include <iostream>
+#include <cinttypes>
+#include <cstring>
+#include <atomic>
+#include <new>
+
+#include <Ark/Platform.hpp>
+
+namespace Ark::internal
+{
+    /**
+     * @brief The storage of a String value
+     * @details Strings of up to InlineCapacity bytes are stored in the value itself and don't allocate anything,
+     *          the longer ones are stored in a reference counted buffer, shared by the copies of the value. The
+     *          characters of a string are never modified once written.
+     *
+     *          A buffer has room for more characters than the string which created it. Appending to the last string
+     *          written in a buffer writes the new characters after it, in the same buffer: the result shares it with
+     *          the original string, which keeps its size. Otherwise the characters are copied in a new buffer, twice as
+     *          large as needed, thus building a string by appending pieces to it takes linear time.
+     *
+     *          A long substring is a view on the buffer of the string it comes from: it shares it, starting at an
+     *          offset, thus taking the tail of a string doesn't copy it.
+     *
+     *          The longer strings can also be interned in a StringTable, then two strings interned in the same table
+     *          are equal only if they share their buffer.
+     *
+     */
+    class ARK_API SharedString
+    {
+    public:
+        static constexpr std::size_t InlineCapacity = 22;
+
+        /**
+         * @brief Construct an empty string
+         *
+         */
+        SharedString() noexcept;
+
+        /**
+         * @brief Construct a string from the given characters
+         *
+         * @param str
+         */
+        SharedString(std::string_view str);
+
+        /**
+         * @brief Construct a string from a null terminated C string
+         *
+         * @param str
+         */
+        SharedString(const char* str);
+
+        /**
+         * @brief Construct a string from a std::string
+         *
+         * @param str
+         */
+        SharedString(const std::string& str);
+
+        SharedString(const SharedString& other) noexcept;
+        SharedString(SharedString&& other) noexcept;
+        SharedString& operator=(const SharedString& other) noexcept;
+        SharedString& operator=(SharedString&& other) noexcept;
+        ~SharedString();
+
+        /**
+         * @brief Number of bytes in the string
+         *
+         * @return std::size_t
+         */
+        inline std::size_t size() const noexcept;
+
+        /**
+         * @brief Check if the string is empty
+         *
+         * @return true if it has no characters
+         */
+        inline bool empty() const noexcept;
+
+        /**
+         * @brief Pointer to the characters, followed by a null byte
+         * @details If characters were appended after the string in its buffer, it gets its own buffer first
+         *
+         * @return const char*
+         */
+        inline const char* c_str() const;
+
+        /**
+         * @brief View on the characters
+         *
+         * @return std::string_view
+         */
+        inline std::string_view view() const noexcept;
+
+        /**
+         * @brief Copy the characters in a std::string
+         *
+         * @return std::string
+         */
+        inline std::string toString() const;
+
+        /**
+         * @brief Read a character, without bounds checking
+         *
+         * @param i
+         * @return char
+         */
+        inline char operator[](std::size_t i) const noexcept;
+
+        /**
+         * @brief Add characters at the end of the string
+         * @details They are written in the buffer of the string when it's the last one written there and it has
+         *          enough room left, otherwise the string gets a new buffer
+         *
+         * @param str
+         */
+        void append(std::string_view str);
+
+        /**
+         * @brief Search a substring
+         *
+         * @param str
+         * @return int the position of the substring, -1 if it wasn't found
+         */
+        int find(const SharedString& str) const noexcept;
+
+        /**
+         * @brief Create a string from a part of this one
+         * @details A part too long to be stored inline shares the buffer of this string, unless it was interned
+         *
+         * @param pos index of the first character
+         * @param length number of characters, up to the end of the string
+         * @return SharedString
+         */
+        SharedString substr(std::size_t pos, std::size_t length = std::string_view::npos) const;
+
+        /**
+         * @brief Check if the characters are stored in the value itself
+         *
+         * @return true if the string doesn't use a buffer
+         */
+        inline bool isInline() const noexcept;
+
+        /**
+         * @brief Check if the string was interned in a StringTable
+         *
+         * @return true if its buffer belongs to a table
+         */
+        bool interned() const noexcept;
+
+        /**
+         * @brief Size of the buffer used by the string, 0 when it's stored inline
+         *
+         * @return std::size_t
+         */
+        std::size_t capacity() const noexcept;
+
+        friend ARK_API SharedString operator+(const SharedString& A, const SharedString& B);
+        friend ARK_API bool operator==(const SharedString& A, const SharedString& B) noexcept;
+        friend ARK_API bool operator<(const SharedString& A, const SharedString& B) noexcept;
+        friend ARK_API std::ostream& operator<<(std::ostream& os, const SharedString& S) noexcept;
+        friend class StringTable;
+        friend class HeapWalker;
+
+    private:
+        struct Buffer
+        {
+            /**
+             * @brief Create a buffer holding the concatenation of two strings
+             *
+             * @param first
+             * @param second
+             * @param capacity number of characters the buffer can hold, at least the size of both strings
+             */
+            Buffer(std::string_view first, std::string_view second, std::size_t capacity);
+
+            std::string text;             ///< the size of the text is the capacity of the buffer plus a null byte, it never changes
+            std::atomic<uint32_t> used;   ///< number of characters written, the string ending there can be appended to
+            uint32_t table = 0;           ///< id of the StringTable which interned the string, 0 if it wasn't
+        };
+
+        // The characters are stored in m_storage when the string is short enough, followed by zeros up to the last
+        // byte, which holds the size. Otherwise it holds a std::shared_ptr to the buffer, the size of the string on
+        // 32 bits, the position of its first character in the buffer on 24 bits, and the last byte is Shared. The
+        // whole string fits in 24 bytes to keep a Value on 32 bytes.
+        // It's mutable because reading a string as a C string can give it its own buffer
+        static constexpr uint8_t Shared = 0xff;
+        static constexpr std::size_t StorageSize = InlineCapacity + 2;
+        static constexpr std::size_t LengthOffset = sizeof(std::shared_ptr<Buffer>);
+        static constexpr std::size_t StartOffset = LengthOffset + sizeof(uint32_t);
+        static constexpr uint32_t MaxStart = (1u << 24) - 1;  ///< substrings starting further in the buffer are copied
+        static_assert(StartOffset + 3 <= StorageSize - 1, "the start of a string overlaps its tag");
+
+        alignas(std::shared_ptr<Buffer>) mutable char m_storage[StorageSize];
+
+        inline uint8_t tag() const noexcept;
+        inline uint32_t length() const noexcept;
+        inline void setLength(uint32_t length) noexcept;
+        inline uint32_t start() const noexcept;
+        inline void setStart(uint32_t start) noexcept;
+        inline std::shared_ptr<Buffer>& buffer() const noexcept;
+
+        /**
+         * @brief Store the concatenation of two strings inline, or in a new buffer
+         *
+         * @param first
+         * @param second
+         * @param capacity number of characters the buffer can hold, ignored if the string is stored inline
+         * @param allocator create a buffer with the current allocator, or the global one when false
+         */
+        void assign(std::string_view first, std::string_view second, std::size_t capacity, bool allocator = true);
+
+        /**
+         * @brief Copy the characters in a buffer owned by this string only
+         *
+         */
+        void detach() const;
+
+        void release() noexcept;
+    };
+
+    /**
+     * @brief Table of interned strings, giving the same buffer to the strings with the same characters
+     * @details The short strings are stored inline, they aren't put in the table
+     *
+     */
+    class ARK_API StringTable
+    {
+    public:
+        StringTable() noexcept;
+
+        StringTable(const StringTable&) = delete;
+        StringTable& operator=(const StringTable&) = delete;
+
+        /**
+         * @brief Get the interned string with the given characters, creating it if needed
+         * @details The buffers of the table are allocated with the global allocator, they can outlive the allocator
+         *          of a VM. Thread safe
+         *
+         * @param str
+         * @return SharedString
+         */
+        SharedString intern(std::string_view str);
+
+        /**
+         * @brief Number of strings in the table
+         *
+         * @return std::size_t
+         */
+        std::size_t size() const;
+
+    private:
+        uint32_t m_id;  ///< unique among all the tables created, 0 being used by the strings which weren't interned
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string_view, SharedString> m_strings;  ///< the keys are views on the buffers of the values
+    };
+}
+
+#include "inline/SharedString.inl"
+
+#endif
@@ -16,8 +16,11 @@
 #include <vector>
 #include <cinttypes>
 #include <unordered_map>
+#include <memory>
 
 #include <Ark/VM/Value.hpp>
+#include <Ark/VM/Native.hpp>
+#include <Ark/VM/Plugin.hpp>
 #include <Ark/Compiler/BytecodeReader.hpp>
 #include <Ark/Compiler/Compiler.hpp>
 
@@ -103,6 +106,26 @@ namespace Ark
          */
         void setLibDir(const std::string& libDir) noexcept;
 
+        /**
+         * @brief Load the code pages translated to C++ by `ark --emit-cpp` and built as a shared library
+         * @details Must be called after the bytecode was loaded, the pages must have been generated from the same bytecode.
+         *
+         * @param module path to the shared library
+         * @return true on success
+         * @return false on failure
+         */
+        bool loadNativePages(const std::string& module);
+
+        /**
+         * @brief Get a string sharing its characters with the other strings interned by this state
+         * @details The string constants of the program are interned when it's loaded. Comparing two strings interned
+         *          by the same state only compares pointers. The short strings are stored inline, without being interned
+         *
+         * @param str
+         * @return Value
+         */
+        Value intern(const std::string& str);
+
         /**
          * @brief Reset State (all member variables related to execution)
          * 
@@ -111,6 +134,8 @@ namespace Ark
 
         friend class VM;
         friend class Repl;
+        friend struct internal::NativeOps;
+        friend class CppEmitter;
 
     private:
         /**
@@ -137,6 +162,7 @@ namespace Ark
         unsigned m_debug_level;
 
         bytecode_t m_bytecode;
+        std::string m_hash;  ///< hexadecimal sha256 of the bytecode
         std::string m_libdir;
         std::string m_filename;
         uint16_t m_options;
@@ -144,7 +170,10 @@ namespace Ark
         // related to the bytecode
         std::vector<std::string> m_symbols;
         std::vector<Value> m_constants;
+        internal::StringTable m_strings;  ///< interned strings, kept when the state is reset
         std::vector<bytecode_t> m_pages;
+        std::vector<internal::NativePage_t> m_native_pages;
+        std::shared_ptr<internal::SharedLibrary> m_native_module;
 
         // related to the execution
         std::unordered_map<std::string, Value> m_binded;
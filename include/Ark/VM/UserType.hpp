@@ -17,6 +17,7 @@
 #include <utility>
 
 #include <Ark/Platform.hpp>
+#include <Ark/VM/Allocator.hpp>
 
 namespace Ark
 {
@@ -56,6 +57,7 @@ namespace Ark
         {
             std::ostream& (*ostream_func)(std::ostream&, const UserType&) = nullptr;
             void (*deleter)(void*) = nullptr;
+            std::size_t (*size)(const UserType&) = nullptr;  ///< memory held by the object, counted by the VM
         };
 
         /**
@@ -68,9 +70,14 @@ namespace Ark
         explicit UserType(T* data = nullptr) noexcept :
             m_data(static_cast<void*>(data)),
             m_funcs(nullptr),
-            m_type_id(internal::type_uid<T>::value)
+            m_type_id(internal::type_uid<T>::value),
+            m_charged(false)
         {}
 
+        ARK_API UserType(const UserType& other) noexcept;
+        ARK_API UserType& operator=(const UserType& other) noexcept;
+        ARK_API ~UserType();
+
         /**
          * @brief Destroy the User Type object
          * @details Called by the VM when `(del obj)` is found or when the object goes
@@ -80,10 +87,19 @@ namespace Ark
 
         /**
          * @brief Set the control functions structure
+         * @details The size it gives is counted once by the allocator of the VM running on this thread, until the
+         *          last copy of the UserType is destroyed
          * 
          * @param block A pointer to an instance of this block
          */
-        inline void setControlFuncs(ControlFuncs* block) noexcept;
+        ARK_API void setControlFuncs(ControlFuncs* block) noexcept;
+
+        /**
+         * @brief Get the memory held by the object, as given by the control functions
+         * 
+         * @return std::size_t 0 without a size function
+         */
+        ARK_API std::size_t reportedSize() const;
 
         /**
          * @brief Get the pointer to the object
@@ -137,7 +153,16 @@ namespace Ark
         friend ARK_API std::ostream& operator<<(std::ostream& os, const UserType& A) noexcept;
 
     private:
+        struct Charge;
+
+        /**
+         * @brief Stop sharing the charge of the object, releasing it if it was the last copy
+         *
+         */
+        void detach() noexcept;
+
         uint16_t m_type_id;
+        bool m_charged;  ///< m_funcs is a Charge shared by the copies of the object
         void* m_data;
         ControlFuncs* m_funcs;
     };
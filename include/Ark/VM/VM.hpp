@@ -22,6 +22,8 @@
 #include <unordered_map>
 #include <utility>
 #include <mutex>
+#include <chrono>
+#include <functional>
 
 #include <Ark/VM/Value.hpp>
 #include <Ark/VM/Scope.hpp>
@@ -29,6 +31,12 @@
 #include <Ark/Builtins/Builtins.hpp>
 #include <Ark/Platform.hpp>
 #include <Ark/VM/Plugin.hpp>
+#include <Ark/VM/Native.hpp>
+#include <Ark/VM/JIT.hpp>
+#include <Ark/VM/Coroutine.hpp>
+#include <Ark/VM/CycleCollector.hpp>
+#include <Ark/VM/Reclaimer.hpp>
+#include <Ark/VM/HeapProfile.hpp>
 
 #undef abs
 #include <cmath>
@@ -38,6 +46,13 @@ namespace Ark
     using namespace std::string_literals;
 
     constexpr std::size_t ArkVMStackSize = 8192;
+    constexpr int64_t ArkVMDeadlineCheckInterval = 1024;  ///< instructions run between two checks of the time budget
+    constexpr int64_t ArkVMMemoryCheckInterval = 256;     ///< instructions run between two checks of the memory limit
+
+    namespace internal
+    {
+        struct ParallelMapJob;
+    }
 
     /**
      * @brief The ArkScript virtual machine, executing ArkScript bytecode
@@ -79,6 +94,21 @@ namespace Ark
         template <typename... Args>
         Value call(const std::string& name, Args&&... args);
 
+        /**
+         * @brief Call a function from ArkScript, allocating the objects it creates in a region freed once it returned
+         * @details The result is copied out of the region, which is reused by the next call without giving its memory
+         *          back. If objects of the region are still used after the call (stored in a global variable, or kept
+         *          by a preempted call or a coroutine), the region is kept until they are gone, and the next call gets
+         *          a new one. The regions are freed with the VM at the latest
+         * 
+         * @tparam Args 
+         * @param name the function name in the ArkScript code
+         * @param args C++ argument list, converted to internal representation
+         * @return Value 
+         */
+        template <typename... Args>
+        Value callInArena(const std::string& name, Args&&... args);
+
         // ================================================
         //         function calling from plugins
         // ================================================
@@ -94,6 +124,243 @@ namespace Ark
         template <typename... Args>
         Value resolve(const Value* val, Args&&... args);
 
+        /**
+         * @brief Call a function from a builtin being executed by the VM
+         * @details Unlike resolve, the VM isn't locked (it's already running the builtin) and the arguments are pushed
+         *          directly on the stack. The errors raised by the function are left to the run which called the builtin
+         * 
+         * @tparam Args Values
+         * @param function the ArkScript function object
+         * @param args 
+         * @return Value nil if the function asked the VM to exit
+         */
+        template <typename... Args>
+        Value callback(const Value& function, const Args&... args);
+
+        /**
+         * @brief Apply a function to each value, on worker threads running their own VM on the state of this one
+         * @details The values are split in chunks, which the workers take one after the other until none is left.
+         *          The function and the variables visible from here which are never modified are copied once,
+         *          and shared by the workers since nothing modifies them in place, while each argument is deep
+         *          copied by the worker using it. The function must not capture variables modified by the program
+         *          (with `set`, `del` or an in place instruction), nor hold user types.
+         *          The first error raised by a worker is raised again here, once all the workers stopped.
+         * 
+         * @param function the ArkScript function object
+         * @param values the arguments, one per call
+         * @param workers number of threads, std::thread::hardware_concurrency() if 0
+         * @return std::vector<Value> the results, in the same order as the values
+         */
+        std::vector<Value> parallelMap(const Value& function, const std::vector<Value>& values, std::size_t workers = 0);
+
+        /**
+         * @brief Apply a function to each value, on worker threads running their own VM on the state of this one
+         * 
+         * @param name the function name in the ArkScript code
+         * @param values the arguments, one per call
+         * @param workers number of threads, std::thread::hardware_concurrency() if 0
+         * @return std::vector<Value> the results, in the same order as the values
+         */
+        std::vector<Value> parallelMap(const std::string& name, const std::vector<Value>& values, std::size_t workers = 0);
+
+        // ================================================
+        //                   coroutines
+        // ================================================
+
+        /**
+         * @brief Create a coroutine calling a function, which starts once the current one is suspended
+         * 
+         * @param function the ArkScript function object
+         * @param args 
+         * @return uint32_t the id of the coroutine
+         */
+        uint32_t startCoroutine(const Value& function, std::vector<Value>&& args);
+
+        /**
+         * @brief Get the result of a coroutine, suspending the current one until it finished
+         * @details A coroutine can be awaited only once. When it hasn't finished yet, the current coroutine is
+         *          suspended, and the result will be the value returned to it once resumed
+         * 
+         * @param id 
+         * @return Value the result, nil if the current coroutine was suspended
+         */
+        Value awaitCoroutine(uint32_t id);
+
+        /**
+         * @brief Suspend the current coroutine if other ones are ready to run
+         * 
+         */
+        void yieldCoroutine();
+
+        /**
+         * @brief Suspend the current coroutine for a given duration, running the other ones in the meantime
+         * 
+         * @param milliseconds 
+         * @return true if the coroutine was suspended
+         * @return false if there is no other coroutine, the caller has to wait by itself
+         */
+        bool sleepCoroutine(double milliseconds);
+
+        // ================================================
+        //                   preemption
+        // ================================================
+
+        /**
+         * @brief Limit each run, call, resolve or resume to a slice of instructions and/or time
+         * @details Once the budget is spent, the VM stops between two instructions, with a state which can be resumed.
+         *          It keeps running the functions called by builtins, until it gets back to the code of the program.
+         *          With the JIT, a loop compiled to native code counts the instructions of its body on each iteration
+         * 
+         * @param instructions number of instructions per slice, 0 for no limit
+         * @param time duration of a slice, 0 for no limit
+         */
+        void setBudget(std::size_t instructions, std::chrono::steady_clock::duration time = {}) noexcept;
+
+        /**
+         * @brief Check if the last run, call, resolve or resume stopped because its budget was spent
+         * 
+         * @return bool
+         */
+        bool preempted() const noexcept;
+
+        /**
+         * @brief Continue the execution stopped because its budget was spent, for another slice
+         * @details Throws a std::runtime_error if the VM wasn't preempted
+         * 
+         * @return Value the result of the function given to call or resolve if it returned, nil otherwise
+         */
+        Value resume();
+
+        /**
+         * @brief Get the exit code of the last run
+         * 
+         * @return int
+         */
+        int exitCode() const noexcept;
+
+        /**
+         * @brief State of the VM after a call to VM::step
+         * 
+         */
+        struct StepResult
+        {
+            enum class Status
+            {
+                Running,  ///< the instructions were run, there is more to do
+                Blocked,  ///< every coroutine is sleeping or waiting for a file descriptor
+                Done      ///< the program finished, exitCode() gives its exit code
+            };
+
+            Status status = Status::Done;
+            std::vector<int> fds;                                ///< when Blocked, the file descriptors to wait for
+            std::optional<internal::Clock::time_point> wake_up;  ///< when Blocked, the time at which a coroutine wakes up
+        };
+
+        /**
+         * @brief Run the program, or continue it, for a given number of instructions or until it blocks
+         * @details The first step starts the program, and the next ones continue it until it's done. Instead of
+         *          waiting, the coroutines sleeping or reading a file descriptor (`input`) are left suspended, and
+         *          the step returns Blocked with what the host has to wait for before the next step.
+         *          A step after Done runs the program again
+         * 
+         * @param instructions number of instructions to run, 0 for no limit
+         * @return StepResult
+         */
+        StepResult step(std::size_t instructions);
+
+        /**
+         * @brief Suspend the current coroutine until a file descriptor is readable, to read it without blocking the others
+         * @details Used by the builtins reading a file descriptor
+         * 
+         * @param fd the file descriptor
+         * @param read reads the file descriptor once it's readable, its result is returned to the coroutine
+         * @return true if the coroutine was suspended
+         * @return false if there is no other coroutine and the VM isn't run by step, the caller has to read by itself
+         */
+        bool readCoroutine(int fd, std::function<Value()> read);
+
+        /**
+         * @brief Free the scopes of the closures only referenced by cycles, without waiting for the next collection
+         * @details Collections also run by themselves as closures are created
+         * 
+         * @return std::size_t number of scopes freed
+         */
+        std::size_t collectCycles();
+
+        /**
+         * @brief Get the statistics of the cycle collector: collections, scopes freed and pause times
+         * 
+         * @return const CycleCollectorStats&
+         */
+        const CycleCollectorStats& cycleCollectorStats() const noexcept;
+
+        /**
+         * @brief Get the number of code pages compiled to native code by the JIT
+         * @details Always 0 without ARK_JIT or the FeatureJIT option
+         * 
+         * @return std::size_t
+         */
+        std::size_t compiledPages() const noexcept;
+
+        /**
+         * @brief Get the number of large values given to the background thread destroying them
+         * @details Always 0 without the FeatureDeferredDestruction option
+         * 
+         * @return std::size_t
+         */
+        std::size_t deferredDestructions() const noexcept;
+
+        /**
+         * @brief Get the number of regions of callInArena kept because some of their objects are still used
+         * 
+         * @return std::size_t
+         */
+        std::size_t retainedArenas() const noexcept;
+
+        /**
+         * @brief Set the allocator of the scopes, list buffers, dict and set tables and arrays created by the VM
+         * @details The allocator is NOT owned by the VM, and must outlive it and the values it returned
+         * 
+         * @param allocator nullptr for the global allocator
+         */
+        void setAllocator(Allocator* allocator) noexcept;
+
+        /**
+         * @brief Get the allocator set with setAllocator
+         * 
+         * @return Allocator* 
+         */
+        Allocator* allocator() const noexcept;
+
+        /**
+         * @brief Limit the memory used by the objects created by the VM, stopping it with a MemoryLimitError when it's over
+         * @details The memory is counted by the allocator of the VM, a MallocAllocator created by the VM when none was set,
+         *          which lives as long as the VM or the values created with it:
+         *          scopes, lists and their elements, strings too long to be stored inline, dicts, sets and arrays, and
+         *          the sizes given by the UserTypes through their control functions. The limit is checked every
+         *          ArkVMMemoryCheckInterval instructions and after each call to a builtin
+         * 
+         * @param bytes 0 for no limit
+         */
+        void setMemoryLimit(std::size_t bytes);
+
+        /**
+         * @brief Get the memory used by the objects created by the VM, counted by its allocator
+         * @details The scopes of the closures which died since the last cycle collection are still counted
+         * 
+         * @return std::size_t 0 without an allocator
+         */
+        std::size_t memoryUsage() const noexcept;
+
+        /**
+         * @brief Take a census of the objects alive in the VM, reachable from its stack, its scopes, the closures,
+         *        the coroutines and the constants
+         * @details The VM must not be running on another thread while its objects are walked
+         * 
+         * @return HeapProfile
+         */
+        HeapProfile heapProfile() const;
+
         /**
          * @brief Ask the VM to exit with a given exit code
          * 
@@ -117,6 +384,9 @@ namespace Ark
 
         friend class Value;
         friend class Repl;
+        friend class VMPool;
+        friend struct internal::NativeOps;
+        friend class internal::JIT;
 
     private:
         State* m_state;
@@ -131,6 +401,11 @@ namespace Ark
         std::size_t m_until_frame_count;
         std::mutex m_mutex;
 
+        // related to the per-call arenas, declared before the values which can come from them
+        std::unique_ptr<ArenaAllocator> m_call_arena;                   ///< reused by callInArena
+        std::vector<std::unique_ptr<ArenaAllocator>> m_retired_arenas;  ///< holding objects used after their call
+        std::unique_ptr<Allocator, internal::DestroyWhenUnused> m_own_allocator;  ///< created by setMemoryLimit without an allocator
+
         // related to the execution
         std::unique_ptr<std::array<Value, ArkVMStackSize>> m_stack;
         std::vector<uint8_t> m_scope_count_to_delete;
@@ -138,6 +413,44 @@ namespace Ark
         std::vector<internal::Scope_t> m_locals;
         std::vector<std::shared_ptr<internal::SharedLibrary>> m_shared_lib_objects;
 
+        // related to the native code
+        std::unique_ptr<internal::JIT> m_jit;                ///< only used when built with ARK_JIT
+        std::vector<internal::NativePage_t> m_native_pages;  ///< compiled code pages, indexed by page address
+
+        // related to the coroutines
+        std::unique_ptr<internal::Scheduler> m_scheduler;  ///< created by the first coroutine
+        uint16_t m_execute_depth;                          ///< number of nested calls to execute
+
+        // related to the preemption
+        /**
+         * @brief Execution stopped because its budget was spent, resumed by VM::resume
+         * 
+         */
+        struct Suspension
+        {
+            std::size_t until_frame_count;  ///< of the code running when the VM stopped
+            bool returns_value = false;     ///< started by call or resolve, the result is on the stack once it returned
+            bool restore_registers = false; ///< started by resolve, which gives back the instruction and page pointers
+            bool blocked = false;           ///< every coroutine was sleeping or reading when the VM stopped
+            int ip = 0;
+            std::size_t pp = 0;
+        };
+
+        std::size_t m_budget_instructions;               ///< per slice, 0 for no limit
+        internal::Clock::duration m_budget_time;         ///< per slice, 0 for no limit
+        internal::Clock::time_point m_deadline;
+        int64_t m_budget_left;                           ///< instructions left in the slice when the countdown started
+        int64_t m_budget_window;                         ///< value of the countdown when it started
+        int64_t m_countdown;                             ///< instructions left before checking the budget again
+        std::optional<Suspension> m_suspension;
+        bool m_stepping;  ///< run by VM::step, which returns instead of waiting for the blocked coroutines
+
+        internal::CycleCollector m_collector;  ///< frees the scopes of closures referencing each other
+        std::unique_ptr<internal::Reclaimer> m_reclaimer;  ///< only used with FeatureDeferredDestruction
+        Allocator* m_allocator;                            ///< NOT owned by the VM, nullptr for the global allocator
+        std::size_t m_memory_limit;                        ///< 0 for no limit
+        std::size_t m_memory_outside_arena;                ///< used by the allocator set aside by callInArena
+
         // just a nice little trick for operator[] and for pop
         Value m_no_value = internal::Builtins::nil;
 
@@ -145,18 +458,68 @@ namespace Ark
 
         /**
          * @brief Run ArkScript bytecode inside a try catch to retrieve all the exceptions and display a stack trace if needed
+         * @details When the VM is already running (a builtin calling a function through resolve), the exceptions are
+         *          left to the outer run, and it continues once the function returned
          * 
          * @param untilFrameCount the frame count we need to reach before stopping the VM
          * @return int the exit code
          */
         int safeRun(std::size_t untilFrameCount = 0);
 
+        /**
+         * @brief Run ArkScript bytecode, without catching the exceptions
+         * 
+         * @param untilFrameCount the frame count we need to reach before stopping the VM
+         */
+        void execute(std::size_t untilFrameCount);
+
+        /**
+         * @brief Start a new slice of the budget, before running the code
+         * 
+         */
+        void startSlice() noexcept;
+
+        /**
+         * @brief Called when the countdown reached 0, stop the VM if its budget was spent
+         * @details Throws a MemoryLimitError if the VM used more memory than its limit
+         * 
+         */
+        void checkBudget();
+
+        /**
+         * @brief Throw a MemoryLimitError if the VM used more memory than its limit, after freeing what it could
+         * 
+         */
+        void checkMemoryLimit();
+
+        /**
+         * @brief Free the values kept by the VM without being used: the ones popped from the stack, the scopes which
+         *        died since the last cycle collection
+         * 
+         */
+        void releaseMemory();
+
         /**
          * @brief Initialize the VM according to the parameters
          * 
          */
         void init() noexcept;
 
+        /**
+         * @brief Initialize the VM with copies of the global variables of another VM using the same state
+         * @details The plugins loaded by the other VM are shared instead of being loaded again. Throws a
+         *          std::runtime_error if a global variable holds a user type, which can't be copied
+         * 
+         * @param other a VM which already ran the program
+         */
+        void initFrom(const VM& other);
+
+        /**
+         * @brief Count a call to the current page, compiling it to native code when it becomes hot
+         *
+         */
+        void jitPageCall();
+
         /**
          * @brief Read a 2 bytes number from the current bytecode page, starting at the current instruction
          * @details Modify the instruction pointer to point on the instruction right after the number.
@@ -204,6 +567,24 @@ namespace Ark
          */
         inline Value* popAndResolveAsPtr();
 
+        /**
+         * @brief Pop a value from the stack and resolve it if possible, then return it
+         * @details Temporary values are moved out of the stack, so that a list which isn't referenced
+         *          anywhere else can be modified in place
+         * 
+         * @return Value 
+         */
+        inline Value popAndResolve();
+
+        /**
+         * @brief Check if the list on top of the stack is a variable, in which the next instruction stores
+         *        the result of the current one
+         * @details In this case, the current instruction can modify the variable in place and skip the STORE
+         * 
+         * @return Value* the variable to modify, nullptr if the list must not be modified in place
+         */
+        inline Value* listStoredInPlace() noexcept;
+
         /**
          * @brief Move stack values around and invert them
          * @details values:     1,  2, 3, _, _
@@ -244,6 +625,137 @@ namespace Ark
          */
         void loadPlugin(uint16_t id);
 
+        // ================================================
+        //                   coroutines
+        // ================================================
+
+        /**
+         * @brief Check if the current coroutine can be suspended: not in a function called by a builtin
+         * 
+         * @return bool
+         */
+        inline bool canSuspend() const noexcept;
+
+        /**
+         * @brief Stop the current coroutine, to switch to another one once the builtin suspending it returned
+         * 
+         * @param status why the coroutine is suspended
+         */
+        void suspendCoroutine(internal::Coroutine::Status status) noexcept;
+
+        /**
+         * @brief Switch to the next coroutine to run, when the current one was suspended or finished
+         * @details Called when the execution loop is about to stop
+         * 
+         * @return true if the execution continues with another coroutine
+         * @return false if the VM has to stop
+         */
+        bool switchCoroutine();
+
+        /**
+         * @brief Create the scheduler if needed, the main control flow becoming the coroutine 0
+         * 
+         */
+        void startScheduler();
+
+        /**
+         * @brief Make the coroutines which can continue ready: the sleeping ones once woken up, and the reading ones
+         *        once their file descriptor is readable
+         * @details Throws when all the coroutines are waiting for each other
+         * 
+         * @param wait wait for one of them if none is ready
+         * @return true if a coroutine is ready
+         */
+        bool wakeUpCoroutines(bool wait);
+
+        /**
+         * @brief Find the next coroutine to run, waiting for a sleeping one to wake up if needed
+         * 
+         * @return uint32_t 
+         */
+        uint32_t nextCoroutine();
+
+        /**
+         * @brief Move the stack segment and the registers of the current coroutine out of the VM
+         * @details The references on the stack are resolved, since the scopes they point to can be modified by the
+         *          other coroutines
+         * 
+         * @param coroutine 
+         */
+        void saveCoroutine(internal::Coroutine& coroutine);
+
+        /**
+         * @brief Give the VM the stack segment and the registers of a coroutine, calling its function if it didn't start
+         * 
+         * @param coroutine 
+         */
+        void loadCoroutine(internal::Coroutine& coroutine);
+
+        // ================================================
+        //                  parallel map
+        // ================================================
+
+        /**
+         * @brief Find the variables which can be modified by the bytecode, with `set`, `del` or an in place instruction
+         * 
+         * @return std::vector<bool> indexed by symbol id
+         */
+        std::vector<bool> modifiedSymbols() const;
+
+        /**
+         * @brief Find why a value can't be copied to a VM running on another thread
+         * @details Copying a closure capturing a variable which can be modified would give each thread its own
+         *          version of the variable
+         * 
+         * @param value 
+         * @param modified the variables which can be modified, given by modifiedSymbols
+         * @return std::optional<std::string> the reason, nothing if the value can be copied
+         */
+        std::optional<std::string> untransferableReason(const Value& value, const std::vector<bool>& modified) const;
+
+        /**
+         * @brief Copy a value and everything it holds, to give it to a VM running on another thread
+         * @details Lists, dicts, sets, arrays and the scopes of the closures get their own buffers
+         * 
+         * @param value 
+         * @param usertypes copy the UserType values (not their data) instead of rejecting them
+         * @return Value 
+         */
+        static Value deepCopy(const Value& value, bool usertypes = false);
+
+        /**
+         * @brief State of the VM replaced during a call in an arena
+         * 
+         */
+        struct ArenaCall
+        {
+            Allocator* allocator;
+            std::unique_ptr<internal::Reclaimer> reclaimer;  ///< the values are freed with the arena instead
+        };
+
+        /**
+         * @brief Make the per-call arena the allocator of the VM, until leaveArena
+         * 
+         * @return ArenaCall 
+         */
+        ArenaCall enterArena();
+
+        /**
+         * @brief Copy the result of a call out of the arena and free it, unless some of its objects are still used
+         * 
+         * @param arena_call given by enterArena
+         * @param result allocated in the arena
+         * @return Value 
+         */
+        Value leaveArena(ArenaCall&& arena_call, Value&& result);
+
+        /**
+         * @brief Run a worker of parallelMap, taking chunks of values until there are none left
+         * 
+         * @param job the values, results and chunks shared by the workers
+         */
+        void parallelMapWorker(internal::ParallelMapJob& job);
+
         // ================================================
         //                  error handling
         // ================================================
@@ -280,6 +792,7 @@ namespace Ark
     };
 
 #include "inline/VM.inl"
+#include "inline/Native.inl"
 
     /// ArkScript Nil value
     const Value Nil = Value(ValueType::Nil);
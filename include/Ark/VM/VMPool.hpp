@@ -0,0 +1,135 @@
+/**
+ * @file VMPool.hpp
+ * @author Alexandre Plateau (lexplt.dev@gmail.com)
+ * @brief A pool of virtual machines sharing the same state, to call ArkScript functions from multiple threads
+ * @version 0.1
+ * @date 2021-10-18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARK_VM_VMPOOL_HPP
+#define ARK_VM_VMPOOL_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Ark/VM/VM.hpp>
+#include <Ark/Platform.hpp>
+
+namespace Ark
+{
+    /**
+     * @brief Virtual machines initialized once from the same state, handed out to the threads calling ArkScript functions
+     * @details The program is run once, by the first VM, and the others get copies of its global variables. After each
+     *          use, a VM is reset to the global variables it had once initialized, without running the program again
+     *          nor loading the plugins again. The closures among them get copies of the scopes they captured, so that
+     *          what a call changes through them doesn't leak into the next one. Getting a VM doesn't lock a mutex: the
+     *          threads look for a free VM, and yield to the others when all of them are used.
+     *
+     */
+    class ARK_API VMPool
+    {
+    private:
+        struct Slot
+        {
+            std::unique_ptr<VM> vm;
+            internal::Scope globals;          ///< global variables of the VM once initialized, restored before each use
+            std::vector<bool> with_closures;  ///< the globals holding closures, which are copied with their scopes
+            bool dirty = false;               ///< the VM was used since its globals were restored
+            std::atomic<bool> used = false;
+        };
+
+        class GlobalsCopier;
+
+    public:
+        /**
+         * @brief A VM taken from the pool, given back to it when the handle is destroyed
+         *
+         */
+        class ARK_API Handle
+        {
+        public:
+            Handle(Handle&& other) noexcept;
+            Handle(const Handle&) = delete;
+            Handle& operator=(const Handle&) = delete;
+            Handle& operator=(Handle&&) = delete;
+            ~Handle();
+
+            inline VM& operator*() noexcept;
+            inline VM* operator->() noexcept;
+
+            friend class VMPool;
+
+        private:
+            VMPool* m_pool;
+            Slot* m_slot;
+
+            Handle(VMPool* pool, Slot* slot) noexcept;
+        };
+
+        /**
+         * @brief Construct a new VMPool object, running the program
+         * @details Throws a std::runtime_error if the program failed
+         *
+         * @param state the state shared by the VMs, which must outlive the pool
+         * @param size number of VMs, std::thread::hardware_concurrency() if 0
+         */
+        explicit VMPool(State* state, std::size_t size = 0);
+
+        ~VMPool();
+
+        /**
+         * @brief Take a free VM from the pool, waiting for one if they are all used
+         * @details The global variables of the VM are restored if it was used since, which can throw a std::bad_alloc
+         *
+         * @return Handle
+         */
+        Handle acquire();
+
+        /**
+         * @brief Call a function from ArkScript on a free VM of the pool
+         *
+         * @tparam Args
+         * @param name the function name in the ArkScript code
+         * @param args C++ argument list, converted to internal representation
+         * @return Value
+         */
+        template <typename... Args>
+        Value call(const std::string& name, Args&&... args);
+
+        /**
+         * @brief Number of VMs in the pool
+         *
+         * @return std::size_t
+         */
+        inline std::size_t size() const noexcept;
+
+    private:
+        std::unique_ptr<Slot[]> m_slots;
+        std::size_t m_size;
+        std::atomic<std::size_t> m_next;  ///< where the next thread starts looking for a free VM
+
+        /**
+         * @brief Copy the global variables of a VM to restore them later, or restore them
+         *
+         * @param slot
+         * @param save true to take the copy, false to restore it
+         */
+        static void copyGlobals(Slot& slot, bool save);
+
+        /**
+         * @brief Stop a VM and put it back in the pool, its global variables are restored by the next acquire
+         *
+         * @param slot
+         */
+        void release(Slot& slot) noexcept;
+    };
+
+#include "inline/VMPool.inl"
+}
+
+#endif
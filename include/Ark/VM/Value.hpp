@@ -24,6 +24,11 @@
 #include <array>
 
 #include <Ark/VM/Closure.hpp>
+#include <Ark/VM/SharedList.hpp>
+#include <Ark/VM/SharedString.hpp>
+#include <Ark/VM/Dict.hpp>
+#include <Ark/VM/Set.hpp>
+#include <Ark/VM/Array.hpp>
 #include <Ark/Exceptions.hpp>
 #include <Ark/VM/UserType.hpp>
 #include <Ark/Platform.hpp>
@@ -32,6 +37,17 @@
 namespace Ark
 {
     class VM;
+    class VMPool;
+    class RegisterVM;
+
+    namespace internal
+    {
+        struct NativeOps;
+        class JIT;
+        class CycleCollector;
+        class Reclaimer;
+        class HeapWalker;
+    }
 
     // Note from the creator: we can have at most 0b01111111 (127) different types
     // because type index is stored on the 7 right most bits of a uint8_t in the class Value.
@@ -46,20 +62,23 @@ namespace Ark
         CProc = 4,
         Closure = 5,
         User = 6,
-
-        Nil = 7,
-        True = 8,
-        False = 9,
-        Undefined = 10,
-        Reference = 11,
-        InstPtr = 12
+        Dict = 7,
+        Set = 8,
+        Array = 9,
+
+        Nil = 10,
+        True = 11,
+        False = 12,
+        Undefined = 13,
+        Reference = 14,
+        InstPtr = 15
     };
 
-    const std::array<std::string, 13> types_to_str = {
+    const std::array<std::string, 16> types_to_str = {
         "List", "Number", "String", "Function",
-        "CProc", "Closure", "UserType", "Nil",
-        "Bool", "Bool", "Undefined", "Reference",
-        "InstPtr"
+        "CProc", "Closure", "UserType", "Dict",
+        "Set", "Array", "Nil", "Bool",
+        "Bool", "Undefined", "Reference", "InstPtr"
     };
 
 // for debugging purposes only
@@ -75,16 +94,19 @@ namespace Ark
         using ConstIterator = std::vector<Value>::const_iterator;
 
         using Value_t = std::variant<
-            double,                //  8 bytes
-            String,                // 16 bytes
-            internal::PageAddr_t,  //  2 bytes
-            ProcType,              //  8 bytes
-            internal::Closure,     // 24 bytes
-            UserType,              // 24 bytes
-            std::vector<Value>,    // 24 bytes
-            Value*                 //  8 bytes
-            >;                     // +8 bytes overhead
-        //                      total 32 bytes
+            double,                  //  8 bytes
+            internal::SharedString,  // 24 bytes
+            internal::PageAddr_t,    //  2 bytes
+            ProcType,                //  8 bytes
+            internal::Closure,       // 24 bytes
+            UserType,                // 24 bytes
+            internal::SharedList,    // 24 bytes
+            internal::Dict,          // 16 bytes
+            internal::Set,           // 16 bytes
+            internal::Array,         // 16 bytes
+            Value*                   //  8 bytes
+            >;                       // +8 bytes overhead
+        //                        total 32 bytes
 
         /**
          * @brief Construct a new Value object
@@ -111,13 +133,14 @@ namespace Ark
         template <typename T>
         Value(ValueType type, T&& value) noexcept :
             m_const_type(static_cast<uint8_t>(type)),
-            m_value(value)
+            m_value(std::forward<T>(value))
         {}
 
 #ifdef ARK_PROFILER_COUNT
         Value(const Value& val) noexcept;
         Value(Value&& other) noexcept;
         Value& operator=(const Value& other) noexcept;
+        Value& operator=(Value&& other) noexcept;
 #endif
 
         /**
@@ -162,6 +185,13 @@ namespace Ark
          */
         explicit Value(const char* value) noexcept;
 
+        /**
+         * @brief Construct a new Value object as a String, sharing its characters with another one
+         * 
+         * @param value 
+         */
+        explicit Value(internal::SharedString&& value) noexcept;
+
         /**
          * @brief Construct a new Value object as a Function
          * 
@@ -183,6 +213,13 @@ namespace Ark
          */
         explicit Value(std::vector<Value>&& value) noexcept;
 
+        /**
+         * @brief Construct a new Value object as a List, sharing its elements with another one
+         * 
+         * @param value 
+         */
+        explicit Value(internal::SharedList&& value) noexcept;
+
         /**
          * @brief Construct a new Value object as a Closure
          * 
@@ -197,6 +234,27 @@ namespace Ark
          */
         explicit Value(UserType&& value) noexcept;
 
+        /**
+         * @brief Construct a new Value object as a Dict
+         * 
+         * @param value 
+         */
+        explicit Value(internal::Dict&& value) noexcept;
+
+        /**
+         * @brief Construct a new Value object as a Set
+         * 
+         * @param value 
+         */
+        explicit Value(internal::Set&& value) noexcept;
+
+        /**
+         * @brief Construct a new Value object as an Array
+         * 
+         * @param value 
+         */
+        explicit Value(internal::Array&& value) noexcept;
+
         /**
          * @brief Construct a new Value object as a reference to an internal object
          * 
@@ -229,17 +287,25 @@ namespace Ark
         /**
          * @brief Return the stored string
          * 
-         * @return const String& 
+         * @return const internal::SharedString& 
          */
-        inline const String& string() const;
+        inline const internal::SharedString& string() const;
 
         /**
          * @brief Return the stored list
+         * @details If the list is a slice of another one, its elements are copied first
          * 
          * @return const std::vector<Value>& 
          */
         inline const std::vector<Value>& constList() const;
 
+        /**
+         * @brief Return the stored list, to read it without copying its elements even if it's a slice
+         * 
+         * @return const internal::SharedList& 
+         */
+        inline const internal::SharedList& listView() const;
+
         /**
          * @brief Return the stored user type
          * 
@@ -248,18 +314,40 @@ namespace Ark
         inline const UserType& usertype() const;
 
         /**
-         * @brief Return the stored list as a reference
+         * @brief Return the stored dictionary
+         * 
+         * @return const internal::Dict& 
+         */
+        inline const internal::Dict& dict() const;
+
+        /**
+         * @brief Return the stored set
+         * 
+         * @return const internal::Set& 
+         */
+        inline const internal::Set& set() const;
+
+        /**
+         * @brief Return the stored array of numbers
+         * 
+         * @return const internal::Array& 
+         */
+        inline const internal::Array& array() const;
+
+        /**
+         * @brief Return the stored list as a reference, to modify it
+         * @details The elements are copied first if they are shared with another list
          * 
          * @return std::vector<Value>& 
          */
         std::vector<Value>& list();
 
         /**
-         * @brief Return the stored string as a reference
+         * @brief Return the stored string as a reference, to replace it
          * 
-         * @return String& 
+         * @return internal::SharedString& 
          */
-        String& stringRef();
+        internal::SharedString& stringRef();
 
         /**
          * @brief Return the stored user type as a reference
@@ -268,6 +356,35 @@ namespace Ark
          */
         UserType& usertypeRef();
 
+        /**
+         * @brief Return the stored dictionary as a reference, to modify it
+         * 
+         * @return internal::Dict& 
+         */
+        internal::Dict& dictRef();
+
+        /**
+         * @brief Return the stored set as a reference, to modify it
+         * 
+         * @return internal::Set& 
+         */
+        internal::Set& setRef();
+
+        /**
+         * @brief Return the stored array of numbers as a reference, to modify it
+         * 
+         * @return internal::Array& 
+         */
+        internal::Array& arrayRef();
+
+        /**
+         * @brief Compute the hash of the value, consistent with operator==
+         * @details Lists, arrays, dicts and sets are hashed from their content, functions, closures and user types by identity
+         * 
+         * @return std::size_t 
+         */
+        std::size_t hash() const noexcept;
+
         /**
          * @brief Return the stored internal object reference
          * 
@@ -295,6 +412,13 @@ namespace Ark
         friend ARK_API inline bool operator!(const Value& A) noexcept;
 
         friend class Ark::VM;
+        friend class Ark::VMPool;
+        friend class Ark::RegisterVM;
+        friend struct internal::NativeOps;
+        friend class internal::JIT;
+        friend class internal::CycleCollector;
+        friend class internal::Reclaimer;
+        friend class internal::HeapWalker;
 
     private:
         uint8_t m_const_type;  ///< First bit if for constness, right most bits are for type
@@ -349,4 +473,24 @@ namespace Ark
 #include "inline/Value.inl"
 }
 
+#include "inline/SharedList.inl"
+#include "inline/Dict.inl"
+#include "inline/Set.inl"
+
+namespace std
+{
+    /**
+     * @brief Hash a Value, to use it as a key in the standard unordered containers
+     * 
+     */
+    template <>
+    struct hash<Ark::Value>
+    {
+        std::size_t operator()(const Ark::Value& value) const noexcept
+        {
+            return value.hash();
+        }
+    };
+}
+
 #endif
@@ -0,0 +1,36 @@
+inline void MemoryMeter::update(std::size_t bytes) noexcept
+{
+    if (m_allocator == nullptr || bytes == m_charged)
+        return;
+
+    if (bytes > m_charged)
+        m_allocator->charge(bytes - m_charged);
+    else
+        m_allocator->release(m_charged - bytes);
+    m_charged = bytes;
+}
+
+template <typename T>
+inline T* AllocatorAdaptor<T>::allocate(std::size_t n)
+{
+    if (m_allocator == nullptr)
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    return static_cast<T*>(m_allocator->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+inline void AllocatorAdaptor<T>::deallocate(T* ptr, std::size_t n) noexcept
+{
+    if (m_allocator == nullptr)
+        ::operator delete(ptr);
+    else
+        m_allocator->deallocate(ptr, n * sizeof(T), alignof(T));
+}
+
+template <typename T, typename... Args>
+inline std::shared_ptr<T> makeShared(Args&&... args)
+{
+    if (Allocator* allocator = Allocator::current(); allocator != nullptr)
+        return std::allocate_shared<T>(AllocatorAdaptor<T>(allocator), std::forward<Args>(args)...);
+    return std::make_shared<T>(std::forward<Args>(args)...);
+}
@@ -0,0 +1,19 @@
+namespace Ark::internal
+{
+    inline std::size_t Array::size() const noexcept
+    {
+        return m_data->size();
+    }
+
+    inline const std::vector<double>& Array::get() const noexcept
+    {
+        return *m_data;
+    }
+
+    inline std::vector<double>& Array::mut()
+    {
+        if (m_data.use_count() != 1)
+            m_data = std::make_shared<std::vector<double>>(*m_data);
+        return *m_data;
+    }
+}
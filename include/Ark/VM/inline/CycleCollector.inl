@@ -0,0 +1,14 @@
+inline void CycleCollector::track(const Scope_t& scope)
+{
+    m_tracked.emplace_back(scope);
+}
+
+inline bool CycleCollector::shouldCollect() const noexcept
+{
+    return m_tracked.size() >= m_threshold;
+}
+
+inline const CycleCollectorStats& CycleCollector::stats() const noexcept
+{
+    return m_stats;
+}
@@ -0,0 +1,13 @@
+namespace Ark::internal
+{
+    /**
+     * @brief A key and its value, with the hash of the key to avoid computing it again when resizing the index
+     *
+     */
+    struct Dict::Entry
+    {
+        Value key;
+        Value value;
+        std::size_t hash;
+    };
+}
@@ -0,0 +1,122 @@
+inline bool internal::NativeOps::loadSymbol(VM* vm, uint16_t id)
+{
+    Value* var = vm->findNearestVariable(id);
+    if (var == nullptr)
+        return false;
+
+    vm->m_last_sym_loaded = id;
+    vm->push(var);
+    return true;
+}
+
+inline bool internal::NativeOps::loadConst(VM* vm, uint16_t id)
+{
+    if (vm->m_saved_scope && vm->m_state->m_constants[id].valueType() == ValueType::PageAddr)
+    {
+        // nothing may be thrown through the native frames, the interpreter will run the instruction again
+        try
+        {
+            vm->m_collector.track(vm->m_saved_scope.value());
+        }
+        catch (...)
+        {
+            return false;
+        }
+        vm->push(Value(Closure(std::move(vm->m_saved_scope.value()), vm->m_state->m_constants[id].pageAddr())));
+        vm->m_saved_scope.reset();
+
+        // the collection runs in checkBudget, once the native code has given the control back to the interpreter
+        if (vm->m_collector.shouldCollect())
+        {
+            vm->m_budget_window -= vm->m_countdown;
+            vm->m_countdown = 0;
+        }
+    }
+    else
+        vm->push(&(vm->m_state->m_constants[id]));
+    return true;
+}
+
+inline bool internal::NativeOps::store(VM* vm, uint16_t id)
+{
+    Value* var = vm->findNearestVariable(id);
+    if (var == nullptr || var->isConst())
+        return false;
+    // the reclaimer can start its thread, let the interpreter give it the value
+    if (vm->m_reclaimer && Reclaimer::isLarge(*var))
+        return false;
+
+    Value value = vm->popAndResolve();
+    *var = std::move(value);
+    var->setConst(false);
+    return true;
+}
+
+inline void internal::NativeOps::builtin(VM* vm, uint16_t id)
+{
+    vm->push(Builtins::builtins[id].second);
+}
+
+inline void internal::NativeOps::setNumber(Value* slot, double number)
+{
+    slot->m_value = number;
+    slot->m_const_type = static_cast<uint8_t>(ValueType::Number);
+}
+
+inline void internal::NativeOps::setBool(Value* slot, bool value)
+{
+    *slot = value ? Builtins::trueSym : Builtins::falseSym;
+}
+
+inline bool internal::NativeOps::numbers(VM* vm, double& a, double& b)
+{
+    if (vm->m_sp < 2)
+        return false;
+
+    Value* vb = &(*vm->m_stack)[vm->m_sp - 1];
+    Value* va = &(*vm->m_stack)[vm->m_sp - 2];
+    if (vb->valueType() == ValueType::Reference)
+        vb = vb->reference();
+    if (va->valueType() == ValueType::Reference)
+        va = va->reference();
+
+    if (va->valueType() != ValueType::Number || vb->valueType() != ValueType::Number)
+        return false;
+
+    a = va->number();
+    b = vb->number();
+    return true;
+}
+
+inline void internal::NativeOps::reduceNumber(VM* vm, double number)
+{
+    --vm->m_sp;
+    setNumber(&(*vm->m_stack)[vm->m_sp - 1], number);
+}
+
+inline void internal::NativeOps::reduceBool(VM* vm, bool value)
+{
+    --vm->m_sp;
+    setBool(&(*vm->m_stack)[vm->m_sp - 1], value);
+}
+
+inline void internal::NativeOps::drop(VM* vm, uint16_t count)
+{
+    vm->m_sp -= count;
+}
+
+inline bool internal::NativeOps::popIs(VM* vm, ValueType type)
+{
+    return vm->popAndResolveAsPtr()->valueType() == type;
+}
+
+inline bool internal::NativeOps::spend(VM* vm, int32_t instructions)
+{
+    vm->m_countdown -= instructions;
+    return vm->m_countdown > 0;
+}
+
+inline void internal::NativeOps::leave(VM* vm, int ip)
+{
+    vm->m_ip = ip;
+}
@@ -0,0 +1,4 @@
+inline std::size_t Reclaimer::taken() const noexcept
+{
+    return m_taken;
+}
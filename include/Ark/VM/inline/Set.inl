@@ -0,0 +1,12 @@
+namespace Ark::internal
+{
+    /**
+     * @brief An element of a set, with its hash
+     *
+     */
+    struct Set::Entry
+    {
+        Value key;
+        std::size_t hash;
+    };
+}
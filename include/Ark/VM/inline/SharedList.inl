@@ -0,0 +1,47 @@
+namespace Ark::internal
+{
+    inline std::size_t SharedList::size() const noexcept
+    {
+        return (m_size == Whole) ? m_data->size() : m_size;
+    }
+
+    inline bool SharedList::empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    inline const Value* SharedList::begin() const noexcept
+    {
+        return m_data->data() + m_offset;
+    }
+
+    inline const Value* SharedList::end() const noexcept
+    {
+        return begin() + size();
+    }
+
+    inline const Value& SharedList::operator[](std::size_t i) const noexcept
+    {
+        return begin()[i];
+    }
+
+    inline const std::vector<Value>& SharedList::get() const
+    {
+        if (m_size != Whole)
+            detach();
+        return *m_data;
+    }
+
+    inline std::vector<Value>& SharedList::mut()
+    {
+        if (m_size != Whole || m_data.use_count() != 1)
+            detach();
+        measure();
+        return *m_data;
+    }
+
+    inline bool SharedList::unique() const noexcept
+    {
+        return m_size == Whole && m_data.use_count() == 1;
+    }
+}
@@ -0,0 +1,80 @@
+namespace Ark::internal
+{
+    inline std::size_t SharedString::size() const noexcept
+    {
+        return isInline() ? tag() : length();
+    }
+
+    inline bool SharedString::empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    inline const char* SharedString::c_str() const
+    {
+        if (isInline())
+            return m_storage;
+        // the null byte after the string was replaced by the characters appended to it, or it's a part of the buffer
+        if (buffer()->used.load(std::memory_order_acquire) != start() + length())
+            detach();
+        return buffer()->text.c_str() + start();
+    }
+
+    inline std::string_view SharedString::view() const noexcept
+    {
+        if (isInline())
+            return std::string_view(m_storage, tag());
+        return std::string_view(buffer()->text.data() + start(), length());
+    }
+
+    inline std::string SharedString::toString() const
+    {
+        return std::string(view());
+    }
+
+    inline char SharedString::operator[](std::size_t i) const noexcept
+    {
+        return view()[i];
+    }
+
+    inline bool SharedString::isInline() const noexcept
+    {
+        return tag() != Shared;
+    }
+
+    inline uint8_t SharedString::tag() const noexcept
+    {
+        return static_cast<uint8_t>(m_storage[StorageSize - 1]);
+    }
+
+    inline uint32_t SharedString::length() const noexcept
+    {
+        uint32_t length;
+        std::memcpy(&length, m_storage + LengthOffset, sizeof(uint32_t));
+        return length;
+    }
+
+    inline void SharedString::setLength(uint32_t length) noexcept
+    {
+        std::memcpy(m_storage + LengthOffset, &length, sizeof(uint32_t));
+    }
+
+    inline uint32_t SharedString::start() const noexcept
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(m_storage + StartOffset);
+        return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) | (static_cast<uint32_t>(bytes[2]) << 16);
+    }
+
+    inline void SharedString::setStart(uint32_t start) noexcept
+    {
+        auto* bytes = reinterpret_cast<uint8_t*>(m_storage + StartOffset);
+        bytes[0] = static_cast<uint8_t>(start);
+        bytes[1] = static_cast<uint8_t>(start >> 8);
+        bytes[2] = static_cast<uint8_t>(start >> 16);
+    }
+
+    inline std::shared_ptr<SharedString::Buffer>& SharedString::buffer() const noexcept
+    {
+        return *std::launder(reinterpret_cast<std::shared_ptr<Buffer>*>(m_storage));
+    }
+}
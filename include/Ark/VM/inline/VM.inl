@@ -20,6 +20,9 @@ Value VM::call(const std::string& name, Args&&... args)
 
     const std::lock_guard<std::mutex> lock(m_mutex);
 
+    if (m_suspension)
+        throw std::runtime_error("VM::call: the VM was stopped by its budget and must be resumed first");
+
     // reset ip and pp
     m_ip = 0;
     m_pp = 0;
@@ -29,9 +32,9 @@ Value VM::call(const std::string& name, Args&&... args)
     if (it == m_state->m_symbols.end())
         throwVMError("unbound variable: " + name);
 
-    // convert and push arguments in reverse order
+    // convert and push arguments in the order of the compiled code, the last one on top of the stack
     std::vector<Value> fnargs { { Value(args)... } };
-    for (auto it2 = fnargs.rbegin(), it_end = fnargs.rend(); it2 != it_end; ++it2)
+    for (auto it2 = fnargs.begin(), it_end = fnargs.end(); it2 != it_end; ++it2)
         push(*it2);
 
     // find function object and push it if it's a pageaddr/closure
@@ -65,8 +68,34 @@ Value VM::call(const std::string& name, Args&&... args)
     // run until the function returns
     safeRun(/* untilFrameCount */ frames_count);
 
+    // the budget was spent, the result will be given by resume
+    if (m_suspension)
+    {
+        m_suspension->returns_value = true;
+        return Builtins::nil;
+    }
+
     // get result
-    return *popAndResolveAsPtr();
+    return popAndResolve();
+}
+
+template <typename... Args>
+Value VM::callInArena(const std::string& name, Args&&... args)
+{
+    ArenaCall arena_call = enterArena();
+
+    Value result;
+    try
+    {
+        result = call(name, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        leaveArena(std::move(arena_call), Value(internal::Builtins::nil));
+        throw;
+    }
+
+    return leaveArena(std::move(arena_call), std::move(result));
 }
 
 template <typename... Args>
@@ -76,15 +105,17 @@ Value VM::resolve(const Value* val, Args&&... args)
 
     const std::lock_guard<std::mutex> lock(m_mutex);
 
+    if (m_suspension)
+        throw std::runtime_error("VM::resolve: the VM was stopped by its budget and must be resumed first");
     if (!val->isFunction())
         throw TypeError("Value::resolve couldn't resolve a non-function");
 
     int ip = m_ip;
     std::size_t pp = m_pp;
 
-    // convert and push arguments in reverse order
+    // convert and push arguments in the order of the compiled code, the last one on top of the stack
     std::vector<Value> fnargs { { Value(args)... } };
-    for (auto it = fnargs.rbegin(), it_end = fnargs.rend(); it != it_end; ++it)
+    for (auto it = fnargs.begin(), it_end = fnargs.end(); it != it_end; ++it)
         push(resolveRef(it));
     // push function
     push(resolveRef(val));
@@ -100,12 +131,74 @@ Value VM::resolve(const Value* val, Args&&... args)
     // run until the function returns
     safeRun(/* untilFrameCount */ frames_count);
 
+    // the budget was spent, the result will be given by resume
+    if (m_suspension)
+    {
+        m_suspension->returns_value = true;
+        m_suspension->restore_registers = true;
+        m_suspension->ip = ip;
+        m_suspension->pp = pp;
+        return Builtins::nil;
+    }
+
     // restore VM state
     m_ip = ip;
     m_pp = pp;
 
     // get result
-    return *popAndResolveAsPtr();
+    return popAndResolve();
+}
+
+template <typename... Args>
+Value VM::callback(const Value& function, const Args&... args)
+{
+    using namespace internal;
+
+    // the function asked to exit during a previous call
+    if (!m_running)
+        return Builtins::nil;
+
+    int ip = m_ip;
+    std::size_t pp = m_pp;
+    uint16_t last_sym_loaded = m_last_sym_loaded;
+    std::size_t frames_count = m_fc;
+
+    // push arguments in the order of the compiled code, then the function
+    const std::array<const Value*, sizeof...(Args)> argv { { &args... } };
+    for (const Value* arg : argv)
+        push(*arg);
+    push(function);
+
+    // the last symbol loaded isn't the function, it mustn't be bound to it in the new scope
+    m_last_sym_loaded = static_cast<uint16_t>(m_state->m_symbols.size());
+    call(static_cast<int16_t>(sizeof...(Args)));
+
+    // a CProc was already executed by call, otherwise run until the function returns
+    if (m_fc != frames_count)
+    {
+        m_ip = 0;
+        execute(frames_count);
+
+        // returning from the function stopped the VM to get back here
+        if (m_fc == frames_count)
+            m_running = true;
+    }
+
+    // restore VM state
+    m_ip = ip;
+    m_pp = pp;
+    m_last_sym_loaded = last_sym_loaded;
+
+    // the function asked to exit before returning
+    if (m_fc != frames_count)
+        return Builtins::nil;
+    return popAndResolve();
+}
+
+inline bool VM::canSuspend() const noexcept
+{
+    // a builtin calling a function runs it in a nested execution loop, which must return to the builtin
+    return m_scheduler != nullptr && m_execute_depth == 1;
 }
 
 #pragma region "stack management"
@@ -160,6 +253,34 @@ inline Value* VM::popAndResolveAsPtr()
     return tmp;
 }
 
+inline Value VM::popAndResolve()
+{
+    Value* tmp = pop();
+    if (tmp->valueType() == ValueType::Reference)
+        return *tmp->reference();
+    else if (tmp == &m_no_value)
+        return m_no_value;
+    return std::move(*tmp);
+}
+
+inline Value* VM::listStoredInPlace() noexcept
+{
+    if (m_sp == 0 || (*m_stack)[m_sp - 1].valueType() != ValueType::Reference)
+        return nullptr;
+
+    Value* var = (*m_stack)[m_sp - 1].reference();
+    if (var->isConst() || var->valueType() != ValueType::List)
+        return nullptr;
+
+    // m_ip is on the last byte of the current instruction
+    const bytecode_t& page = m_state->m_pages[m_pp];
+    if (static_cast<std::size_t>(m_ip) + 3 >= page.size() || page[m_ip + 1] != internal::Instruction::STORE)
+        return nullptr;
+
+    uint16_t id = (static_cast<uint16_t>(page[m_ip + 2]) << 8) + static_cast<uint16_t>(page[m_ip + 3]);
+    return findNearestVariable(id) == var ? var : nullptr;
+}
+
 inline void VM::swapStackForFunCall(uint16_t argc)
 {
     using namespace internal;
@@ -223,7 +344,7 @@ inline void VM::swapStackForFunCall(uint16_t argc)
 
 inline void VM::createNewScope() noexcept
 {
-    m_locals.emplace_back(std::make_shared<internal::Scope>());
+    m_locals.emplace_back(internal::makeShared<internal::Scope>());
 }
 
 inline Value* VM::findNearestVariable(uint16_t id) noexcept
@@ -246,10 +367,14 @@ inline void VM::returnFromFuncCall()
     uint8_t del_counter = m_scope_count_to_delete.back();
 
     // PERF high cpu cost because destroying variants cost
+    if (m_reclaimer)
+        m_reclaimer->takeFrom(m_locals.back());
     m_locals.pop_back();
 
     while (del_counter != 0)
     {
+        if (m_reclaimer)
+            m_reclaimer->takeFrom(m_locals.back());
         m_locals.pop_back();
         del_counter--;
     }
@@ -288,7 +413,11 @@ inline void VM::call(int16_t argc_)
     else
         argc = argc_;
 
-    Value function = *popAndResolveAsPtr();
+    Value function = popAndResolve();
+    // the name of the function is unknown when it's called from a builtin
+    auto name = [this]() -> std::string {
+        return (m_last_sym_loaded < m_state->m_symbols.size()) ? m_state->m_symbols[m_last_sym_loaded] : "???";
+    };
 
     switch (function.valueType())
     {
@@ -298,10 +427,13 @@ inline void VM::call(int16_t argc_)
             // drop arguments from the stack
             std::vector<Value> args(argc);
             for (uint16_t j = 0; j < argc; ++j)
-                args[argc - 1 - j] = *popAndResolveAsPtr();
+                args[argc - 1 - j] = popAndResolve();
 
             // call proc
             push(function.proc()(args, this));
+            // a builtin can create a lot of objects at once
+            if (m_memory_limit != 0)
+                checkMemoryLimit();
             return;
         }
 
@@ -321,6 +453,10 @@ inline void VM::call(int16_t argc_)
 
             m_pp = new_page_pointer;
             m_ip = -1;  // because we are doing a m_ip++ right after that
+#ifdef ARK_JIT
+            if (m_jit)
+                jitPageCall();
+#endif
             break;
         }
 
@@ -340,11 +476,15 @@ inline void VM::call(int16_t argc_)
 
             m_pp = new_page_pointer;
             m_ip = -1;  // because we are doing a m_ip++ right after that
+#ifdef ARK_JIT
+            if (m_jit)
+                jitPageCall();
+#endif
             break;
         }
 
         default:
-            throwVMError("Can't call '" + m_state->m_symbols[m_last_sym_loaded] + "': it isn't a Function but a " + types_to_str[static_cast<int>(function.valueType())]);
+            throwVMError("Can't call '" + name() + "': it isn't a Function but a " + types_to_str[static_cast<int>(function.valueType())]);
     }
 
     // checking function arity
@@ -360,7 +500,7 @@ inline void VM::call(int16_t argc_)
 
     if (needed_argc != argc)
         throwVMError(
-            "Function '" + m_state->m_symbols[m_last_sym_loaded] + "' needs " + std::to_string(needed_argc) +
+            "Function '" + name() + "' needs " + std::to_string(needed_argc) +
             " arguments, but it received " + std::to_string(argc));
 
     COZ_END("ark vm::call");
@@ -0,0 +1,21 @@
+inline VM& VMPool::Handle::operator*() noexcept
+{
+    return *m_slot->vm;
+}
+
+inline VM* VMPool::Handle::operator->() noexcept
+{
+    return m_slot->vm.get();
+}
+
+template <typename... Args>
+Value VMPool::call(const std::string& name, Args&&... args)
+{
+    Handle vm = acquire();
+    return vm->call(name, std::forward<Args>(args)...);
+}
+
+inline std::size_t VMPool::size() const noexcept
+{
+    return m_size;
+}
@@ -18,14 +18,19 @@ inline double Value::number() const
     return std::get<double>(m_value);
 }
 
-inline const String& Value::string() const
+inline const internal::SharedString& Value::string() const
 {
-    return std::get<String>(m_value);
+    return std::get<internal::SharedString>(m_value);
 }
 
 inline const std::vector<Value>& Value::constList() const
 {
-    return std::get<std::vector<Value>>(m_value);
+    return std::get<internal::SharedList>(m_value).get();
+}
+
+inline const internal::SharedList& Value::listView() const
+{
+    return std::get<internal::SharedList>(m_value);
 }
 
 inline const UserType& Value::usertype() const
@@ -33,6 +38,21 @@ inline const UserType& Value::usertype() const
     return std::get<UserType>(m_value);
 }
 
+inline const internal::Dict& Value::dict() const
+{
+    return std::get<internal::Dict>(m_value);
+}
+
+inline const internal::Set& Value::set() const
+{
+    return std::get<internal::Set>(m_value);
+}
+
+inline const internal::Array& Value::array() const
+{
+    return std::get<internal::Array>(m_value);
+}
+
 // private getters
 
 inline internal::PageAddr_t Value::pageAddr() const
@@ -94,7 +114,7 @@ inline bool operator!(const Value& A) noexcept
     switch (A.valueType())
     {
         case ValueType::List:
-            return A.constList().empty();
+            return A.listView().empty();
 
         case ValueType::Number:
             return !A.number();
@@ -102,6 +122,15 @@ inline bool operator!(const Value& A) noexcept
         case ValueType::String:
             return A.string().size() == 0;
 
+        case ValueType::Dict:
+            return A.dict().size() == 0;
+
+        case ValueType::Set:
+            return A.set().size() == 0;
+
+        case ValueType::Array:
+            return A.array().size() == 0;
+
         case ValueType::User:
         case ValueType::Nil:
         case ValueType::False:
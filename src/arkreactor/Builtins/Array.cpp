@@ -0,0 +1,493 @@
+#include <cmath>
+#include <algorithm>
+
+#include <Ark/Builtins/Builtins.hpp>
+
+#include <Ark/Builtins/BuiltinsErrors.inl>
+#include <Ark/VM/VM.hpp>
+
+#if defined(__AVX__)
+#    include <immintrin.h>
+#    define ARK_ARRAY_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define ARK_ARRAY_SSE2
+#endif
+
+namespace Ark::internal::Builtins::Array
+{
+    namespace
+    {
+        // Operations on packs of 4 doubles with AVX, 2 with SSE2. Without them, the kernels only run
+        // their scalar loop, which is also used for the elements after the last full pack
+#if defined(ARK_ARRAY_AVX)
+#    define ARK_ARRAY_SIMD
+        namespace simd
+        {
+            using Pack = __m256d;
+            constexpr std::size_t Size = 4;
+
+            inline Pack load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+            inline void store(double* p, Pack a) noexcept { _mm256_storeu_pd(p, a); }
+            inline Pack broadcast(double d) noexcept { return _mm256_set1_pd(d); }
+            inline Pack add(Pack a, Pack b) noexcept { return _mm256_add_pd(a, b); }
+            inline Pack mul(Pack a, Pack b) noexcept { return _mm256_mul_pd(a, b); }
+            inline Pack min(Pack a, Pack b) noexcept { return _mm256_min_pd(a, b); }
+            inline Pack max(Pack a, Pack b) noexcept { return _mm256_max_pd(a, b); }
+
+            // the halves of the pack are combined with an SSE2 operation, then the two remaining doubles
+            template <typename Op>
+            inline double reduce(Pack a, Op op) noexcept
+            {
+                __m128d half = op(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+                return _mm_cvtsd_f64(op(half, _mm_unpackhi_pd(half, half)));
+            }
+
+            inline double sum(Pack a) noexcept { return reduce(a, [](__m128d x, __m128d y) { return _mm_add_pd(x, y); }); }
+            inline double min(Pack a) noexcept { return reduce(a, [](__m128d x, __m128d y) { return _mm_min_pd(x, y); }); }
+            inline double max(Pack a) noexcept { return reduce(a, [](__m128d x, __m128d y) { return _mm_max_pd(x, y); }); }
+        }
+#elif defined(ARK_ARRAY_SSE2)
+#    define ARK_ARRAY_SIMD
+        namespace simd
+        {
+            using Pack = __m128d;
+            constexpr std::size_t Size = 2;
+
+            inline Pack load(const double* p) noexcept { return _mm_loadu_pd(p); }
+            inline void store(double* p, Pack a) noexcept { _mm_storeu_pd(p, a); }
+            inline Pack broadcast(double d) noexcept { return _mm_set1_pd(d); }
+            inline Pack add(Pack a, Pack b) noexcept { return _mm_add_pd(a, b); }
+            inline Pack mul(Pack a, Pack b) noexcept { return _mm_mul_pd(a, b); }
+            inline Pack min(Pack a, Pack b) noexcept { return _mm_min_pd(a, b); }
+            inline Pack max(Pack a, Pack b) noexcept { return _mm_max_pd(a, b); }
+
+            inline double sum(Pack a) noexcept { return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a))); }
+            inline double min(Pack a) noexcept { return _mm_cvtsd_f64(_mm_min_sd(a, _mm_unpackhi_pd(a, a))); }
+            inline double max(Pack a) noexcept { return _mm_cvtsd_f64(_mm_max_sd(a, _mm_unpackhi_pd(a, a))); }
+        }
+#endif
+
+        // the sums use two accumulators to hide the latency of the additions,
+        // thus the order of the additions isn't the one of a scalar loop
+
+        double sumKernel(const double* a, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            double result = 0.0;
+#ifdef ARK_ARRAY_SIMD
+            if (n >= 2 * simd::Size)
+            {
+                simd::Pack acc0 = simd::broadcast(0.0), acc1 = simd::broadcast(0.0);
+                for (; i + 2 * simd::Size <= n; i += 2 * simd::Size)
+                {
+                    acc0 = simd::add(acc0, simd::load(a + i));
+                    acc1 = simd::add(acc1, simd::load(a + i + simd::Size));
+                }
+                result = simd::sum(simd::add(acc0, acc1));
+            }
+#endif
+            for (; i < n; ++i)
+                result += a[i];
+            return result;
+        }
+
+        double dotKernel(const double* a, const double* b, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            double result = 0.0;
+#ifdef ARK_ARRAY_SIMD
+            if (n >= 2 * simd::Size)
+            {
+                simd::Pack acc0 = simd::broadcast(0.0), acc1 = simd::broadcast(0.0);
+                for (; i + 2 * simd::Size <= n; i += 2 * simd::Size)
+                {
+                    acc0 = simd::add(acc0, simd::mul(simd::load(a + i), simd::load(b + i)));
+                    acc1 = simd::add(acc1, simd::mul(simd::load(a + i + simd::Size), simd::load(b + i + simd::Size)));
+                }
+                result = simd::sum(simd::add(acc0, acc1));
+            }
+#endif
+            for (; i < n; ++i)
+                result += a[i] * b[i];
+            return result;
+        }
+
+        // n must be greater than 0
+        double minKernel(const double* a, std::size_t n) noexcept
+        {
+            std::size_t i = 1;
+            double result = a[0];
+#ifdef ARK_ARRAY_SIMD
+            if (n >= simd::Size)
+            {
+                simd::Pack acc = simd::load(a);
+                for (i = simd::Size; i + simd::Size <= n; i += simd::Size)
+                    acc = simd::min(acc, simd::load(a + i));
+                result = simd::min(acc);
+            }
+#endif
+            for (; i < n; ++i)
+                result = std::min(result, a[i]);
+            return result;
+        }
+
+        // n must be greater than 0
+        double maxKernel(const double* a, std::size_t n) noexcept
+        {
+            std::size_t i = 1;
+            double result = a[0];
+#ifdef ARK_ARRAY_SIMD
+            if (n >= simd::Size)
+            {
+                simd::Pack acc = simd::load(a);
+                for (i = simd::Size; i + simd::Size <= n; i += simd::Size)
+                    acc = simd::max(acc, simd::load(a + i));
+                result = simd::max(acc);
+            }
+#endif
+            for (; i < n; ++i)
+                result = std::max(result, a[i]);
+            return result;
+        }
+
+        // the elementwise kernels can write in one of their inputs
+
+        void scaleKernel(double* out, const double* a, double k, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+#ifdef ARK_ARRAY_SIMD
+            const simd::Pack factor = simd::broadcast(k);
+            for (; i + simd::Size <= n; i += simd::Size)
+                simd::store(out + i, simd::mul(simd::load(a + i), factor));
+#endif
+            for (; i < n; ++i)
+                out[i] = a[i] * k;
+        }
+
+        void shiftKernel(double* out, const double* a, double k, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+#ifdef ARK_ARRAY_SIMD
+            const simd::Pack offset = simd::broadcast(k);
+            for (; i + simd::Size <= n; i += simd::Size)
+                simd::store(out + i, simd::add(simd::load(a + i), offset));
+#endif
+            for (; i < n; ++i)
+                out[i] = a[i] + k;
+        }
+
+        void addKernel(double* out, const double* a, const double* b, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+#ifdef ARK_ARRAY_SIMD
+            for (; i + simd::Size <= n; i += simd::Size)
+                simd::store(out + i, simd::add(simd::load(a + i), simd::load(b + i)));
+#endif
+            for (; i < n; ++i)
+                out[i] = a[i] + b[i];
+        }
+
+        using MathFunction = double (*)(double);
+
+        /**
+         * @brief Find the C++ function computing the same thing as a math:* builtin, to call it without creating Values
+         *
+         * @param builtin
+         * @return MathFunction nullptr if it isn't a math builtin returning a Number
+         */
+        MathFunction nativeMathFunction(const Value& builtin) noexcept
+        {
+            static const std::pair<Value, MathFunction> functions[] = {
+                { Value(Mathematics::exponential), [](double x) { return std::exp(x); } },
+                { Value(Mathematics::logarithm), [](double x) { return std::log(x); } },
+                { Value(Mathematics::ceil_), [](double x) { return std::ceil(x); } },
+                { Value(Mathematics::floor_), [](double x) { return std::floor(x); } },
+                { Value(Mathematics::round_), [](double x) { return std::round(x); } },
+                { Value(Mathematics::cos_), [](double x) { return std::cos(x); } },
+                { Value(Mathematics::sin_), [](double x) { return std::sin(x); } },
+                { Value(Mathematics::tan_), [](double x) { return std::tan(x); } },
+                { Value(Mathematics::acos_), [](double x) { return std::acos(x); } },
+                { Value(Mathematics::asin_), [](double x) { return std::asin(x); } },
+                { Value(Mathematics::atan_), [](double x) { return std::atan(x); } },
+                { Value(Mathematics::cosh_), [](double x) { return std::cosh(x); } },
+                { Value(Mathematics::sinh_), [](double x) { return std::sinh(x); } },
+                { Value(Mathematics::tanh_), [](double x) { return std::tanh(x); } },
+                { Value(Mathematics::acosh_), [](double x) { return std::acosh(x); } },
+                { Value(Mathematics::asinh_), [](double x) { return std::asinh(x); } },
+                { Value(Mathematics::atanh_), [](double x) { return std::atanh(x); } }
+            };
+
+            for (const auto& [value, function] : functions)
+            {
+                if (value == builtin)
+                    return function;
+            }
+            return nullptr;
+        }
+    }
+
+    /**
+     * @name array:fromList
+     * @brief Create an Array from a List of Numbers
+     * @details An Array stores 8 bytes per number, and the array:* functions process it with vector instructions
+     * @param list the List
+     * =begin
+     * (array:fromList [1 2 3])  # #[1 2 3]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value fromList(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ARRAY_FROMLIST_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(ARRAY_FROMLIST_TE0);
+
+        std::vector<double> data;
+        data.reserve(n[0].listView().size());
+        for (const Value& value : n[0].listView())
+        {
+            if (value.valueType() != ValueType::Number)
+                throw Ark::TypeError(ARRAY_FROMLIST_TE0);
+            data.push_back(value.number());
+        }
+
+        return Value(internal::Array(std::move(data)));
+    }
+
+    /**
+     * @name array:toList
+     * @brief Get the numbers of an Array as a List
+     * @param array the Array
+     * =begin
+     * (array:toList (array:fromList [1 2 3]))  # [1 2 3]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value toList(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ARRAY_TOLIST_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_TOLIST_TE0);
+
+        std::vector<Value> list;
+        list.reserve(n[0].array().size());
+        for (double d : n[0].array().get())
+            list.emplace_back(d);
+
+        return Value(std::move(list));
+    }
+
+    /**
+     * @name array:sum
+     * @brief Compute the sum of the numbers of an Array
+     * @details The numbers aren't added from the first to the last, thus the rounding can differ a bit from a loop over a List
+     * @param array the Array
+     * =begin
+     * (array:sum (array:fromList [1 2 3]))  # 6
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value sum(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ARRAY_SUM_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_SUM_TE0);
+
+        const std::vector<double>& data = n[0].array().get();
+        return Value(sumKernel(data.data(), data.size()));
+    }
+
+    /**
+     * @name array:dot
+     * @brief Compute the dot product of two Arrays of the same size
+     * @param a the first Array
+     * @param b the second Array
+     * =begin
+     * (array:dot (array:fromList [1 2 3]) (array:fromList [4 5 6]))  # 32
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value dot(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(ARRAY_DOT_ARITY);
+        if (n[0].valueType() != ValueType::Array || n[1].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_DOT_TE);
+
+        const std::vector<double>&a = n[0].array().get(), &b = n[1].array().get();
+        if (a.size() != b.size())
+            throw std::runtime_error(ARRAY_DOT_SIZE);
+
+        return Value(dotKernel(a.data(), b.data(), a.size()));
+    }
+
+    /**
+     * @name array:min
+     * @brief Get the smallest number of a non empty Array
+     * @param array the Array
+     * =begin
+     * (array:min (array:fromList [3 1 2]))  # 1
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value min_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ARRAY_MIN_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_MIN_TE0);
+
+        const std::vector<double>& data = n[0].array().get();
+        if (data.empty())
+            throw std::runtime_error(ARRAY_MIN_EMPTY);
+
+        return Value(minKernel(data.data(), data.size()));
+    }
+
+    /**
+     * @name array:max
+     * @brief Get the greatest number of a non empty Array
+     * @param array the Array
+     * =begin
+     * (array:max (array:fromList [3 1 2]))  # 3
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value max_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ARRAY_MAX_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_MAX_TE0);
+
+        const std::vector<double>& data = n[0].array().get();
+        if (data.empty())
+            throw std::runtime_error(ARRAY_MAX_EMPTY);
+
+        return Value(maxKernel(data.data(), data.size()));
+    }
+
+    /**
+     * @name array:scale
+     * @brief Multiply the numbers of an Array by a factor
+     * @details The given Array is not modified
+     * @param array the Array
+     * @param factor the Number
+     * =begin
+     * (array:scale (array:fromList [1 2 3]) 2)  # #[2 4 6]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value scale(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(ARRAY_SCALE_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_SCALE_TE0);
+        if (n[1].valueType() != ValueType::Number)
+            throw Ark::TypeError(ARRAY_SCALE_TE1);
+
+        // the buffer of a temporary array is reused, otherwise it's copied by mut()
+        Value r = std::move(n[0]);
+        std::vector<double>& data = r.arrayRef().mut();
+        scaleKernel(data.data(), data.data(), n[1].number(), data.size());
+
+        return r;
+    }
+
+    /**
+     * @name array:add
+     * @brief Add two Arrays of the same size elementwise, or a Number to each element of an Array
+     * @details The given Arrays are not modified
+     * @param a the Array
+     * @param b an Array or a Number
+     * =begin
+     * (array:add (array:fromList [1 2 3]) (array:fromList [4 5 6]))  # #[5 7 9]
+     * (array:add (array:fromList [1 2 3]) 1)  # #[2 3 4]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value add(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(ARRAY_ADD_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_ADD_TE0);
+        if (n[1].valueType() != ValueType::Array && n[1].valueType() != ValueType::Number)
+            throw Ark::TypeError(ARRAY_ADD_TE1);
+        if (n[1].valueType() == ValueType::Array && n[0].array().size() != n[1].array().size())
+            throw std::runtime_error(ARRAY_ADD_SIZE);
+
+        Value r = std::move(n[0]);
+        std::vector<double>& data = r.arrayRef().mut();
+        if (n[1].valueType() == ValueType::Number)
+            shiftKernel(data.data(), data.data(), n[1].number(), data.size());
+        else
+            addKernel(data.data(), data.data(), n[1].array().get().data(), data.size());
+
+        return r;
+    }
+
+    /**
+     * @name array:map
+     * @brief Apply a math function to each number of an Array
+     * @details The function is computed directly on the numbers, without calling the builtin for each of them.
+     *          The given Array is not modified
+     * @param array the Array
+     * @param function a math:* function returning a Number, like math:cos
+     * =begin
+     * (array:map (array:fromList [0 math:pi]) math:cos)  # #[1 -1]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value map(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(ARRAY_MAP_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_MAP_TE0);
+
+        MathFunction function = nativeMathFunction(n[1]);
+        if (function == nullptr)
+            throw Ark::TypeError(ARRAY_MAP_TE1);
+        // same check as math:ln
+        if (n[1] == Value(Mathematics::logarithm) && std::any_of(n[0].array().get().begin(), n[0].array().get().end(), [](double d) { return d <= 0.0; }))
+            throw std::runtime_error("Argument of math:log must be greater than 0");
+
+        Value r = std::move(n[0]);
+        std::vector<double>& data = r.arrayRef().mut();
+        std::transform(data.begin(), data.end(), data.begin(), function);
+
+        return r;
+    }
+
+    /**
+     * @name array:sort
+     * @brief Sort the numbers of an Array in ascending order
+     * @details NaN are put at the end. The given Array is not modified
+     * @param array the Array
+     * =begin
+     * (array:sort (array:fromList [3 1 2]))  # #[1 2 3]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value sort_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ARRAY_SORT_ARITY);
+        if (n[0].valueType() != ValueType::Array)
+            throw Ark::TypeError(ARRAY_SORT_TE0);
+
+        Value r = std::move(n[0]);
+        std::vector<double>& data = r.arrayRef().mut();
+        // NaN can't be compared, they would break the ordering needed by std::sort
+        auto nan = std::partition(data.begin(), data.end(), [](double d) { return !std::isnan(d); });
+        std::sort(data.begin(), nan);
+
+        return r;
+    }
+}
@@ -0,0 +1,73 @@
+#include <Ark/Builtins/Builtins.hpp>
+
+#include <Ark/Builtins/BuiltinsErrors.inl>
+#include <Ark/VM/VM.hpp>
+
+namespace Ark::internal::Builtins::Async
+{
+    /**
+     * @name async
+     * @brief Call a function in a new coroutine, which runs when the current one is suspended
+     * @details Return the id of the coroutine, to give to await. The coroutines all run on the thread of the VM:
+     *          they switch on yield, await and sys:sleep
+     * @param function the function to call
+     * @param args... the arguments of the function
+     * =begin
+     * (let task (async (fun (a b) (+ a b)) 1 2))
+     * (print (await task))  # 3
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value async_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.empty())
+            throw std::runtime_error(ASYNC_ASYNC_ARITY);
+        if (!n[0].isFunction())
+            throw Ark::TypeError(ASYNC_ASYNC_TE0);
+
+        std::vector<Value> args(std::make_move_iterator(n.begin() + 1), std::make_move_iterator(n.end()));
+        return Value(static_cast<double>(vm->startCoroutine(n[0], std::move(args))));
+    }
+
+    /**
+     * @name await
+     * @brief Wait for a coroutine to finish and return its result
+     * @details The current coroutine is suspended until then, the other ones run in the meantime.
+     *          A coroutine can be awaited only once
+     * @param task the id returned by async
+     * =begin
+     * (let task (async (fun () { (sys:sleep 100) 12 })))
+     * (print (await task))  # 12
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value await_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(ASYNC_AWAIT_ARITY);
+        if (n[0].valueType() != ValueType::Number)
+            throw Ark::TypeError(ASYNC_AWAIT_TE0);
+
+        return vm->awaitCoroutine(static_cast<uint32_t>(n[0].number()));
+    }
+
+    /**
+     * @name yield
+     * @brief Let the other coroutines run, the current one is resumed after them
+     * @details Return nil. Does nothing if no other coroutine is ready to run
+     * =begin
+     * (async (fun () (print "second")))
+     * (yield)
+     * (print "third")
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value yield_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (!n.empty())
+            throw std::runtime_error(ASYNC_YIELD_ARITY);
+
+        vm->yieldCoroutine();
+        return nil;
+    }
+}
@@ -85,7 +85,52 @@ namespace Ark::internal::Builtins
         { "math:tanh", Value(Mathematics::tanh_) },
         { "math:acosh", Value(Mathematics::acosh_) },
         { "math:asinh", Value(Mathematics::asinh_) },
-        { "math:atanh", Value(Mathematics::atanh_) }
+        { "math:atanh", Value(Mathematics::atanh_) },
+
+        // Dict
+        { "dict", Value(Dict::dict) },
+        { "dict:get", Value(Dict::get) },
+        { "dict:set", Value(Dict::set) },
+        { "dict:remove", Value(Dict::remove) },
+        { "dict:contains?", Value(Dict::contains) },
+        { "dict:keys", Value(Dict::keys) },
+        { "dict:size", Value(Dict::size) },
+
+        // Set
+        { "set:new", Value(Set::new_) },
+        { "set:fromList", Value(Set::fromList) },
+        { "set:toList", Value(Set::toList) },
+        { "set:contains?", Value(Set::contains) },
+        { "set:add", Value(Set::add) },
+        { "set:remove", Value(Set::remove) },
+        { "set:size", Value(Set::size) },
+        { "set:union", Value(Set::union_) },
+        { "set:intersection", Value(Set::intersection) },
+        { "set:difference", Value(Set::difference) },
+
+        // Array
+        { "array:fromList", Value(Array::fromList) },
+        { "array:toList", Value(Array::toList) },
+        { "array:sum", Value(Array::sum) },
+        { "array:dot", Value(Array::dot) },
+        { "array:min", Value(Array::min_) },
+        { "array:max", Value(Array::max_) },
+        { "array:scale", Value(Array::scale) },
+        { "array:add", Value(Array::add) },
+        { "array:map", Value(Array::map) },
+        { "array:sort", Value(Array::sort_) },
+
+        // List, continued
+        { "list:sortBy", Value(List::sortBy) },
+        { "list:map", Value(List::map_) },
+        { "list:filter", Value(List::filter) },
+        { "list:reduce", Value(List::reduce) },
+        { "list:pmap", Value(List::pmap) },
+
+        // Coroutines
+        { "async", Value(Async::async_) },
+        { "await", Value(Async::await_) },
+        { "yield", Value(Async::yield_) }
     };
 
     // This list is related to include/Ark/Compiler/Instructions.hpp
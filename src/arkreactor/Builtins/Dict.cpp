@@ -0,0 +1,176 @@
+#include <Ark/Builtins/Builtins.hpp>
+
+#include <Ark/Builtins/BuiltinsErrors.inl>
+#include <Ark/VM/VM.hpp>
+
+namespace Ark::internal::Builtins::Dict
+{
+    /**
+     * @name dict
+     * @brief Create a Dict from keys and values
+     * @details Keys must be Numbers or Strings
+     * @param key first key
+     * @param value its value
+     * @param ... more keys and values
+     * =begin
+     * (dict "a" 1 "b" 2)  # {"a": 1, "b": 2}
+     * (dict)  # {}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value dict(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() % 2 != 0)
+            throw std::runtime_error(DICT_ARITY);
+
+        internal::Dict d;
+        for (std::size_t i = 0, end = n.size(); i < end; i += 2)
+        {
+            if (!internal::Dict::isHashable(n[i]))
+                throw Ark::TypeError(DICT_TE0);
+            d.set(n[i], n[i + 1]);
+        }
+
+        return Value(std::move(d));
+    }
+
+    /**
+     * @name dict:get
+     * @brief Get the value associated to a key
+     * @param dict the Dict to search in
+     * @param key the key to search
+     * @param default optional, returned if the key isn't in the Dict (nil by default)
+     * =begin
+     * (dict:get (dict "a" 1) "a")  # 1
+     * (dict:get (dict "a" 1) "b")  # nil
+     * (dict:get (dict "a" 1) "b" 0)  # 0
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value get(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2 && n.size() != 3)
+            throw std::runtime_error(DICT_GET_ARITY);
+        if (n[0].valueType() != ValueType::Dict)
+            throw Ark::TypeError(DICT_GET_TE0);
+        if (!internal::Dict::isHashable(n[1]))
+            throw Ark::TypeError(DICT_GET_TE1);
+
+        if (const Value* value = n[0].dict().get(n[1]); value != nullptr)
+            return *value;
+        return (n.size() == 3) ? n[2] : nil;
+    }
+
+    /**
+     * @name dict:set
+     * @brief Associate a value to a key and return a new Dict
+     * @details The original Dict is not modified, use dict:set! to modify it in place
+     * @param dict the Dict to modify
+     * @param key the key, a Number or a String
+     * @param value the new value
+     * =begin
+     * (dict:set (dict "a" 1) "b" 2)  # {"a": 1, "b": 2}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value set(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 3)
+            throw std::runtime_error(DICT_SET_ARITY);
+        if (n[0].valueType() != ValueType::Dict)
+            throw Ark::TypeError(DICT_SET_TE0);
+        if (!internal::Dict::isHashable(n[1]))
+            throw Ark::TypeError(DICT_SET_TE1);
+
+        n[0].dictRef().set(n[1], n[2]);
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name dict:remove
+     * @brief Remove a key and return a new Dict
+     * @details The original Dict is not modified, use dict:remove! to modify it in place
+     * @param dict the Dict to modify
+     * @param key the key to remove
+     * =begin
+     * (dict:remove (dict "a" 1 "b" 2) "a")  # {"b": 2}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value remove(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(DICT_REMOVE_ARITY);
+        if (n[0].valueType() != ValueType::Dict)
+            throw Ark::TypeError(DICT_REMOVE_TE0);
+        if (!internal::Dict::isHashable(n[1]))
+            throw Ark::TypeError(DICT_REMOVE_TE1);
+
+        n[0].dictRef().remove(n[1]);
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name dict:contains?
+     * @brief Check if a key is in a Dict
+     * @param dict the Dict to search in
+     * @param key the key to search
+     * =begin
+     * (dict:contains? (dict "a" 1) "a")  # true
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value contains(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(DICT_CONTAINS_ARITY);
+        if (n[0].valueType() != ValueType::Dict)
+            throw Ark::TypeError(DICT_CONTAINS_TE0);
+
+        return (n[0].dict().get(n[1]) != nullptr) ? trueSym : falseSym;
+    }
+
+    /**
+     * @name dict:keys
+     * @brief Get the keys of a Dict, in insertion order
+     * @details When a key is removed, the last inserted key takes its place
+     * @param dict the Dict
+     * =begin
+     * (dict:keys (dict "a" 1 "b" 2))  # ["a" "b"]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value keys(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(DICT_KEYS_ARITY);
+        if (n[0].valueType() != ValueType::Dict)
+            throw Ark::TypeError(DICT_KEYS_TE0);
+
+        std::vector<Value> keys;
+        keys.reserve(n[0].dict().size());
+        for (const internal::Dict::Entry& entry : n[0].dict().entries())
+            keys.push_back(entry.key);
+
+        return Value(std::move(keys));
+    }
+
+    /**
+     * @name dict:size
+     * @brief Get the number of keys in a Dict
+     * @param dict the Dict
+     * =begin
+     * (dict:size (dict "a" 1 "b" 2))  # 2
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value size(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(DICT_SIZE_ARITY);
+        if (n[0].valueType() != ValueType::Dict)
+            throw Ark::TypeError(DICT_SIZE_TE0);
+
+        return Value(static_cast<int>(n[0].dict().size()));
+    }
+}
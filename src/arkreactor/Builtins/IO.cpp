@@ -8,6 +8,10 @@
 #include <Ark/VM/VM.hpp>
 #include <Ark/Builtins/BuiltinsErrors.inl>
 
+#ifdef ARK_OS_LINUX
+#    include <unistd.h>
+#endif
+
 namespace Ark::internal::Builtins::IO
 {
     /**
@@ -50,7 +54,7 @@ namespace Ark::internal::Builtins::IO
     /**
      * @name input
      * @brief Request a value from the user
-     * @details Return the value as a string
+     * @details Return the value as a string. When other coroutines exist, they run until a line is available
      * @param prompt (optional) printed before asking for the user input
      * =begin
      * (input "put a number> ")
@@ -66,10 +70,31 @@ namespace Ark::internal::Builtins::IO
             std::printf("%s", n[0].string().c_str());
         }
 
-        std::string line = "";
-        std::getline(std::cin, line);
+        // a line read ahead by std::cin is available without waiting
+        if (std::cin.rdbuf()->in_avail() > 0)
+        {
+            std::string line = "";
+            std::getline(std::cin, line);
+            return Value(line);
+        }
+
+        auto read = []() {
+            std::string line = "";
+#ifdef ARK_OS_LINUX
+            // poll can't see what a buffer read ahead, the line is read a character at a time
+            char c;
+            while (::read(0, &c, 1) == 1 && c != '\n')
+                line += c;
+#else
+            std::getline(std::cin, line);
+#endif
+            return Value(line);
+        };
 
-        return Value(line);
+        // the other coroutines can run until a line is available
+        if (vm != nullptr && vm->readCoroutine(0, read))
+            return nil;
+        return read();
     }
 
     /**
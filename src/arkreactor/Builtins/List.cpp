@@ -2,12 +2,146 @@
 
 #include <iterator>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
 
 #include <Ark/Builtins/BuiltinsErrors.inl>
 #include <Ark/VM/VM.hpp>
 
 namespace Ark::internal::Builtins::List
 {
+    namespace
+    {
+        // under this size, the keys are sorted with std::stable_sort instead of a radix sort
+        constexpr std::size_t RadixThreshold = 256;
+
+        struct NumberKey
+        {
+            uint64_t bits;
+            uint32_t index;
+        };
+
+        /**
+         * @brief Get the bits of a double, transformed so that they are ordered like the doubles when compared as integers
+         *
+         * @param d
+         * @return uint64_t
+         */
+        inline uint64_t orderedBits(double d) noexcept
+        {
+            constexpr uint64_t sign = 1ULL << 63;
+
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(double));
+            // negative numbers are ordered backward, and before the positive ones
+            return (bits & sign) ? ~bits : (bits | sign);
+        }
+
+        /**
+         * @brief Stable LSD radix sort of the numbers, 11 bits at a time, skipping the digits shared by all the keys
+         *
+         * @param keys
+         * @param order indices of the keys, in ascending order of the keys
+         */
+        void sortNumbers(const Value* keys, std::vector<uint32_t>& order)
+        {
+            constexpr std::size_t DigitBits = 11;
+            constexpr std::size_t Digits = (64 + DigitBits - 1) / DigitBits;
+            constexpr uint64_t DigitMask = (1 << DigitBits) - 1;
+
+            const std::size_t size = order.size();
+            std::vector<NumberKey> sorted(size);
+            for (uint32_t i = 0; i < size; ++i)
+                sorted[i] = NumberKey { orderedBits(keys[i].number()), i };
+
+            if (size < RadixThreshold)
+                std::stable_sort(sorted.begin(), sorted.end(), [](const NumberKey& a, const NumberKey& b) { return a.bits < b.bits; });
+            else
+            {
+                std::vector<std::array<uint32_t, 1 << DigitBits>> counts(Digits);
+                for (const NumberKey& key : sorted)
+                {
+                    for (std::size_t digit = 0; digit < Digits; ++digit)
+                        ++counts[digit][(key.bits >> (DigitBits * digit)) & DigitMask];
+                }
+
+                std::vector<NumberKey> buffer(size);
+                for (std::size_t digit = 0; digit < Digits; ++digit)
+                {
+                    const std::size_t shift = DigitBits * digit;
+                    std::array<uint32_t, 1 << DigitBits>& count = counts[digit];
+                    if (count[(sorted[0].bits >> shift) & DigitMask] == size)
+                        continue;
+
+                    uint32_t offset = 0;
+                    for (uint32_t& c : count)
+                        offset += std::exchange(c, offset);
+
+                    for (const NumberKey& key : sorted)
+                        buffer[count[(key.bits >> shift) & DigitMask]++] = key;
+                    sorted.swap(buffer);
+                }
+            }
+
+            for (std::size_t i = 0; i < size; ++i)
+                order[i] = sorted[i].index;
+        }
+
+        /**
+         * @brief Compute the order in which the keys are sorted, without moving them
+         * @details Lists of Numbers and lists of Strings are sorted without going through Value::operator<
+         *
+         * @param keys
+         * @param size
+         * @return std::vector<uint32_t> indices of the keys, in ascending order of the keys. Equal keys keep their order
+         */
+        std::vector<uint32_t> sortedOrder(const Value* keys, std::size_t size)
+        {
+            std::vector<uint32_t> order(size);
+            for (uint32_t i = 0; i < size; ++i)
+                order[i] = i;
+            if (size < 2)
+                return order;
+
+            auto homogeneous = [keys, size](ValueType type) {
+                return std::all_of(keys, keys + size, [type](const Value& key) { return key.valueType() == type; });
+            };
+
+            if (homogeneous(ValueType::Number))
+                sortNumbers(keys, order);
+            else if (homogeneous(ValueType::String))
+            {
+                std::vector<std::pair<std::string_view, uint32_t>> sorted(size);
+                for (uint32_t i = 0; i < size; ++i)
+                    sorted[i] = { keys[i].string().view(), i };
+
+                std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                for (std::size_t i = 0; i < size; ++i)
+                    order[i] = sorted[i].second;
+            }
+            else
+                std::stable_sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+            return order;
+        }
+
+        /**
+         * @brief Move the elements of a list in the given order
+         *
+         * @param list
+         * @param order
+         */
+        void applyOrder(std::vector<Value>& list, const std::vector<uint32_t>& order)
+        {
+            std::vector<Value> sorted;
+            sorted.reserve(list.size());
+            for (uint32_t i : order)
+                sorted.push_back(std::move(list[i]));
+            list = std::move(sorted);
+        }
+    }
+
     /**
      * @name list:reverse
      * @brief Reverse a given list and return a new one
@@ -27,7 +161,7 @@ namespace Ark::internal::Builtins::List
 
         std::reverse(n[0].list().begin(), n[0].list().end());
 
-        return n[0];
+        return std::move(n[0]);
     }
 
     /**
@@ -49,11 +183,11 @@ namespace Ark::internal::Builtins::List
         if (n[0].valueType() != ValueType::List)
             throw Ark::TypeError(LIST_FIND_TE0);
 
-        std::vector<Value>& l = n[0].list();
-        for (Value::Iterator it = l.begin(), it_end = l.end(); it != it_end; ++it)
+        const internal::SharedList& l = n[0].listView();
+        for (const Value *it = l.begin(), *it_end = l.end(); it != it_end; ++it)
         {
             if (*it == n[1])
-                return Value(static_cast<int>(std::distance<Value::Iterator>(l.begin(), it)));
+                return Value(static_cast<int>(std::distance(l.begin(), it)));
         }
 
         return Value(-1);
@@ -88,11 +222,11 @@ namespace Ark::internal::Builtins::List
             throw Ark::TypeError(LIST_RMAT_TE1);
 
         std::size_t idx = static_cast<std::size_t>(n[1].number());
-        if (idx >= n[0].list().size())
+        if (idx >= n[0].listView().size())
             throw std::runtime_error(LIST_RMAT_OOR);
 
         n[0].list().erase(n[0].list().begin() + idx);
-        return n[0];
+        return std::move(n[0]);
     }
 
     /**
@@ -130,12 +264,17 @@ namespace Ark::internal::Builtins::List
 
         if (start > end)
             throw std::runtime_error(LIST_SLICE_ORDER);
-        if (start < 0 || end > n[0].list().size())
+        const internal::SharedList& list = n[0].listView();
+        if (start < 0 || end > list.size())
             throw std::runtime_error(LIST_SLICE_OOR);
 
+        // contiguous slices share the elements of the list
+        if (step == 1)
+            return Value(list.view(start, end - start));
+
         std::vector<Value> retlist;
         for (std::size_t i = start; i < end; i += step)
-            retlist.push_back(n[0].list()[i]);
+            retlist.push_back(list[i]);
 
         return Value(std::move(retlist));
     }
@@ -143,7 +282,7 @@ namespace Ark::internal::Builtins::List
     /**
      * @name list:sort
      * @brief Sort a List and return a new one
-     * @details The original list is not modified
+     * @details The original list is not modified. The sort is stable, and faster on lists of Numbers or of Strings
      * @param list the list to sort
      * =begin
      * (list:sort [4 2 3])  # [1 2 4]
@@ -157,8 +296,151 @@ namespace Ark::internal::Builtins::List
         if (n[0].valueType() != ValueType::List)
             throw Ark::TypeError(LIST_SORT_TE0);
 
-        std::sort(n[0].list().begin(), n[0].list().end());
-        return n[0];
+        std::vector<Value>& list = n[0].list();
+        applyOrder(list, sortedOrder(list.data(), list.size()));
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name list:sortBy
+     * @brief Sort a List by the keys computed by a function, and return a new one
+     * @details The function is called once per element. The original list is not modified, and the sort is stable
+     * @param list the list to sort
+     * @param key the function computing the key of an element
+     * =begin
+     * (list:sortBy ["abc" "d" "ef"] (fun (e) (len e)))  # ["d" "ef" "abc"]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value sortBy(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(LIST_SORTBY_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(LIST_SORTBY_TE0);
+        if (!n[1].isFunction())
+            throw Ark::TypeError(LIST_SORTBY_TE1);
+
+        std::vector<Value>& list = n[0].list();
+        std::vector<Value> keys;
+        keys.reserve(list.size());
+        for (const Value& element : list)
+            keys.push_back(vm->callback(n[1], element));
+
+        applyOrder(list, sortedOrder(keys.data(), keys.size()));
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name list:map
+     * @brief Apply a function to each element of a List, and return a new one with the results
+     * @details The original list is not modified
+     * @param list the list
+     * @param function the function to apply
+     * =begin
+     * (list:map [1 2 3] (fun (e) (* e 2)))  # [2 4 6]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value map_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(LIST_MAP_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(LIST_MAP_TE0);
+        if (!n[1].isFunction())
+            throw Ark::TypeError(LIST_MAP_TE1);
+
+        for (Value& element : n[0].list())
+            element = vm->callback(n[1], element);
+
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name list:filter
+     * @brief Get the elements of a List for which a function returns true
+     * @details The original list is not modified
+     * @param list the list
+     * @param predicate the function to call on each element
+     * =begin
+     * (list:filter [1 2 3 4] (fun (e) (= 0 (mod e 2))))  # [2 4]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value filter(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(LIST_FILTER_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(LIST_FILTER_TE0);
+        if (!n[1].isFunction())
+            throw Ark::TypeError(LIST_FILTER_TE1);
+
+        std::vector<Value>& list = n[0].list();
+        std::vector<Value> output;
+        for (Value& element : list)
+        {
+            if (vm->callback(n[1], element) == Builtins::trueSym)
+                output.push_back(std::move(element));
+        }
+        list = std::move(output);
+
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name list:reduce
+     * @brief Combine the elements of a non empty List with a function, from the first to the last
+     * @param list the list
+     * @param function the function taking the value accumulated so far and the next element
+     * =begin
+     * (list:reduce [1 2 3] (fun (a b) (+ a b)))  # 6
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value reduce(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(LIST_REDUCE_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(LIST_REDUCE_TE0);
+        if (!n[1].isFunction())
+            throw Ark::TypeError(LIST_REDUCE_TE1);
+        if (n[0].listView().empty())
+            throw std::runtime_error(LIST_REDUCE_EMPTY);
+
+        const internal::SharedList& list = n[0].listView();
+        Value output = list[0];
+        for (std::size_t i = 1, end = list.size(); i < end; ++i)
+            output = vm->callback(n[1], output, list[i]);
+
+        return output;
+    }
+
+    /**
+     * @name list:pmap
+     * @brief Apply a function to each element of a List on multiple threads, and return a new List with the results
+     * @details Each thread runs its own virtual machine, with copies of the elements and of the variables
+     *          which are never modified. The function can not capture variables modified by the program, and
+     *          can not call sys:exit
+     * @param list the list
+     * @param function the function to apply
+     * =begin
+     * (list:pmap [1 2 3] (fun (e) (* e 2)))  # [2 4 6]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value pmap(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(LIST_PMAP_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(LIST_PMAP_TE0);
+        if (!n[1].isFunction())
+            throw Ark::TypeError(LIST_PMAP_TE1);
+
+        return Value(vm->parallelMap(n[1], n[0].listView().get()));
     }
 
     /**
@@ -208,6 +490,6 @@ namespace Ark::internal::Builtins::List
             throw Ark::TypeError(LIST_SETAT_TE1);
 
         n[0].list()[static_cast<std::size_t>(n[1].number())] = n[2];
-        return n[0];
+        return std::move(n[0]);
     }
 }
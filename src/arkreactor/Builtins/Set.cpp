@@ -0,0 +1,239 @@
+#include <Ark/Builtins/Builtins.hpp>
+
+#include <Ark/Builtins/BuiltinsErrors.inl>
+#include <Ark/VM/VM.hpp>
+
+namespace Ark::internal::Builtins::Set
+{
+    /**
+     * @name set:new
+     * @brief Create a Set from the given values
+     * @details Duplicated values are kept only once
+     * @param ... the values
+     * =begin
+     * (set:new 1 2 2 "a")  # {1 2 "a"}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value new_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        internal::Set s;
+        for (const Value& value : n)
+            s.insert(value);
+
+        return Value(std::move(s));
+    }
+
+    /**
+     * @name set:fromList
+     * @brief Create a Set from the elements of a List
+     * @details Duplicated elements are kept only once, in linear time
+     * @param list the List
+     * =begin
+     * (set:fromList [1 2 1 3])  # {1 2 3}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value fromList(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(SET_FROMLIST_ARITY);
+        if (n[0].valueType() != ValueType::List)
+            throw Ark::TypeError(SET_FROMLIST_TE0);
+
+        internal::Set s;
+        for (const Value& value : n[0].listView())
+            s.insert(value);
+
+        return Value(std::move(s));
+    }
+
+    /**
+     * @name set:toList
+     * @brief Get the elements of a Set, in insertion order
+     * @details When an element is removed, the last inserted element takes its place
+     * @param set the Set
+     * =begin
+     * (set:toList (set:new 1 2))  # [1 2]
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value toList(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(SET_TOLIST_ARITY);
+        if (n[0].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_TOLIST_TE0);
+
+        std::vector<Value> list;
+        list.reserve(n[0].set().size());
+        for (const internal::Set::Entry& entry : n[0].set().entries())
+            list.push_back(entry.key);
+
+        return Value(std::move(list));
+    }
+
+    /**
+     * @name set:contains?
+     * @brief Check if a value is in a Set
+     * @param set the Set
+     * @param value the value to search
+     * =begin
+     * (set:contains? (set:new 1 2) 1)  # true
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value contains(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(SET_CONTAINS_ARITY);
+        if (n[0].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_CONTAINS_TE0);
+
+        return n[0].set().contains(n[1]) ? trueSym : falseSym;
+    }
+
+    /**
+     * @name set:add
+     * @brief Add a value to a Set and return a new one
+     * @details The original Set is not modified
+     * @param set the Set
+     * @param value the value to add
+     * =begin
+     * (set:add (set:new 1 2) 3)  # {1 2 3}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value add(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(SET_ADD_ARITY);
+        if (n[0].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_ADD_TE0);
+
+        n[0].setRef().insert(n[1]);
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name set:remove
+     * @brief Remove a value from a Set and return a new one
+     * @details The original Set is not modified
+     * @param set the Set
+     * @param value the value to remove
+     * =begin
+     * (set:remove (set:new 1 2) 1)  # {2}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value remove(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(SET_REMOVE_ARITY);
+        if (n[0].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_REMOVE_TE0);
+
+        n[0].setRef().remove(n[1]);
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name set:size
+     * @brief Get the number of elements in a Set
+     * @param set the Set
+     * =begin
+     * (set:size (set:new 1 2 2))  # 2
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value size(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 1)
+            throw std::runtime_error(SET_SIZE_ARITY);
+        if (n[0].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_SIZE_TE0);
+
+        return Value(static_cast<int>(n[0].set().size()));
+    }
+
+    /**
+     * @name set:union
+     * @brief Get the values which are in one of two Sets
+     * @param a the first Set
+     * @param b the second Set
+     * =begin
+     * (set:union (set:new 1 2) (set:new 2 3))  # {1 2 3}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value union_(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(SET_UNION_ARITY);
+        if (n[0].valueType() != ValueType::Set || n[1].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_UNION_TE);
+
+        for (const internal::Set::Entry& entry : n[1].set().entries())
+            n[0].setRef().insert(entry.key);
+        return std::move(n[0]);
+    }
+
+    /**
+     * @name set:intersection
+     * @brief Get the values which are in both Sets
+     * @param a the first Set
+     * @param b the second Set
+     * =begin
+     * (set:intersection (set:new 1 2) (set:new 2 3))  # {2}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value intersection(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(SET_INTERSECTION_ARITY);
+        if (n[0].valueType() != ValueType::Set || n[1].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_INTERSECTION_TE);
+
+        // go through the smallest set
+        const bool first_is_smaller = n[0].set().size() <= n[1].set().size();
+        const internal::Set& smaller = first_is_smaller ? n[0].set() : n[1].set();
+        const internal::Set& bigger = first_is_smaller ? n[1].set() : n[0].set();
+
+        internal::Set s;
+        for (const internal::Set::Entry& entry : smaller.entries())
+        {
+            if (bigger.contains(entry.key))
+                s.insert(entry.key);
+        }
+
+        return Value(std::move(s));
+    }
+
+    /**
+     * @name set:difference
+     * @brief Get the values of a Set which aren't in another one
+     * @param a the first Set
+     * @param b the values to remove from the first Set
+     * =begin
+     * (set:difference (set:new 1 2) (set:new 2 3))  # {1}
+     * =end
+     * @author https://github.com/SuperFola
+     */
+    Value difference(std::vector<Value>& n, Ark::VM* vm)
+    {
+        if (n.size() != 2)
+            throw std::runtime_error(SET_DIFFERENCE_ARITY);
+        if (n[0].valueType() != ValueType::Set || n[1].valueType() != ValueType::Set)
+            throw Ark::TypeError(SET_DIFFERENCE_TE);
+
+        internal::Set s;
+        for (const internal::Set::Entry& entry : n[0].set().entries())
+        {
+            if (!n[1].set().contains(entry.key))
+                s.insert(entry.key);
+        }
+
+        return Value(std::move(s));
+    }
+}
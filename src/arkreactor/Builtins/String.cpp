@@ -37,7 +37,7 @@ namespace Ark::internal::Builtins::String
         {
             if (it->valueType() == ValueType::String)
             {
-                ::String& obj = it->stringRef();
+                const SharedString& obj = it->string();
                 f.format(f.size() + obj.size(), obj.c_str());
             }
             else if (it->valueType() == ValueType::Number)
@@ -58,7 +58,7 @@ namespace Ark::internal::Builtins::String
                 f.format(f.size() + ss.str().size(), std::string_view(ss.str().c_str()));
             }
         }
-        n[0].stringRef() = f;
+        n[0].stringRef() = SharedString(std::string_view(f.c_str(), f.size()));
         return n[0];
     }
 
@@ -83,7 +83,7 @@ namespace Ark::internal::Builtins::String
         if (n[1].valueType() != ValueType::String)
             throw Ark::TypeError(STR_FIND_TE1);
 
-        return Value(n[0].stringRef().find(n[1].stringRef()));
+        return Value(n[0].string().find(n[1].string()));
     }
 
     /**
@@ -108,11 +108,11 @@ namespace Ark::internal::Builtins::String
             throw Ark::TypeError(STR_RM_TE1);
 
         long id = static_cast<long>(n[1].number());
-        if (id < 0 || static_cast<std::size_t>(id) >= n[0].stringRef().size())
+        const SharedString& str = n[0].string();
+        if (id < 0 || static_cast<std::size_t>(id) >= str.size())
             throw std::runtime_error(STR_RM_OOR);
 
-        n[0].stringRef().erase(id, id + 1);
-        return n[0];
+        return Value(str.substr(0, id) + str.substr(id + 1));
     }
 
     /**
@@ -132,7 +132,7 @@ namespace Ark::internal::Builtins::String
         if (n[0].valueType() != ValueType::String)
             throw Ark::TypeError(STR_ORD_TE0);
 
-        int ord = utf8codepoint(n[0].stringRef().c_str());
+        int ord = utf8codepoint(n[0].string().c_str());
 
         return Value(ord);
     }
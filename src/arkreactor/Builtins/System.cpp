@@ -53,7 +53,8 @@ namespace Ark::internal::Builtins::System
     /**
      * @name sys:sleep
      * @brief Sleep for a given duration (in milliseconds)
-     * @details Return nil
+     * @details Return nil. When other coroutines exist, only the current one is suspended and the others run
+     *          in the meantime
      * @param duration a Number representing a duration
      * =begin
      * (sys:sleep 1000)  # sleep for 1 second
@@ -67,6 +68,9 @@ namespace Ark::internal::Builtins::System
         if (n[0].valueType() != ValueType::Number)
             throw Ark::TypeError(SYS_SLEEP_TE0);
 
+        if (vm != nullptr && vm->sleepCoroutine(n[0].number()))
+            return nil;
+
         auto duration = std::chrono::duration<double, std::ratio<1, 1000>>(n[0].number());
         std::this_thread::sleep_for(duration);
 
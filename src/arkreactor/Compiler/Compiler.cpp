@@ -98,6 +98,17 @@ namespace Ark
         return m_bytecode;
     }
 
+    std::size_t Compiler::instructionsCount() const noexcept
+    {
+        std::size_t count = 0;
+        for (const auto& page : m_code_pages)
+        {
+            for (std::size_t ip = 0, size = page.size(); ip < size; ip += instructionSize(page[ip]))
+                ++count;
+        }
+        return count;
+    }
+
     void Compiler::pushHeadersPhase1() noexcept
     {
         /*
@@ -301,6 +312,10 @@ namespace Ark
         // error, can not use append/concat/pop (and their in place versions) with a <2 length argument list
         if (argc < 2 && inst != Instruction::LIST)
             throw Ark::CompilationError("can not use " + name + " with less than 2 arguments");
+        else if (inst == Instruction::DICT_SET_IN_PLACE && argc != 3)
+            throw Ark::CompilationError("can not use " + name + " without 3 arguments: dict, key, value");
+        else if (inst == Instruction::DICT_REMOVE_IN_PLACE && argc != 2)
+            throw Ark::CompilationError("can not use " + name + " without 2 arguments: dict, key");
 
         // compile arguments in reverse order
         for (uint16_t i = x.constList().size() - 1; i > 0; --i)
@@ -0,0 +1,255 @@
+#include <Ark/Compiler/CppEmitter.hpp>
+
+#include <fstream>
+#include <set>
+
+#include <Ark/Constants.hpp>
+#include <Ark/VM/State.hpp>
+#include <Ark/Compiler/Instructions.hpp>
+#include <Ark/Builtins/Builtins.hpp>
+
+namespace Ark
+{
+    using namespace internal;
+
+    CppEmitter::CppEmitter(const State& state) noexcept :
+        m_state(state)
+    {}
+
+    void CppEmitter::emit(std::ostream& os) const
+    {
+        os << "// Generated by ArkScript " << ARK_VERSION_MAJOR << "." << ARK_VERSION_MINOR << "." << ARK_VERSION_PATCH << " (ark --emit-cpp), do not edit\n"
+           << "// Build it as a shared library linked against ArkReactor, then load it with `ark file.ark --native module`\n\n"
+           << "#include <Ark/Ark.hpp>\n\n"
+           << "#if defined(_WIN32) || defined(_WIN64)\n"
+           << "#    define ARK_NATIVE_EXPORT extern \"C\" __declspec(dllexport)\n"
+           << "#else\n"
+           << "#    define ARK_NATIVE_EXPORT extern \"C\" __attribute__((visibility(\"default\")))\n"
+           << "#endif\n\n"
+           << "using namespace Ark;\n"
+           << "using namespace Ark::internal;\n\n"
+           << "namespace\n{\n";
+
+        for (std::size_t i = 0, end = m_state.m_pages.size(); i < end; ++i)
+            emitPage(os, i);
+
+        os << "    const NativePage_t pages[] = {\n";
+        for (std::size_t i = 0, end = m_state.m_pages.size(); i < end; ++i)
+            os << "        page_" << i << ",\n";
+        os << "    };\n\n"
+           << "    const NativeModule module = { \"" << m_state.m_hash << "\", " << m_state.m_pages.size() << ", pages };\n"
+           << "}\n\n"
+           << "ARK_NATIVE_EXPORT const NativeModule* getNativePages()\n{\n"
+           << "    return &module;\n"
+           << "}\n";
+    }
+
+    bool CppEmitter::saveTo(const std::string& file) const
+    {
+        std::ofstream output(file);
+        if (!output.is_open())
+            return false;
+
+        emit(output);
+        return output.good();
+    }
+
+    void CppEmitter::emitPage(std::ostream& os, std::size_t page_id) const
+    {
+        const bytecode_t& page = m_state.m_pages[page_id];
+        const std::size_t size = page.size();
+
+        auto argument = [&page](std::size_t ip) -> uint16_t {
+            return static_cast<uint16_t>((static_cast<uint16_t>(page[ip + 1]) << 8) + page[ip + 2]);
+        };
+        // symbols are only used in comments, a trailing backslash would continue the comment on the next line
+        auto symbol = [this](uint16_t id) -> std::string {
+            std::string name = m_state.m_symbols[id];
+            for (char& c : name)
+            {
+                if (c == '\\')
+                    c = '/';
+            }
+            return name;
+        };
+
+        // the translated instructions are the possible entry points, and every jump target needs a label
+        std::set<std::size_t> starts, translated, labels;
+        for (std::size_t ip = 0; ip < size; ip += instructionSize(page[ip]))
+        {
+            starts.insert(ip);
+            switch (page[ip])
+            {
+                case Instruction::NOP:
+                case Instruction::LOAD_SYMBOL:
+                case Instruction::LOAD_CONST:
+                case Instruction::STORE:
+                case Instruction::BUILTIN:
+                case Instruction::JUMP:
+                case Instruction::POP_JUMP_IF_TRUE:
+                case Instruction::POP_JUMP_IF_FALSE:
+                case Instruction::ADD:
+                case Instruction::SUB:
+                case Instruction::MUL:
+                case Instruction::DIV:
+                case Instruction::GT:
+                case Instruction::LT:
+                case Instruction::LE:
+                case Instruction::GE:
+                case Instruction::NEQ:
+                case Instruction::EQ:
+                    translated.insert(ip);
+                    labels.insert(ip);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        for (std::size_t ip : starts)
+        {
+            const uint8_t inst = page[ip];
+            const std::size_t next = ip + instructionSize(inst);
+            if (inst == Instruction::JUMP || inst == Instruction::POP_JUMP_IF_TRUE || inst == Instruction::POP_JUMP_IF_FALSE)
+                labels.insert(argument(ip));
+            if (inst >= Instruction::GT && inst <= Instruction::EQ && next < size &&
+                (page[next] == Instruction::POP_JUMP_IF_TRUE || page[next] == Instruction::POP_JUMP_IF_FALSE))
+                labels.insert(next + instructionSize(page[next]));
+        }
+
+        auto leave = [](std::size_t ip) {
+            return "return NativeOps::leave(vm, " + std::to_string(ip) + ");";
+        };
+        // a loop counts its instructions and leaves when the budget has to be checked, like the JIT does
+        auto jump = [&](std::size_t from, std::size_t to) {
+            if (!starts.count(to))
+                return leave(to);
+            const std::string go_to = "goto L" + std::to_string(to) + ";";
+            if (to > from)
+                return go_to;
+
+            const auto cost = std::distance(starts.lower_bound(to), starts.upper_bound(from));
+            return "{ if (!NativeOps::spend(vm, " + std::to_string(cost) + ")) " + leave(to) + " " + go_to + " }";
+        };
+
+        os << "    void page_" << page_id << "(VM* vm, Value* /* stack */, int ip)\n"
+           << "    {\n"
+           << "        switch (ip)\n"
+           << "        {\n";
+        for (std::size_t ip : translated)
+            os << "            case " << ip << ": goto L" << ip << ";\n";
+        os << "            default: return;\n"
+           << "        }\n\n";
+
+        for (std::size_t ip : starts)
+        {
+            const uint8_t inst = page[ip];
+            const std::size_t next = ip + instructionSize(inst);
+
+            if (labels.count(ip))
+                os << "    L" << ip << ":\n";
+
+            switch (inst)
+            {
+                case Instruction::NOP:
+                    break;
+
+                case Instruction::LOAD_SYMBOL:
+                    os << "        // LOAD_SYMBOL " << symbol(argument(ip)) << "\n"
+                       << "        if (!NativeOps::loadSymbol(vm, " << argument(ip) << "))\n"
+                       << "            " << leave(ip) << "\n";
+                    break;
+
+                case Instruction::STORE:
+                    os << "        // STORE " << symbol(argument(ip)) << "\n"
+                       << "        if (!NativeOps::store(vm, " << argument(ip) << "))\n"
+                       << "            " << leave(ip) << "\n";
+                    break;
+
+                case Instruction::LOAD_CONST:
+                    os << "        if (!NativeOps::loadConst(vm, " << argument(ip) << "))\n"
+                       << "            " << leave(ip) << "\n";
+                    break;
+
+                case Instruction::BUILTIN:
+                    os << "        // BUILTIN " << Builtins::builtins[argument(ip)].first << "\n"
+                       << "        NativeOps::builtin(vm, " << argument(ip) << ");\n";
+                    break;
+
+                case Instruction::JUMP:
+                    os << "        " << jump(ip, argument(ip)) << "\n";
+                    break;
+
+                case Instruction::POP_JUMP_IF_TRUE:
+                case Instruction::POP_JUMP_IF_FALSE:
+                    os << "        if (NativeOps::popIs(vm, ValueType::" << (inst == Instruction::POP_JUMP_IF_TRUE ? "True" : "False") << "))\n"
+                       << "            " << jump(ip, argument(ip)) << "\n";
+                    break;
+
+                case Instruction::ADD:
+                case Instruction::SUB:
+                case Instruction::MUL:
+                case Instruction::DIV:
+                {
+                    static const char* operators[] = { "+", "-", "*", "/" };
+                    // the interpreter raises a ZeroDivisionError
+                    const char* check = (inst == Instruction::DIV) ? " && b != 0" : "";
+
+                    os << "        if (double a, b; NativeOps::numbers(vm, a, b)" << check << ")\n"
+                       << "            NativeOps::reduceNumber(vm, a " << operators[inst - Instruction::ADD] << " b);\n"
+                       << "        else\n"
+                       << "            " << leave(ip) << "\n";
+                    break;
+                }
+
+                case Instruction::GT:
+                case Instruction::LT:
+                case Instruction::LE:
+                case Instruction::GE:
+                case Instruction::NEQ:
+                case Instruction::EQ:
+                {
+                    // written like the interpreter does, to handle NaN the same way
+                    static const char* conditions[] = {
+                        "!(a == b) && !(a < b)",  // GT
+                        "a < b",                  // LT
+                        "(a < b) || (a == b)",    // LE
+                        "!(a < b)",               // GE
+                        "a != b",                 // NEQ
+                        "a == b"                  // EQ
+                    };
+                    const std::string condition = conditions[inst - Instruction::GT];
+
+                    // fuse with a conditional jump right after, if any
+                    if (next < size && (page[next] == Instruction::POP_JUMP_IF_TRUE || page[next] == Instruction::POP_JUMP_IF_FALSE))
+                    {
+                        const bool jump_if = page[next] == Instruction::POP_JUMP_IF_TRUE;
+                        os << "        if (double a, b; NativeOps::numbers(vm, a, b))\n"
+                           << "        {\n"
+                           << "            NativeOps::drop(vm, 2);\n"
+                           << "            if (" << (jump_if ? condition : "!(" + condition + ")") << ")\n"
+                           << "                " << jump(next, argument(next)) << "\n"
+                           << "            " << jump(next, next + instructionSize(page[next])) << "\n"
+                           << "        }\n"
+                           << "        " << leave(ip) << "\n";
+                    }
+                    else
+                        os << "        if (double a, b; NativeOps::numbers(vm, a, b))\n"
+                           << "            NativeOps::reduceBool(vm, " << condition << ");\n"
+                           << "        else\n"
+                           << "            " << leave(ip) << "\n";
+                    break;
+                }
+
+                default:
+                    // handed back to the interpreter
+                    os << "        " << leave(ip) << "\n";
+                    break;
+            }
+        }
+
+        // falling off the end of the page, shouldn't happen since pages end with RET or HALT
+        os << "        " << leave(size) << "\n"
+           << "    }\n\n";
+    }
+}
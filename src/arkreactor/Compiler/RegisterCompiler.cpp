@@ -0,0 +1,591 @@
+#include <Ark/Compiler/RegisterCompiler.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+
+#include <Ark/Exceptions.hpp>
+#include <Ark/Compiler/Compiler.hpp>
+#include <Ark/Compiler/Instructions.hpp>
+#include <Ark/Compiler/makeErrorCtx.hpp>
+#include <Ark/Builtins/Builtins.hpp>
+
+namespace Ark
+{
+    using namespace internal;
+
+    namespace
+    {
+        std::optional<std::size_t> findOperator(const std::string& name) noexcept
+        {
+            auto it = std::find(Builtins::operators.begin(), Builtins::operators.end(), name);
+            if (it != Builtins::operators.end())
+                return std::distance(Builtins::operators.begin(), it);
+            return {};
+        }
+
+        std::optional<std::size_t> findBuiltin(const std::string& name) noexcept
+        {
+            auto it = std::find_if(Builtins::builtins.begin(), Builtins::builtins.end(),
+                                   [&name](const std::pair<std::string, Value>& element) -> bool {
+                                       return name == element.first;
+                                   });
+            if (it != Builtins::builtins.end())
+                return std::distance(Builtins::builtins.begin(), it);
+            return {};
+        }
+
+        // the RegisterVM calls the builtins without a VM, these ones need it to call functions, suspend or exit
+        bool needsVM(const std::string& name) noexcept
+        {
+            return name == "sys:exit" || name == "list:sortBy" || name == "list:map" || name == "list:filter" ||
+                name == "list:reduce" || name == "list:pmap" || name == "async" || name == "await" || name == "yield";
+        }
+
+        bool isSpecific(const std::string& name) noexcept
+        {
+            return name == "list" || name == "append" || name == "concat" || name == "append!" ||
+                name == "concat!" || name == "pop" || name == "pop!" || name == "dict:set!" || name == "dict:remove!";
+        }
+
+        const char* mnemonics[] = {
+            "NOP", "LOADK", "MOVE", "GETG", "SETG", "JUMP", "JUMPT", "JUMPF", "CALL", "RET", "HALT",
+            "ADD", "SUB", "MUL", "DIV", "MOD", "GT", "LT", "LE", "GE", "NEQ", "EQ", "AND", "OR", "NOT", "TO_STR"
+        };
+    }
+
+    RegisterCompiler::RegisterCompiler(const Compiler& compiler) noexcept :
+        m_ast(compiler.m_optimizer.ast())
+    {}
+
+    void RegisterCompiler::compile()
+    {
+        m_pages.clear();
+        m_constants.clear();
+        m_globals.clear();
+        m_defined_globals.clear();
+        m_constant_globals.clear();
+
+        // the top level code, its variables are globals
+        m_pages.emplace_back();
+        m_frames.push_back(Frame { 0 });
+
+        compile(m_ast, -1);
+        emit(R_HALT);
+
+        m_frames.pop_back();
+
+        for (const std::string& name : m_globals)
+        {
+            if (std::find(m_defined_globals.begin(), m_defined_globals.end(), name) == m_defined_globals.end())
+                throw CompilationError("Unbound variable error (variable is used but not defined): " + name);
+        }
+    }
+
+    std::size_t RegisterCompiler::instructionsCount() const noexcept
+    {
+        std::size_t count = 0;
+        for (const RegisterPage& page : m_pages)
+            count += page.code.size();
+        return count;
+    }
+
+    void RegisterCompiler::display(std::ostream& os) const
+    {
+        auto rk = [this](uint16_t operand) -> std::string {
+            if (operand & RegisterConstantBit)
+            {
+                std::stringstream ss;
+                ss << m_constants[operand & ~RegisterConstantBit];
+                return ss.str();
+            }
+            return "r" + std::to_string(operand);
+        };
+
+        for (std::size_t i = 0, end = m_pages.size(); i < end; ++i)
+        {
+            const RegisterPage& page = m_pages[i];
+            os << "Code segment " << i << " (arguments: " << page.arity << ", registers: " << page.registers << ")\n";
+
+            for (std::size_t j = 0, size = page.code.size(); j < size; ++j)
+            {
+                const RegisterInst& inst = page.code[j];
+                os << "    " << j << "\t" << mnemonics[inst.op] << "\t";
+
+                switch (inst.op)
+                {
+                    case R_LOADK: os << "r" << inst.a << ", " << rk(inst.b | RegisterConstantBit); break;
+                    case R_MOVE: os << "r" << inst.a << ", r" << inst.b; break;
+                    case R_GETG: os << "r" << inst.a << ", " << m_globals[inst.b]; break;
+                    case R_SETG: os << m_globals[inst.a] << ", " << rk(inst.b); break;
+                    case R_JUMP: os << inst.a; break;
+                    case R_JUMPT:
+                    case R_JUMPF: os << rk(inst.a) << ", " << inst.b; break;
+                    case R_CALL: os << "r" << inst.a << ", " << inst.b; break;
+                    case R_RET: os << rk(inst.a); break;
+                    case R_NOP:
+                    case R_HALT: break;
+                    case R_NOT:
+                    case R_TO_STR: os << "r" << inst.a << ", " << rk(inst.b); break;
+                    default: os << "r" << inst.a << ", " << rk(inst.b) << ", " << rk(inst.c); break;
+                }
+                os << "\n";
+            }
+        }
+    }
+
+    void RegisterCompiler::compile(const Node& x, int dst)
+    {
+        switch (x.nodeType())
+        {
+            case NodeType::Symbol:
+                compileSymbol(x, dst);
+                return;
+
+            case NodeType::Number:
+            case NodeType::String:
+                if (dst >= 0)
+                    emit(R_LOADK, dst, operand(x) & ~RegisterConstantBit);
+                return;
+
+            case NodeType::List:
+                break;
+
+            default:
+                throwCompilerError("The register engine doesn't support this kind of expression", x);
+        }
+
+        // empty code block should be nil
+        if (x.constList().empty())
+        {
+            loadNil(dst);
+            return;
+        }
+
+        const Node& c0 = x.constList()[0];
+        if (c0.nodeType() == NodeType::Keyword)
+        {
+            switch (c0.keyword())
+            {
+                case Keyword::If:
+                    compileIf(x, dst);
+                    break;
+
+                case Keyword::Set:
+                    compileSet(x, dst);
+                    break;
+
+                case Keyword::Let:
+                case Keyword::Mut:
+                    compileLetMut(c0.keyword(), x, dst);
+                    break;
+
+                case Keyword::Fun:
+                    compileFunction(x, dst);
+                    break;
+
+                case Keyword::Begin:
+                {
+                    const std::size_t size = x.constList().size();
+                    if (size == 1)
+                        loadNil(dst);
+                    for (std::size_t i = 1; i < size; ++i)
+                        compile(x.constList()[i], (i + 1 == size) ? dst : -1);
+                    break;
+                }
+
+                case Keyword::While:
+                    compileWhile(x, dst);
+                    break;
+
+                default:
+                    throwCompilerError("The register engine doesn't support imports, quotes nor del", x);
+            }
+        }
+        else if (auto op = (c0.nodeType() == NodeType::Symbol) ? findOperator(c0.string()) : std::nullopt)
+            compileOperator(op.value(), x, dst);
+        else
+            handleCalls(x, dst);
+    }
+
+    uint16_t RegisterCompiler::operand(const Node& x)
+    {
+        if (x.nodeType() == NodeType::Number)
+            return addConstant(Value(x.number())) | RegisterConstantBit;
+        else if (x.nodeType() == NodeType::String)
+            return addConstant(Value(x.string())) | RegisterConstantBit;
+        else if (x.nodeType() == NodeType::Symbol)
+        {
+            const Frame& frame = m_frames.back();
+            if (auto it = frame.locals.find(x.string()); it != frame.locals.end())
+                return it->second;
+            if (needsVM(x.string()))
+                throwCompilerError("The register engine doesn't support " + x.string() + ", it needs the virtual machine", x);
+            if (auto it = findBuiltin(x.string()))
+                return addConstant(Builtins::builtins[it.value()].second) | RegisterConstantBit;
+        }
+        else if (x.nodeType() == NodeType::List && !x.constList().empty() &&
+                 x.constList()[0].nodeType() == NodeType::Keyword && x.constList()[0].keyword() == Keyword::Begin)
+        {
+            // the value of a block is the one of its last expression, no need to move it around
+            const std::size_t size = x.constList().size();
+            if (size == 1)
+                return addConstant(Builtins::nil) | RegisterConstantBit;
+            for (std::size_t i = 1; i + 1 < size; ++i)
+                compile(x.constList()[i], -1);
+            return operand(x.constList().back());
+        }
+
+        uint16_t reg = allocate();
+        compile(x, reg);
+        return reg;
+    }
+
+    void RegisterCompiler::compileSymbol(const Node& x, int dst)
+    {
+        const std::string& name = x.string();
+
+        if (auto it = m_frames.back().locals.find(name); it != m_frames.back().locals.end())
+        {
+            if (dst >= 0 && dst != it->second)
+                emit(R_MOVE, dst, it->second);
+            return;
+        }
+        // the first frame holds the top level code, its variables are globals
+        for (std::size_t i = 1, end = m_frames.size() - 1; i < end; ++i)
+        {
+            if (m_frames[i].locals.count(name))
+                throwCompilerError("The register engine doesn't support closures, can not use `" + name + "' from an enclosing function", x);
+        }
+
+        if (needsVM(name))
+            throwCompilerError("The register engine doesn't support " + name + ", it needs the virtual machine", x);
+        else if (auto it = findBuiltin(name))
+        {
+            if (dst >= 0)
+                emit(R_LOADK, dst, addConstant(Builtins::builtins[it.value()].second));
+        }
+        else if (findOperator(name))
+            throwCompilerError("The register engine doesn't support using operators as values", x);
+        else
+        {
+            uint16_t id = addGlobal(name);
+            if (dst >= 0)
+                emit(R_GETG, dst, id);
+        }
+    }
+
+    void RegisterCompiler::compileIf(const Node& x, int dst)
+    {
+        const std::size_t page = m_frames.back().page;
+
+        // compile condition
+        uint16_t top = m_frames.back().top;
+        uint16_t cond = operand(x.constList()[1]);
+        release(top);
+        // jump to the "then" part if the condition is true, like the stack VM
+        std::size_t jump_to_if = emit(R_JUMPT, cond);
+        // else code
+        if (x.constList().size() == 4)
+            compile(x.constList()[3], dst);
+        else
+            loadNil(dst);
+        // when else is finished, jump to end
+        std::size_t jump_to_end = emit(R_JUMP);
+        m_pages[page].code[jump_to_if].b = static_cast<uint16_t>(m_pages[page].code.size());
+        // if code
+        compile(x.constList()[2], dst);
+        m_pages[page].code[jump_to_end].a = static_cast<uint16_t>(m_pages[page].code.size());
+    }
+
+    void RegisterCompiler::compileWhile(const Node& x, int dst)
+    {
+        const std::size_t page = m_frames.back().page;
+
+        // save current position to jump there at the end of the loop
+        std::size_t loop = m_pages[page].code.size();
+        uint16_t top = m_frames.back().top;
+        uint16_t cond = operand(x.constList()[1]);
+        release(top);
+        // jump to end of block if condition is false
+        std::size_t jump_to_end = emit(R_JUMPF, cond);
+        compile(x.constList()[2], -1);
+        emit(R_JUMP, static_cast<uint16_t>(loop));
+        m_pages[page].code[jump_to_end].b = static_cast<uint16_t>(m_pages[page].code.size());
+
+        loadNil(dst);
+    }
+
+    void RegisterCompiler::compileLetMut(Keyword n, const Node& x, int dst)
+    {
+        if (x.constList().size() != 3)
+            throwCompilerError("The register engine doesn't support closures fields", x);
+
+        const std::string& name = x.constList()[1].string();
+
+        // top level variables are globals, since functions can use them
+        if (m_frames.size() == 1)
+        {
+            uint16_t id = addGlobal(name);
+            m_defined_globals.push_back(name);
+            if (n == Keyword::Let)
+                m_constant_globals.push_back(name);
+
+            uint16_t top = m_frames.back().top;
+            uint16_t value = operand(x.constList()[2]);
+            release(top);
+            emit(R_SETG, id, value);
+        }
+        else
+        {
+            Frame& frame = m_frames.back();
+            uint16_t reg;
+            if (auto it = frame.locals.find(name); it != frame.locals.end())
+                reg = it->second;
+            else
+            {
+                reg = allocate();
+                m_frames.back().reserved = m_frames.back().top;
+                m_frames.back().locals[name] = reg;
+            }
+            if (n == Keyword::Let)
+                m_frames.back().constants.push_back(name);
+
+            compile(x.constList()[2], reg);
+        }
+
+        loadNil(dst);
+    }
+
+    void RegisterCompiler::compileSet(const Node& x, int dst)
+    {
+        if (x.constList().size() != 3)
+            throwCompilerError("The register engine doesn't support closures fields", x);
+
+        const std::string& name = x.constList()[1].string();
+        const Frame& frame = m_frames.back();
+
+        if (auto it = frame.locals.find(name); it != frame.locals.end())
+        {
+            if (std::find(frame.constants.begin(), frame.constants.end(), name) != frame.constants.end())
+                throwCompilerError("can not modify a constant: " + name, x);
+            compile(x.constList()[2], it->second);
+        }
+        else
+        {
+            for (std::size_t i = 1, end = m_frames.size() - 1; i < end; ++i)
+            {
+                if (m_frames[i].locals.count(name))
+                    throwCompilerError("The register engine doesn't support closures, can not modify `" + name + "' from an enclosing function", x);
+            }
+            if (std::find(m_constant_globals.begin(), m_constant_globals.end(), name) != m_constant_globals.end())
+                throwCompilerError("can not modify a constant: " + name, x);
+
+            uint16_t id = addGlobal(name);
+            uint16_t top = m_frames.back().top;
+            uint16_t value = operand(x.constList()[2]);
+            release(top);
+            emit(R_SETG, id, value);
+        }
+
+        loadNil(dst);
+    }
+
+    void RegisterCompiler::compileFunction(const Node& x, int dst)
+    {
+        // create new page for function body
+        const std::size_t page_id = m_pages.size();
+        m_pages.emplace_back();
+        m_frames.push_back(Frame { page_id });
+
+        // the arguments are the first registers of the frame
+        for (const Node& arg : x.constList()[1].constList())
+        {
+            if (arg.nodeType() != NodeType::Symbol)
+                throwCompilerError("The register engine doesn't support captures", arg);
+            m_frames.back().locals[arg.string()] = allocate();
+            ++m_pages[page_id].arity;
+        }
+        m_frames.back().reserved = m_frames.back().top;
+
+        emit(R_RET, operand(x.constList()[2]));
+        m_frames.pop_back();
+
+        if (dst >= 0)
+            emit(R_LOADK, dst, addConstant(Value(static_cast<PageAddr_t>(page_id))));
+    }
+
+    void RegisterCompiler::compileOperator(std::size_t op, const Node& x, int dst)
+    {
+        const Inst_t inst = static_cast<Inst_t>(Instruction::FIRST_OPERATOR + op);
+        const std::string& name = Builtins::operators[op];
+        const std::size_t argc = x.constList().size() - 1;
+
+        RegisterInstruction rinst;
+        std::size_t min_argc = 2, max_argc = 2;
+        switch (inst)
+        {
+            case Instruction::ADD: rinst = R_ADD; max_argc = ~0; break;
+            case Instruction::SUB: rinst = R_SUB; max_argc = ~0; break;
+            case Instruction::MUL: rinst = R_MUL; max_argc = ~0; break;
+            case Instruction::DIV: rinst = R_DIV; max_argc = ~0; break;
+            case Instruction::MOD: rinst = R_MOD; max_argc = ~0; break;
+            case Instruction::AND_: rinst = R_AND; max_argc = ~0; break;
+            case Instruction::OR_: rinst = R_OR; max_argc = ~0; break;
+            case Instruction::GT: rinst = R_GT; break;
+            case Instruction::LT: rinst = R_LT; break;
+            case Instruction::LE: rinst = R_LE; break;
+            case Instruction::GE: rinst = R_GE; break;
+            case Instruction::NEQ: rinst = R_NEQ; break;
+            case Instruction::EQ: rinst = R_EQ; break;
+            case Instruction::NOT: rinst = R_NOT; min_argc = max_argc = 1; break;
+            case Instruction::TO_STR: rinst = R_TO_STR; min_argc = max_argc = 1; break;
+
+            default:
+                throwCompilerError("The register engine doesn't support the operator `" + name + "'", x);
+        }
+
+        if (argc < min_argc || argc > max_argc)
+            throwCompilerError("can not use the operator `" + name + "' with " + std::to_string(argc) + " argument(s)", x);
+        for (std::size_t i = 1; i <= argc; ++i)
+        {
+            if (x.constList()[i].nodeType() == NodeType::GetField || x.constList()[i].nodeType() == NodeType::Capture)
+                throwCompilerError("The register engine doesn't support closures fields", x.constList()[i]);
+        }
+
+        const uint16_t top = m_frames.back().top;
+
+        if (argc == 1)
+        {
+            uint16_t a = operand(x.constList()[1]);
+            release(top);
+            emit(rinst, dst >= 0 ? dst : allocate(), a);
+        }
+        else if (argc == 2)
+        {
+            uint16_t a = operand(x.constList()[1]);
+            uint16_t b = operand(x.constList()[2]);
+            release(top);
+            emit(rinst, dst >= 0 ? dst : allocate(), a, b);
+        }
+        else
+        {
+            // (op A B C D...) is transformed into (op (op (op A B) C) D), the intermediate results go in a
+            // temporary register since the destination may be one of the operands
+            uint16_t acc = allocate();
+            uint16_t a = operand(x.constList()[1]);
+            uint16_t b = operand(x.constList()[2]);
+            release(acc + 1);
+            emit(rinst, acc, a, b);
+
+            for (std::size_t i = 3; i <= argc; ++i)
+            {
+                uint16_t c = operand(x.constList()[i]);
+                release(acc + 1);
+                emit(rinst, (i == argc && dst >= 0) ? dst : acc, acc, c);
+            }
+        }
+
+        release(top);
+    }
+
+    void RegisterCompiler::handleCalls(const Node& x, int dst)
+    {
+        const Node& c0 = x.constList()[0];
+        if (c0.nodeType() == NodeType::Symbol && isSpecific(c0.string()))
+            throwCompilerError("The register engine doesn't support lists", x);
+
+        const uint16_t top = m_frames.back().top;
+
+        // the function and its arguments must be in consecutive registers, when the destination
+        // is the last temporary register allocated, it can directly be used to call the function
+        const bool in_place = dst >= 0 && dst >= m_frames.back().reserved && dst + 1 == top;
+        uint16_t base = in_place ? static_cast<uint16_t>(dst) : allocate();
+        compile(c0, base);
+
+        std::size_t argc = 0;
+        for (std::size_t i = 1, size = x.constList().size(); i < size; ++i)
+        {
+            const Node& arg = x.constList()[i];
+            if (arg.nodeType() == NodeType::GetField || arg.nodeType() == NodeType::Capture)
+                throwCompilerError("The register engine doesn't support closures fields", arg);
+
+            uint16_t reg = allocate();
+            if (reg != base + 1 + argc)
+                throwCompilerError("The register engine doesn't support variables declarations in function calls", x);
+            compile(arg, reg);
+            ++argc;
+        }
+        if (m_frames.back().top != base + 1 + argc)
+            throwCompilerError("The register engine doesn't support variables declarations in function calls", x);
+
+        emit(R_CALL, base, static_cast<uint16_t>(argc));
+        if (dst >= 0 && dst != base)
+            emit(R_MOVE, dst, base);
+
+        release(top);
+    }
+
+    uint16_t RegisterCompiler::allocate()
+    {
+        Frame& frame = m_frames.back();
+        if (frame.top + 1 >= RegisterConstantBit)
+            throw CompilationError("too many registers needed by a function");
+
+        uint16_t reg = frame.top++;
+        RegisterPage& page = m_pages[frame.page];
+        page.registers = std::max(page.registers, frame.top);
+        return reg;
+    }
+
+    void RegisterCompiler::release(uint16_t top) noexcept
+    {
+        Frame& frame = m_frames.back();
+        frame.top = std::max(top, frame.reserved);
+    }
+
+    std::size_t RegisterCompiler::emit(RegisterInstruction op, uint16_t a, uint16_t b, uint16_t c)
+    {
+        std::vector<RegisterInst>& code = m_pages[m_frames.back().page].code;
+        if (code.size() >= 0xffff)
+            throw CompilationError("too many instructions in a function");
+
+        code.push_back(RegisterInst { op, a, b, c });
+        return code.size() - 1;
+    }
+
+    uint16_t RegisterCompiler::addConstant(const Value& value)
+    {
+        auto it = std::find_if(m_constants.begin(), m_constants.end(), [&value](const Value& v) -> bool {
+            return v.valueType() == value.valueType() && v == value;
+        });
+        if (it != m_constants.end())
+            return static_cast<uint16_t>(std::distance(m_constants.begin(), it));
+
+        if (m_constants.size() >= RegisterConstantBit)
+            throw CompilationError("too many constants");
+        m_constants.push_back(value);
+        return static_cast<uint16_t>(m_constants.size() - 1);
+    }
+
+    uint16_t RegisterCompiler::addGlobal(const std::string& name)
+    {
+        auto it = std::find(m_globals.begin(), m_globals.end(), name);
+        if (it != m_globals.end())
+            return static_cast<uint16_t>(std::distance(m_globals.begin(), it));
+
+        m_globals.push_back(name);
+        return static_cast<uint16_t>(m_globals.size() - 1);
+    }
+
+    void RegisterCompiler::loadNil(int dst)
+    {
+        if (dst >= 0)
+            emit(R_LOADK, dst, addConstant(Builtins::nil));
+    }
+
+    void RegisterCompiler::throwCompilerError(const std::string& message, const Node& node)
+    {
+        throw CompilationError(makeNodeBasedErrorCtx(message, node));
+    }
+}
@@ -0,0 +1,248 @@
+#include <Ark/VM/Allocator.hpp>
+
+#include <algorithm>
+
+namespace Ark
+{
+    namespace
+    {
+        thread_local Allocator* current_allocator = nullptr;
+    }
+
+    Allocator::Allocator() noexcept :
+        m_in_use(0), m_allocated(0), m_users(1)
+    {}
+
+    void* Allocator::allocate(std::size_t size, std::size_t alignment)
+    {
+        void* ptr = doAllocate(size, alignment);
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+
+        m_in_use.fetch_add(size, std::memory_order_relaxed);
+        m_allocated.fetch_add(size, std::memory_order_relaxed);
+        hold();
+        return ptr;
+    }
+
+    void Allocator::deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept
+    {
+        m_in_use.fetch_sub(size, std::memory_order_relaxed);
+        doDeallocate(ptr, size, alignment);
+        drop();
+    }
+
+    void Allocator::charge(std::size_t size) noexcept
+    {
+        m_in_use.fetch_add(size, std::memory_order_relaxed);
+        m_allocated.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void Allocator::release(std::size_t size) noexcept
+    {
+        m_in_use.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    std::size_t Allocator::bytesInUse() const noexcept
+    {
+        return m_in_use.load(std::memory_order_relaxed);
+    }
+
+    std::size_t Allocator::bytesAllocated() const noexcept
+    {
+        return m_allocated.load(std::memory_order_relaxed);
+    }
+
+    Allocator* Allocator::current() noexcept
+    {
+        return current_allocator;
+    }
+
+    void Allocator::destroyWhenUnused() noexcept
+    {
+        drop();
+    }
+
+    void Allocator::hold() noexcept
+    {
+        m_users.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Allocator::drop() noexcept
+    {
+        // the blocks can be given back by other threads, which must be done with the allocator before it's deleted
+        if (m_users.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    // ------------------------------------------
+
+    MallocAllocator::MallocAllocator(Malloc_t malloc, Free_t free) noexcept :
+        m_malloc(malloc), m_free(free)
+    {}
+
+    void* MallocAllocator::doAllocate(std::size_t size, std::size_t alignment)
+    {
+        return m_malloc(size);
+    }
+
+    void MallocAllocator::doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept
+    {
+        m_free(ptr);
+    }
+
+    // ------------------------------------------
+
+    PoolAllocator::PoolAllocator() noexcept
+    {
+        m_free_lists.fill(nullptr);
+    }
+
+    PoolAllocator::~PoolAllocator()
+    {
+        for (void* chunk : m_chunks)
+            std::free(chunk);
+    }
+
+    void* PoolAllocator::doAllocate(std::size_t size, std::size_t alignment)
+    {
+        if (size > MaxBlockSize || alignment > Granularity)
+            return ::operator new(size, std::nothrow);
+
+        const std::size_t size_class = (std::max<std::size_t>(size, 1) - 1) / Granularity;
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_free_lists[size_class] == nullptr)
+        {
+            // cut a new chunk in blocks of this size class
+            char* chunk = static_cast<char*>(std::malloc(ChunkSize));
+            if (chunk == nullptr)
+                return nullptr;
+            m_chunks.push_back(chunk);
+
+            const std::size_t block_size = (size_class + 1) * Granularity;
+            for (std::size_t offset = 0; offset + block_size <= ChunkSize; offset += block_size)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+                block->next = m_free_lists[size_class];
+                m_free_lists[size_class] = block;
+            }
+        }
+
+        FreeBlock* block = m_free_lists[size_class];
+        m_free_lists[size_class] = block->next;
+        return block;
+    }
+
+    void PoolAllocator::doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept
+    {
+        if (size > MaxBlockSize || alignment > Granularity)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        const std::size_t size_class = (std::max<std::size_t>(size, 1) - 1) / Granularity;
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = m_free_lists[size_class];
+        m_free_lists[size_class] = block;
+    }
+
+    // ------------------------------------------
+
+    ArenaAllocator::ArenaAllocator(std::size_t chunk_size) noexcept :
+        m_chunk_size(chunk_size), m_next(nullptr), m_end(nullptr)
+    {}
+
+    ArenaAllocator::~ArenaAllocator()
+    {
+        for (auto& [chunk, size] : m_chunks)
+            std::free(chunk);
+    }
+
+    void ArenaAllocator::reset() noexcept
+    {
+        if (m_chunks.empty())
+            return;
+
+        for (std::size_t i = 1; i < m_chunks.size(); ++i)
+            std::free(m_chunks[i].first);
+        m_chunks.resize(1);
+
+        m_next = static_cast<char*>(m_chunks[0].first);
+        m_end = m_next + m_chunks[0].second;
+    }
+
+    std::size_t ArenaAllocator::bytesReserved() const noexcept
+    {
+        std::size_t total = 0;
+        for (const auto& [chunk, size] : m_chunks)
+            total += size;
+        return total;
+    }
+
+    void* ArenaAllocator::doAllocate(std::size_t size, std::size_t alignment)
+    {
+        auto align = [alignment](char* ptr) {
+            const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+            return ptr + ((alignment - address % alignment) % alignment);
+        };
+
+        char* block = align(m_next);
+        if (m_next == nullptr || block + size > m_end)
+        {
+            // the objects larger than a chunk get their own
+            const std::size_t chunk_size = std::max(m_chunk_size, size + alignment);
+            char* chunk = static_cast<char*>(std::malloc(chunk_size));
+            if (chunk == nullptr)
+                return nullptr;
+            m_chunks.emplace_back(chunk, chunk_size);
+
+            m_next = chunk;
+            m_end = chunk + chunk_size;
+            block = align(m_next);
+        }
+
+        m_next = block + size;
+        return block;
+    }
+
+    void ArenaAllocator::doDeallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept
+    {}
+}
+
+namespace Ark::internal
+{
+    AllocatorGuard::AllocatorGuard(Allocator* allocator) noexcept :
+        m_previous(current_allocator)
+    {
+        current_allocator = allocator;
+    }
+
+    AllocatorGuard::~AllocatorGuard()
+    {
+        current_allocator = m_previous;
+    }
+
+    MemoryMeter::MemoryMeter() noexcept :
+        m_allocator(current_allocator), m_charged(0)
+    {
+        if (m_allocator != nullptr)
+            m_allocator->hold();
+    }
+
+    MemoryMeter::MemoryMeter(const MemoryMeter&) noexcept :
+        MemoryMeter()
+    {}
+
+    MemoryMeter::~MemoryMeter()
+    {
+        if (m_allocator == nullptr)
+            return;
+
+        m_allocator->release(m_charged);
+        m_allocator->drop();
+    }
+}
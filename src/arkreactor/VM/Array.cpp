@@ -0,0 +1,25 @@
+#include <Ark/VM/Array.hpp>
+#include <Ark/VM/Allocator.hpp>
+
+#include <algorithm>
+
+namespace Ark::internal
+{
+    Array::Array() noexcept :
+        m_data(makeShared<std::vector<double>>())
+    {}
+
+    Array::Array(std::vector<double>&& data) noexcept :
+        m_data(makeShared<std::vector<double>>(std::move(data)))
+    {}
+
+    bool operator==(const Array& A, const Array& B) noexcept
+    {
+        return A.m_data == B.m_data || A.get() == B.get();
+    }
+
+    bool operator<(const Array& A, const Array& B) noexcept
+    {
+        return std::lexicographical_compare(A.get().begin(), A.get().end(), B.get().begin(), B.get().end());
+    }
+}
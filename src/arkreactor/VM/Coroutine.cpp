@@ -0,0 +1,314 @@
+#include <Ark/VM/VM.hpp>
+
+#include <thread>
+
+#ifdef ARK_OS_LINUX
+#    include <poll.h>
+#endif
+
+namespace Ark
+{
+    using namespace internal;
+
+    uint32_t VM::startCoroutine(const Value& function, std::vector<Value>&& args)
+    {
+        startScheduler();
+
+        const uint32_t id = m_scheduler->next_id++;
+        Coroutine& coroutine = m_scheduler->coroutines[id];
+        coroutine.function = function;
+        coroutine.arguments = std::move(args);
+
+        m_scheduler->ready.push_back(id);
+        return id;
+    }
+
+    Value VM::awaitCoroutine(uint32_t id)
+    {
+        if (m_scheduler == nullptr || m_scheduler->coroutines.count(id) == 0)
+            throwVMError("unknown coroutine " + std::to_string(id) + ", it may have been awaited already");
+        if (id == m_scheduler->current)
+            throwVMError("a coroutine can not await itself");
+
+        Coroutine& coroutine = m_scheduler->coroutines[id];
+        if (coroutine.status == Coroutine::Status::Done)
+        {
+            Value result = std::move(coroutine.result);
+            m_scheduler->coroutines.erase(id);
+            return result;
+        }
+
+        if (!canSuspend())
+            throwVMError("can not await a coroutine in a function called by a builtin");
+
+        coroutine.waiting.push_back(m_scheduler->current);
+        suspendCoroutine(Coroutine::Status::Waiting);
+        return Builtins::nil;
+    }
+
+    void VM::yieldCoroutine()
+    {
+        if (!canSuspend())
+            return;
+
+        // the sleeping and reading coroutines which can continue are also given a chance to run
+        if (wakeUpCoroutines(/* wait */ false))
+        {
+            m_scheduler->ready.push_back(m_scheduler->current);
+            suspendCoroutine(Coroutine::Status::Ready);
+        }
+    }
+
+    bool VM::sleepCoroutine(double milliseconds)
+    {
+        // when run by step, the host waits instead of the VM
+        if (m_stepping)
+            startScheduler();
+        if (!canSuspend())
+            return false;
+
+        const auto duration = std::chrono::duration<double, std::milli>(milliseconds);
+        m_scheduler->sleeping.emplace(Clock::now() + std::chrono::duration_cast<Clock::duration>(duration), m_scheduler->current);
+        suspendCoroutine(Coroutine::Status::Sleeping);
+        return true;
+    }
+
+    bool VM::readCoroutine(int fd, std::function<Value()> read)
+    {
+        if (m_stepping)
+            startScheduler();
+        if (!canSuspend())
+            return false;
+
+        m_scheduler->reading.push_back(Scheduler::PendingRead { m_scheduler->current, fd, std::move(read) });
+        suspendCoroutine(Coroutine::Status::Reading);
+        return true;
+    }
+
+    void VM::startScheduler()
+    {
+        if (m_scheduler != nullptr)
+            return;
+
+        m_scheduler = std::make_unique<Scheduler>();
+        m_scheduler->globals = m_locals[0];
+        m_scheduler->coroutines[0].status = Coroutine::Status::Running;
+    }
+
+    void VM::suspendCoroutine(Coroutine::Status status) noexcept
+    {
+        m_scheduler->coroutines[m_scheduler->current].status = status;
+        m_scheduler->switch_requested = true;
+        m_running = false;
+    }
+
+    bool VM::switchCoroutine()
+    {
+        if (!canSuspend())
+            return false;
+
+        Scheduler& scheduler = *m_scheduler;
+
+        while (true)
+        {
+            Coroutine& current = scheduler.coroutines[scheduler.current];
+
+            if (scheduler.switch_requested)
+                scheduler.switch_requested = false;
+            // the function of a coroutine returned, the main one is the only one running until the frame count
+            // given to execute, and the VM stops when it finished
+            else if (scheduler.current != 0 && m_running == false && m_fc == m_until_frame_count)
+            {
+                current.result = popAndResolve();
+                current.status = Coroutine::Status::Done;
+
+                for (uint32_t id : current.waiting)
+                {
+                    Coroutine& waiting = scheduler.coroutines[id];
+                    waiting.resume_value = current.result;
+                    waiting.status = Coroutine::Status::Ready;
+                    scheduler.ready.push_back(id);
+                }
+            }
+            else
+                return false;
+
+            // VM::step returns instead of waiting, the switch is done by the next step
+            if (m_stepping && !wakeUpCoroutines(/* wait */ false))
+            {
+                if (scheduler.sleeping.empty() && scheduler.reading.empty())
+                    throwVMError("every coroutine is waiting for another one to finish");
+
+                scheduler.switch_requested = true;
+                m_suspension = Suspension { m_until_frame_count };
+                m_suspension->blocked = true;
+                return false;
+            }
+
+            const uint32_t next = nextCoroutine();
+            if (next != scheduler.current)
+            {
+                if (current.status == Coroutine::Status::Done)
+                {
+                    // the result is kept for the coroutine awaiting it later, if it wasn't already given
+                    if (!current.waiting.empty())
+                        scheduler.coroutines.erase(scheduler.current);
+                }
+                else
+                    saveCoroutine(current);
+
+                scheduler.current = next;
+                loadCoroutine(scheduler.coroutines[next]);
+            }
+            Coroutine& coroutine = scheduler.coroutines[next];
+            coroutine.status = Coroutine::Status::Running;
+
+            // the value given by `await` or a read
+            if (coroutine.resume_value)
+            {
+                (*m_stack)[m_sp - 1] = std::move(*coroutine.resume_value);
+                coroutine.resume_value.reset();
+            }
+
+            // a builtin given to async returns right away, the coroutine is already finished
+            m_running = true;
+            if (m_fc > m_until_frame_count)
+                return true;
+            m_running = false;
+        }
+    }
+
+    uint32_t VM::nextCoroutine()
+    {
+        wakeUpCoroutines(/* wait */ true);
+
+        const uint32_t id = m_scheduler->ready.front();
+        m_scheduler->ready.pop_front();
+        return id;
+    }
+
+    bool VM::wakeUpCoroutines(bool wait)
+    {
+        Scheduler& scheduler = *m_scheduler;
+
+        while (true)
+        {
+            const Clock::time_point now = Clock::now();
+            while (!scheduler.sleeping.empty() && scheduler.sleeping.top().first <= now)
+            {
+                scheduler.ready.push_back(scheduler.sleeping.top().second);
+                scheduler.sleeping.pop();
+            }
+
+            if (!scheduler.reading.empty())
+            {
+                // wait for a file descriptor or the next coroutine waking up, whichever comes first
+                int timeout = 0;
+                if (wait && scheduler.ready.empty())
+                {
+                    if (scheduler.sleeping.empty())
+                        timeout = -1;
+                    else
+                        timeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(scheduler.sleeping.top().first - now).count());
+                }
+
+                std::vector<bool> readable(scheduler.reading.size(), true);
+#ifdef ARK_OS_LINUX
+                std::vector<pollfd> fds;
+                for (const Scheduler::PendingRead& pending : scheduler.reading)
+                    fds.push_back(pollfd { pending.fd, POLLIN, 0 });
+                const bool any = ::poll(fds.data(), fds.size(), timeout) > 0;
+                for (std::size_t i = 0; i < fds.size(); ++i)
+                    readable[i] = any && fds[i].revents != 0;
+#endif
+
+                for (std::size_t i = scheduler.reading.size(); i > 0; --i)
+                {
+                    if (!readable[i - 1])
+                        continue;
+
+                    Scheduler::PendingRead pending = std::move(scheduler.reading[i - 1]);
+                    scheduler.reading.erase(scheduler.reading.begin() + static_cast<std::ptrdiff_t>(i - 1));
+
+                    Coroutine& coroutine = scheduler.coroutines[pending.coroutine];
+                    coroutine.resume_value = pending.read();
+                    coroutine.status = Coroutine::Status::Ready;
+                    scheduler.ready.push_back(pending.coroutine);
+                }
+            }
+
+            if (!scheduler.ready.empty())
+                return true;
+            if (!wait)
+                return false;
+            if (scheduler.sleeping.empty() && scheduler.reading.empty())
+                throwVMError("every coroutine is waiting for another one to finish");
+
+            if (scheduler.reading.empty())
+                std::this_thread::sleep_until(scheduler.sleeping.top().first);
+        }
+    }
+
+    void VM::saveCoroutine(Coroutine& coroutine)
+    {
+        coroutine.stack.clear();
+        coroutine.stack.reserve(m_sp);
+        for (uint16_t i = 0; i < m_sp; ++i)
+        {
+            Value& value = (*m_stack)[i];
+            if (value.valueType() == ValueType::Reference)
+                coroutine.stack.push_back(*value.reference());
+            else
+                coroutine.stack.push_back(std::move(value));
+        }
+
+        coroutine.locals = std::move(m_locals);
+        coroutine.scope_count_to_delete = std::move(m_scope_count_to_delete);
+        coroutine.saved_scope = std::move(m_saved_scope);
+        m_saved_scope.reset();
+
+        coroutine.ip = m_ip;
+        coroutine.pp = m_pp;
+        coroutine.fc = m_fc;
+        coroutine.until_frame_count = m_until_frame_count;
+    }
+
+    void VM::loadCoroutine(Coroutine& coroutine)
+    {
+        if (coroutine.status == Coroutine::Status::Created)
+        {
+            m_sp = 0;
+            m_fc = 1;
+            m_until_frame_count = 1;
+            m_locals.clear();
+            m_locals.push_back(m_scheduler->globals);
+            m_scope_count_to_delete.assign(1, 0);
+            m_saved_scope.reset();
+
+            // call the function as VM::callback does, without running it here
+            const auto argc = static_cast<int16_t>(coroutine.arguments.size());
+            for (Value& arg : coroutine.arguments)
+                push(std::move(arg));
+            push(std::move(coroutine.function));
+            coroutine.arguments.clear();
+
+            m_last_sym_loaded = static_cast<uint16_t>(m_state->m_symbols.size());
+            call(argc);
+            m_ip = 0;
+            return;
+        }
+
+        m_sp = static_cast<uint16_t>(coroutine.stack.size());
+        std::move(coroutine.stack.begin(), coroutine.stack.end(), m_stack->begin());
+        coroutine.stack.clear();
+
+        m_locals = std::move(coroutine.locals);
+        m_scope_count_to_delete = std::move(coroutine.scope_count_to_delete);
+        m_saved_scope = std::move(coroutine.saved_scope);
+
+        m_ip = coroutine.ip;
+        m_pp = coroutine.pp;
+        m_fc = coroutine.fc;
+        m_until_frame_count = coroutine.until_frame_count;
+    }
+}
@@ -0,0 +1,231 @@
+#include <Ark/VM/CycleCollector.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace Ark::internal
+{
+    namespace
+    {
+        /**
+         * @brief An object owning values, shared through a std::shared_ptr
+         *
+         */
+        struct Node
+        {
+            enum class Kind
+            {
+                Scope,
+                List,
+                Dict,
+                Set,
+                Upvalue
+            };
+
+            Kind kind;
+            const void* object;   ///< Scope, std::vector<Value>, Dict, Set or Upvalue
+            long count;           ///< references from everywhere
+            long internal = 0;    ///< references from the values of the other nodes
+            bool alive = false;
+        };
+    }
+
+    CycleCollector::CycleCollector() noexcept :
+        m_threshold(ArkCycleCollectorThreshold)
+    {}
+
+    std::size_t CycleCollector::collect()
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        // most scopes were freed with their closure
+        purge();
+
+        // nodes are identified by the object shared by their std::shared_ptr, the scopes, list buffers and upvalues
+        // being the object themselves, while dictionaries and sets are read through one of the values holding them
+        std::unordered_map<const void*, Node> nodes;
+        std::vector<const void*> pending;
+
+        auto reach = [&](Node::Kind kind, const void* key, const void* object, long count, bool from_node) {
+            auto [it, inserted] = nodes.try_emplace(key, Node { kind, object, count });
+            if (from_node)
+                ++it->second.internal;
+            if (inserted)
+                pending.push_back(key);
+        };
+
+        // calls on_edge on each node directly referenced by a value
+        auto edges = [&](const Value& value, auto&& on_edge) {
+            switch (value.valueType())
+            {
+                case ValueType::Closure:
+                {
+                    const Scope_t& scope = value.closure().scope();
+                    if (scope)
+                        on_edge(Node::Kind::Scope, scope.get(), scope.get(), scope.use_count());
+                    break;
+                }
+
+                case ValueType::List:
+                {
+                    const auto& data = std::get<SharedList>(value.m_value).m_data;
+                    if (data)
+                        on_edge(Node::Kind::List, data.get(), data.get(), data.use_count());
+                    break;
+                }
+
+                case ValueType::Dict:
+                {
+                    const Dict& dict = std::get<Dict>(value.m_value);
+                    if (dict.m_table)
+                        on_edge(Node::Kind::Dict, dict.m_table.get(), &dict, dict.m_table.use_count());
+                    break;
+                }
+
+                case ValueType::Set:
+                {
+                    const Set& set = std::get<Set>(value.m_value);
+                    if (set.m_table)
+                        on_edge(Node::Kind::Set, set.m_table.get(), &set, set.m_table.use_count());
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        };
+
+        // calls on_edge on each node directly referenced by the values of a node
+        auto children = [&edges](const Node& node, auto&& on_edge) {
+            auto on_value = [&](const Value& value) { edges(value, on_edge); };
+
+            switch (node.kind)
+            {
+                case Node::Kind::Scope:
+                {
+                    const Scope* scope = static_cast<const Scope*>(node.object);
+                    for (const auto& [id, value] : scope->m_data)
+                        on_value(value);
+                    for (const auto& [id, upvalue] : scope->m_upvalues)
+                        on_edge(Node::Kind::Upvalue, upvalue.get(), upvalue.get(), upvalue.use_count());
+                    break;
+                }
+
+                case Node::Kind::List:
+                    for (const Value& value : *static_cast<const std::vector<Value>*>(node.object))
+                        on_value(value);
+                    break;
+
+                case Node::Kind::Dict:
+                    for (const auto& entry : static_cast<const Dict*>(node.object)->entries())
+                        on_value(entry.value);
+                    break;
+
+                case Node::Kind::Set:
+                    for (const auto& entry : static_cast<const Set*>(node.object)->entries())
+                        on_value(entry.key);
+                    break;
+
+                case Node::Kind::Upvalue:
+                {
+                    // an open upvalue is the variable of a frame, which is alive
+                    const Upvalue* upvalue = static_cast<const Upvalue*>(node.object);
+                    if (!upvalue->isOpen())
+                        on_value(*upvalue->get());
+                    break;
+                }
+            }
+        };
+
+        // build the graph reachable from the tracked scopes, counting the references found inside it. The scopes are
+        // kept alive during the collection, since the Reclaimer can destroy values on another thread
+        std::vector<Scope_t> roots;
+        roots.reserve(m_tracked.size());
+        for (const std::weak_ptr<Scope>& tracked : m_tracked)
+        {
+            if (Scope_t scope = tracked.lock(); scope != nullptr)
+            {
+                reach(Node::Kind::Scope, scope.get(), scope.get(), scope.use_count() - 1, false);
+                roots.push_back(std::move(scope));
+            }
+        }
+
+        while (!pending.empty())
+        {
+            const void* key = pending.back();
+            pending.pop_back();
+
+            children(nodes.at(key), [&](Node::Kind kind, const void* child, const void* object, long count) {
+                reach(kind, child, object, count, true);
+            });
+        }
+
+        // the nodes referenced from outside of the graph are alive, and so is everything they reach
+        for (auto& [key, node] : nodes)
+        {
+            if (node.count > node.internal && !node.alive)
+            {
+                node.alive = true;
+                pending.push_back(key);
+            }
+        }
+
+        while (!pending.empty())
+        {
+            const void* key = pending.back();
+            pending.pop_back();
+
+            children(nodes.at(key), [&](Node::Kind, const void* child, const void*, long) {
+                Node& node = nodes.at(child);
+                if (!node.alive)
+                {
+                    node.alive = true;
+                    pending.push_back(child);
+                }
+            });
+        }
+
+        // emptying the dead scopes breaks the cycles, their values are destroyed once no scope is read anymore
+        std::vector<Scope::Variables_t> garbage;
+        std::vector<std::vector<std::pair<uint16_t, Upvalue_t>>> garbage_upvalues;
+        for (auto& [key, node] : nodes)
+        {
+            if (!node.alive && node.kind == Node::Kind::Scope)
+            {
+                Scope* scope = const_cast<Scope*>(static_cast<const Scope*>(node.object));
+                garbage.push_back(std::move(scope->m_data));
+                garbage_upvalues.push_back(std::move(scope->m_upvalues));
+            }
+        }
+        nodes.clear();
+        roots.clear();
+        const std::size_t collected = garbage.size();
+        garbage.clear();
+        garbage_upvalues.clear();
+
+        purge();
+        m_threshold = std::max(ArkCycleCollectorThreshold, 2 * m_tracked.size());
+
+        const auto pause = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        ++m_stats.collections;
+        m_stats.scopes_collected += collected;
+        m_stats.last_pause = pause;
+        m_stats.max_pause = std::max(m_stats.max_pause, pause);
+        m_stats.total_pause += pause;
+
+        return collected;
+    }
+
+    void CycleCollector::purge()
+    {
+        m_tracked.erase(
+            std::remove_if(m_tracked.begin(), m_tracked.end(), [](const std::weak_ptr<Scope>& scope) { return scope.expired(); }),
+            m_tracked.end());
+    }
+
+    void CycleCollector::clear() noexcept
+    {
+        m_tracked.clear();
+        m_threshold = ArkCycleCollectorThreshold;
+    }
+}
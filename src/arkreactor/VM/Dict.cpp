@@ -0,0 +1,136 @@
+#include <Ark/VM/Dict.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Allocator.hpp>
+#include <Ark/VM/HashTable.hpp>
+#include <Ark/Exceptions.hpp>
+
+namespace Ark::internal
+{
+    struct Dict::Table : public HashTable<Dict::Entry>
+    {};
+
+    Dict::Dict() noexcept :
+        m_table(makeShared<Table>())
+    {}
+
+    std::size_t Dict::size() const noexcept
+    {
+        return m_table->entries.size();
+    }
+
+    const std::vector<Dict::Entry>& Dict::entries() const noexcept
+    {
+        return m_table->entries;
+    }
+
+    std::size_t Dict::bytes() const noexcept
+    {
+        return sizeof(Table) + m_table->bytes();
+    }
+
+    const Value* Dict::get(const Value& key) const
+    {
+        if (!isHashable(key))
+            return nullptr;
+
+        const int32_t i = m_table->position(key, Table::hashOf(key));
+        return (i >= 0) ? &m_table->entries[i].value : nullptr;
+    }
+
+    void Dict::set(const Value& key, const Value& value)
+    {
+        if (!isHashable(key))
+        {
+            if (key.valueType() == ValueType::Number)
+                throw TypeError("Dictionary keys can not be NaN");
+            throw TypeError("Dictionary keys should be Numbers or Strings, got " + types_to_str[static_cast<unsigned>(key.valueType())]);
+        }
+
+        Table& table = mut();
+        const std::size_t hash = Table::hashOf(key);
+        const std::size_t slot = table.prepare(key, hash);
+
+        if (int32_t i = table.index[slot]; i >= 0)
+            table.entries[i].value = value;
+        else
+            table.insert(slot, Entry { key, value, hash });
+    }
+
+    bool Dict::remove(const Value& key)
+    {
+        if (!isHashable(key))
+            return false;
+
+        const std::size_t hash = Table::hashOf(key);
+        if (m_table->position(key, hash) < 0)
+            return false;
+
+        Table& table = mut();
+        table.erase(table.find(key, hash));
+        return true;
+    }
+
+    bool Dict::isHashable(const Value& key) noexcept
+    {
+        // NaN is different from itself, it could never be found again
+        return (key.valueType() == ValueType::Number && !std::isnan(key.number())) || key.valueType() == ValueType::String;
+    }
+
+    Dict::Table& Dict::mut()
+    {
+        if (m_table.use_count() != 1)
+            m_table = makeShared<Table>(*m_table);
+        return *m_table;
+    }
+
+    bool operator==(const Dict& A, const Dict& B) noexcept
+    {
+        if (A.m_table == B.m_table)
+            return true;
+        if (A.size() != B.size())
+            return false;
+
+        for (const Dict::Entry& entry : A.entries())
+        {
+            const Value* value = B.get(entry.key);
+            if (value == nullptr || !(*value == entry.value))
+                return false;
+        }
+        return true;
+    }
+
+    bool operator<(const Dict& A, const Dict& B) noexcept
+    {
+        if (A.m_table == B.m_table)
+            return false;
+        if (A.size() != B.size())
+            return A.size() < B.size();
+
+        // compare the entries sorted by key, so that the order doesn't depend on the insertions, like operator==
+        auto sorted = [](const Dict& dict) {
+            std::vector<const Dict::Entry*> entries;
+            entries.reserve(dict.size());
+            for (const Dict::Entry& entry : dict.entries())
+                entries.push_back(&entry);
+            std::sort(entries.begin(), entries.end(), [](const Dict::Entry* a, const Dict::Entry* b) {
+                return a->key < b->key;
+            });
+            return entries;
+        };
+        const std::vector<const Dict::Entry*> a_entries = sorted(A), b_entries = sorted(B);
+
+        for (std::size_t i = 0, end = A.size(); i < end; ++i)
+        {
+            const Dict::Entry &a = *a_entries[i], &b = *b_entries[i];
+            if (a.key != b.key)
+                return a.key < b.key;
+            if (a.value != b.value)
+                return a.value < b.value;
+        }
+        return false;
+    }
+}
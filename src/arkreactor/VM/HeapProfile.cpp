@@ -0,0 +1,319 @@
+#include <Ark/VM/HeapProfile.hpp>
+
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+#include <Ark/VM/VM.hpp>
+
+namespace Ark
+{
+    using namespace internal;
+
+    HeapStats HeapProfile::total() const noexcept
+    {
+        HeapStats total = frames;
+        for (const HeapStats& stats : by_type)
+        {
+            total.count += stats.count;
+            total.shallow += stats.shallow;
+        }
+        total.retained = total.shallow;
+        return total;
+    }
+
+    void HeapProfile::write(std::ostream& os) const
+    {
+        auto line = [&os](const std::string& name, const HeapStats& stats) {
+            os << std::left << std::setw(12) << name << std::right
+               << " " << std::setw(10) << stats.count
+               << " " << std::setw(12) << stats.shallow
+               << " " << std::setw(12) << stats.retained << "\n";
+        };
+
+        os << "# objects by type\n";
+        os << "# type count shallow retained\n";
+        // true and false are both Bool
+        std::vector<std::pair<std::string, HeapStats>> types;
+        for (std::size_t i = 0; i < by_type.size(); ++i)
+        {
+            if (by_type[i].count == 0)
+                continue;
+
+            if (types.empty() || types.back().first != types_to_str[i])
+                types.emplace_back(types_to_str[i], HeapStats {});
+            HeapStats& stats = types.back().second;
+            stats.count += by_type[i].count;
+            stats.shallow += by_type[i].shallow;
+            stats.retained += by_type[i].retained;
+        }
+        for (const auto& [name, stats] : types)
+            line(name, stats);
+        if (frames.count != 0)
+            line("Frame", frames);
+        line("total", total());
+
+        os << "# closures by code page of their function\n";
+        os << "# page count shallow retained\n";
+        for (const auto& [page, stats] : closures)
+            line(std::to_string(page), stats);
+
+        os << "# global variables\n";
+        os << "# name retained\n";
+        for (const auto& [name, retained] : globals)
+            os << std::left << std::setw(24) << name << std::right << " " << std::setw(12) << retained << "\n";
+    }
+
+    HeapProfile VM::heapProfile() const
+    {
+        HeapProfile profile;
+        HeapWalker walker(profile);
+
+        // the global variables first, so that they're the ones retaining what they hold
+        const Scope_t globals = !m_locals.empty() ? m_locals[0] : (m_scheduler != nullptr ? m_scheduler->globals : nullptr);
+        if (globals != nullptr)
+            walker.walkFrame(globals, [&](uint16_t id, std::size_t retained) {
+                profile.globals[m_state->m_symbols[id]] += retained;
+            });
+
+        for (const Scope_t& scope : m_locals)
+            walker.walkFrame(scope);
+        if (m_saved_scope)
+            walker.walkFrame(m_saved_scope.value());
+        if (m_stack != nullptr)
+        {
+            for (uint16_t i = 0; i < m_sp; ++i)
+                walker.walk((*m_stack)[i]);
+        }
+
+        if (m_scheduler != nullptr)
+        {
+            // by id, to walk them in the same order from one run to another
+            std::map<uint32_t, const Coroutine*> coroutines;
+            for (const auto& [id, coroutine] : m_scheduler->coroutines)
+                coroutines.emplace(id, &coroutine);
+
+            for (const auto& [id, coroutine] : coroutines)
+            {
+                for (const Scope_t& scope : coroutine->locals)
+                    walker.walkFrame(scope);
+                if (coroutine->saved_scope)
+                    walker.walkFrame(coroutine->saved_scope.value());
+                for (const Value& value : coroutine->stack)
+                    walker.walk(value);
+                for (const Value& value : coroutine->arguments)
+                    walker.walk(value);
+                walker.walk(coroutine->function);
+                walker.walk(coroutine->result);
+                if (coroutine->resume_value)
+                    walker.walk(coroutine->resume_value.value());
+            }
+        }
+
+        for (const Value& value : m_state->m_constants)
+            walker.walk(value);
+
+        return profile;
+    }
+}
+
+namespace Ark::internal
+{
+    HeapWalker::HeapWalker(HeapProfile& profile) noexcept :
+        m_profile(profile)
+    {}
+
+    std::size_t HeapWalker::walk(const Value& value)
+    {
+        const ValueType type = value.valueType();
+        HeapStats& stats = m_profile.by_type[static_cast<std::size_t>(type)];
+        std::size_t shallow = 0;
+        std::size_t retained = 0;
+
+        // calls the walker on the values held by an object, which retains the ones only it holds
+        auto hold = [this, &retained](const Value& child) {
+            const std::size_t child_retained = walk(child);
+            if (isExclusive(child))
+                retained += child_retained;
+        };
+
+        switch (type)
+        {
+            case ValueType::List:
+            {
+                const auto& data = std::get<SharedList>(value.m_value).m_data;
+                if (!m_visited.insert(data.get()).second)
+                    return 0;
+
+                shallow = sizeof(std::vector<Value>) + data->capacity() * sizeof(Value);
+                for (const Value& element : *data)
+                    hold(element);
+                break;
+            }
+
+            // a short string is stored in the value itself
+            case ValueType::String:
+            {
+                const SharedString& str = value.string();
+                if (!str.isInline() && !m_visited.insert(str.buffer().get()).second)
+                    return 0;
+                shallow = str.capacity();
+                break;
+            }
+
+            case ValueType::Closure:
+            {
+                const Scope_t& scope = value.closure().scope();
+                HeapStats closure;
+                const std::size_t closure_retained = (scope != nullptr) ? walkScope(scope, closure, nullptr) : 0;
+                if (closure.count == 0)
+                    return 0;
+
+                HeapStats& page = m_profile.closures[value.closure().pageAddr()];
+                page.count += closure.count;
+                page.shallow += closure.shallow;
+                page.retained += closure.retained;
+
+                stats.count += closure.count;
+                stats.shallow += closure.shallow;
+                stats.retained += closure.retained;
+                return closure_retained;
+            }
+
+            case ValueType::User:
+            {
+                if (!m_visited.insert(value.usertype().data()).second)
+                    return 0;
+                shallow = value.usertype().reportedSize();
+                break;
+            }
+
+            case ValueType::Dict:
+            {
+                const Dict& dict = std::get<Dict>(value.m_value);
+                if (!m_visited.insert(dict.m_table.get()).second)
+                    return 0;
+
+                shallow = dict.bytes();
+                for (const Dict::Entry& entry : dict.entries())
+                {
+                    hold(entry.key);
+                    hold(entry.value);
+                }
+                break;
+            }
+
+            case ValueType::Set:
+            {
+                const Set& set = std::get<Set>(value.m_value);
+                if (!m_visited.insert(set.m_table.get()).second)
+                    return 0;
+
+                shallow = set.bytes();
+                for (const Set::Entry& entry : set.entries())
+                    hold(entry.key);
+                break;
+            }
+
+            case ValueType::Array:
+            {
+                const auto& data = std::get<Array>(value.m_value).m_data;
+                if (!m_visited.insert(data.get()).second)
+                    return 0;
+                shallow = sizeof(std::vector<double>) + data->capacity() * sizeof(double);
+                break;
+            }
+
+            // the variable referenced is held by a scope
+            case ValueType::Reference:
+                return 0;
+
+            default:
+                break;
+        }
+
+        retained += shallow;
+        ++stats.count;
+        stats.shallow += shallow;
+        stats.retained += retained;
+        return retained;
+    }
+
+    std::size_t HeapWalker::walkFrame(const Scope_t& scope, const std::function<void(uint16_t, std::size_t)>& on_variable)
+    {
+        return walkScope(scope, m_profile.frames, on_variable);
+    }
+
+    bool HeapWalker::isExclusive(const Value& value) noexcept
+    {
+        switch (value.valueType())
+        {
+            case ValueType::List:
+                return std::get<SharedList>(value.m_value).m_data.use_count() == 1;
+
+            case ValueType::Closure:
+                return value.closure().scope().use_count() == 1;
+
+            case ValueType::Dict:
+                return std::get<Dict>(value.m_value).m_table.use_count() == 1;
+
+            case ValueType::Set:
+                return std::get<Set>(value.m_value).m_table.use_count() == 1;
+
+            case ValueType::Array:
+                return std::get<Array>(value.m_value).m_data.use_count() == 1;
+
+            case ValueType::String:
+                return value.string().isInline() || value.string().buffer().use_count() == 1;
+
+            // the data of a UserType isn't owned by the values
+            case ValueType::User:
+                return false;
+
+            default:
+                return true;
+        }
+    }
+
+    std::size_t HeapWalker::walkScope(const Scope_t& scope, HeapStats& stats, const std::function<void(uint16_t, std::size_t)>& on_variable)
+    {
+        if (!m_visited.insert(scope.get()).second)
+            return 0;
+
+        std::size_t shallow = sizeof(Scope) +
+            scope->m_data.capacity() * sizeof(Scope::Variables_t::value_type) +
+            scope->m_upvalues.capacity() * sizeof(std::pair<uint16_t, Upvalue_t>) +
+            scope->m_open.capacity() * sizeof(Upvalue_t);
+        std::size_t retained = 0;
+
+        for (const auto& [id, value] : scope->m_data)
+        {
+            // a variable sharing its object with other values doesn't retain it
+            std::size_t value_retained = walk(value);
+            if (!isExclusive(value))
+                value_retained = 0;
+            retained += value_retained;
+            if (on_variable)
+                on_variable(id, value_retained);
+        }
+
+        // an open upvalue is a variable of the frame defining it, a closed one holds the value
+        for (const auto& [id, upvalue] : scope->m_upvalues)
+        {
+            if (upvalue->isOpen() || !m_visited.insert(upvalue.get()).second)
+                continue;
+
+            const Value& value = *upvalue->get();
+            const std::size_t value_retained = sizeof(Upvalue) + walk(value);
+            shallow += sizeof(Upvalue);
+            if (upvalue.use_count() == 1 && isExclusive(value))
+                retained += value_retained;
+        }
+
+        retained += shallow;
+        ++stats.count;
+        stats.shallow += shallow;
+        stats.retained += retained;
+        return retained;
+    }
+}
@@ -0,0 +1,841 @@
+#include <Ark/VM/JIT.hpp>
+
+#include <cstring>
+#include <cstdint>
+#include <tuple>
+
+#include <Ark/VM/VM.hpp>
+#include <Ark/Compiler/Instructions.hpp>
+
+#if defined(ARK_JIT) && (defined(__x86_64__) || defined(_M_X64))
+#    define ARK_JIT_X64
+#    if defined(ARK_OS_WINDOWS)
+#        define ARK_JIT_WIN64
+#    else
+#        include <sys/mman.h>
+#    endif
+#endif
+
+namespace Ark::internal
+{
+#ifdef ARK_JIT_X64
+    namespace
+    {
+        enum Reg : uint8_t
+        {
+            RAX = 0,
+            RCX,
+            RDX,
+            RBX,
+            RSP,
+            RBP,
+            RSI,
+            RDI,
+            R8,
+            R9,
+            R10,
+            R11,
+            R12,
+            R13,
+            R14,
+            R15
+        };
+
+        enum Cond : uint8_t
+        {
+            CondB = 0x2,
+            CondAE = 0x3,
+            CondE = 0x4,
+            CondNE = 0x5,
+            CondBE = 0x6,
+            CondA = 0x7,
+            CondP = 0xa,
+            CondNP = 0xb,
+            CondLE = 0xe
+        };
+
+        // registers holding the arguments, and space reserved for the callee by the caller
+#    ifdef ARK_JIT_WIN64
+        constexpr Reg Arg0 = RCX, Arg1 = RDX, Arg2 = R8;
+        constexpr uint8_t ShadowSpace = 32;
+#    else
+        constexpr Reg Arg0 = RDI, Arg1 = RSI, Arg2 = RDX;
+        constexpr uint8_t ShadowSpace = 0;
+#    endif
+
+        // registers used by the generated code, all callee saved on both ABIs
+        constexpr Reg VMReg = RBX;     ///< VM*
+        constexpr Reg StackReg = R12;  ///< Value* to the bottom of the stack
+        constexpr Reg SPReg = R13;     ///< cached copy of VM::m_sp
+
+        /**
+         * @brief Minimal x86-64 assembler, only knows the instructions needed by the JIT
+         *
+         */
+        class Assembler
+        {
+        public:
+            using Label = std::size_t;
+
+            Label newLabel()
+            {
+                m_labels.push_back(Unbound);
+                return m_labels.size() - 1;
+            }
+
+            void bind(Label label) { m_labels[label] = m_code.size(); }
+
+            std::size_t offset(Label label) const { return m_labels[label]; }
+
+            std::size_t size() const { return m_code.size(); }
+
+            const std::vector<uint8_t>& code() const { return m_code; }
+
+            void align(std::size_t alignment)
+            {
+                while (m_code.size() % alignment != 0)
+                    byte(0xcc);  // int3
+            }
+
+            void reserve(std::size_t count) { m_code.resize(m_code.size() + count, 0); }
+
+            /**
+             * @brief Patch every jump with the final position of its label
+             *
+             */
+            void resolve()
+            {
+                for (auto& [pos, label] : m_fixups)
+                {
+                    int32_t rel = static_cast<int32_t>(m_labels[label]) - static_cast<int32_t>(pos + 4);
+                    std::memcpy(&m_code[pos], &rel, sizeof(rel));
+                }
+            }
+
+            // ---------------- general purpose ----------------
+
+            void push(Reg r)
+            {
+                rex(false, 0, r);
+                byte(0x50 | (r & 7));
+            }
+
+            void pop(Reg r)
+            {
+                rex(false, 0, r);
+                byte(0x58 | (r & 7));
+            }
+
+            void ret() { byte(0xc3); }
+
+            void mov(Reg dst, Reg src)
+            {
+                rex(true, src, dst);
+                byte(0x89);
+                modrm(3, src, dst);
+            }
+
+            void movsxd(Reg dst, Reg src)
+            {
+                rex(true, dst, src);
+                byte(0x63);
+                modrm(3, dst, src);
+            }
+
+            void movImm32(Reg dst, uint32_t imm)
+            {
+                rex(false, 0, dst);
+                byte(0xb8 | (dst & 7));
+                u32(imm);
+            }
+
+            void movImm64(Reg dst, uint64_t imm)
+            {
+                rex(true, 0, dst);
+                byte(0xb8 | (dst & 7));
+                for (int i = 0; i < 8; ++i)
+                    byte(static_cast<uint8_t>(imm >> (8 * i)));
+            }
+
+            void load(Reg dst, Reg base, int32_t disp)
+            {
+                rex(true, dst, base);
+                byte(0x8b);
+                mem(dst, base, disp);
+            }
+
+            void lea(Reg dst, Reg base, int32_t disp)
+            {
+                rex(true, dst, base);
+                byte(0x8d);
+                mem(dst, base, disp);
+            }
+
+            void leaRip(Reg dst, Label label)
+            {
+                rex(true, dst, 0);
+                byte(0x8d);
+                modrm(0, dst, 5);
+                fixup(label);
+            }
+
+            void movzxByte(Reg dst, Reg base, int32_t disp)
+            {
+                rex(false, dst, base);
+                byte(0x0f);
+                byte(0xb6);
+                mem(dst, base, disp);
+            }
+
+            void movzxByte(Reg dst, Reg src)
+            {
+                rex(false, dst, src);
+                byte(0x0f);
+                byte(0xb6);
+                modrm(3, dst, src);
+            }
+
+            void movzxWord(Reg dst, Reg base, int32_t disp)
+            {
+                rex(false, dst, base);
+                byte(0x0f);
+                byte(0xb7);
+                mem(dst, base, disp);
+            }
+
+            void storeWord(Reg base, int32_t disp, Reg src)
+            {
+                byte(0x66);
+                rex(false, src, base);
+                byte(0x89);
+                mem(src, base, disp);
+            }
+
+            void storeByteImm(Reg base, int32_t disp, uint8_t imm)
+            {
+                rex(false, 0, base);
+                byte(0xc6);
+                mem(0, base, disp);
+                byte(imm);
+            }
+
+            void storeDwordImm(Reg base, int32_t disp, uint32_t imm)
+            {
+                rex(false, 0, base);
+                byte(0xc7);
+                mem(0, base, disp);
+                u32(imm);
+            }
+
+            /// sub qword [base + disp], imm
+            void subMemImm32(Reg base, int32_t disp, int32_t imm)
+            {
+                rex(true, 0, base);
+                byte(0x81);
+                mem(5, base, disp);
+                u32(static_cast<uint32_t>(imm));
+            }
+
+            void add(Reg dst, Reg src)
+            {
+                rex(true, src, dst);
+                byte(0x01);
+                modrm(3, src, dst);
+            }
+
+            void imul(Reg dst, Reg src, int32_t imm)
+            {
+                rex(true, dst, src);
+                byte(0x69);
+                modrm(3, dst, src);
+                u32(static_cast<uint32_t>(imm));
+            }
+
+            void andImm(Reg r, uint8_t imm) { aluImm8(false, 4, r, imm); }
+            void subImm(Reg r, uint8_t imm) { aluImm8(false, 5, r, imm); }
+            void cmpImm(Reg r, uint8_t imm) { aluImm8(false, 7, r, imm); }
+            void addImm64(Reg r, uint8_t imm) { aluImm8(true, 0, r, imm); }
+            void subImm64(Reg r, uint8_t imm) { aluImm8(true, 5, r, imm); }
+
+            void cmpImm64(Reg r, int32_t imm)
+            {
+                rex(true, 0, r);
+                byte(0x81);
+                modrm(3, 7, r);
+                u32(static_cast<uint32_t>(imm));
+            }
+
+            // only for al, cl, dl, bl
+            void setcc(Cond cc, Reg r)
+            {
+                byte(0x0f);
+                byte(0x90 | cc);
+                modrm(3, 0, r);
+            }
+
+            void and8(Reg dst, Reg src)
+            {
+                byte(0x20);
+                modrm(3, src, dst);
+            }
+
+            void or8(Reg dst, Reg src)
+            {
+                byte(0x08);
+                modrm(3, src, dst);
+            }
+
+            void test8(Reg a, Reg b)
+            {
+                byte(0x84);
+                modrm(3, b, a);
+            }
+
+            // ---------------- scalar doubles ----------------
+
+            void movsdLoad(uint8_t xmm, Reg base, int32_t disp)
+            {
+                byte(0xf2);
+                rex(false, xmm, base);
+                byte(0x0f);
+                byte(0x10);
+                mem(xmm, base, disp);
+            }
+
+            void movsdStore(Reg base, int32_t disp, uint8_t xmm)
+            {
+                byte(0xf2);
+                rex(false, xmm, base);
+                byte(0x0f);
+                byte(0x11);
+                mem(xmm, base, disp);
+            }
+
+            void movsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x10, dst, src); }
+            void addsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x58, dst, src); }
+            void mulsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x59, dst, src); }
+            void subsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x5c, dst, src); }
+            void divsd(uint8_t dst, uint8_t src) { sse(0xf2, 0x5e, dst, src); }
+            void ucomisd(uint8_t a, uint8_t b) { sse(0x66, 0x2e, a, b); }
+            void xorpd(uint8_t dst, uint8_t src) { sse(0x66, 0x57, dst, src); }
+
+            // ---------------- control flow ----------------
+
+            void jmp(Label label)
+            {
+                byte(0xe9);
+                fixup(label);
+            }
+
+            void jcc(Cond cc, Label label)
+            {
+                byte(0x0f);
+                byte(0x80 | cc);
+                fixup(label);
+            }
+
+            /// jmp qword [rax + rcx * 8]
+            void jmpTable()
+            {
+                byte(0xff);
+                modrm(0, 4, 4);
+                byte((3 << 6) | (RCX << 3) | RAX);
+            }
+
+            void call(const void* function)
+            {
+                movImm64(RAX, reinterpret_cast<uint64_t>(function));
+                byte(0xff);
+                modrm(3, 2, RAX);
+            }
+
+        private:
+            static constexpr std::size_t Unbound = ~static_cast<std::size_t>(0);
+
+            std::vector<uint8_t> m_code;
+            std::vector<std::size_t> m_labels;
+            std::vector<std::pair<std::size_t, Label>> m_fixups;
+
+            void byte(uint8_t b) { m_code.push_back(b); }
+
+            void u32(uint32_t v)
+            {
+                for (int i = 0; i < 4; ++i)
+                    byte(static_cast<uint8_t>(v >> (8 * i)));
+            }
+
+            void fixup(Label label)
+            {
+                m_fixups.emplace_back(m_code.size(), label);
+                u32(0);
+            }
+
+            void rex(bool w, uint8_t reg, uint8_t rm)
+            {
+                uint8_t r = 0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0);
+                if (r != 0x40)
+                    byte(r);
+            }
+
+            void modrm(uint8_t mod, uint8_t reg, uint8_t rm)
+            {
+                byte(static_cast<uint8_t>((mod << 6) | ((reg & 7) << 3) | (rm & 7)));
+            }
+
+            void mem(uint8_t reg, Reg base, int32_t disp)
+            {
+                modrm(2, reg, base);
+                if ((base & 7) == RSP)  // rsp and r12 need a SIB byte
+                    byte(0x24);
+                u32(static_cast<uint32_t>(disp));
+            }
+
+            void aluImm8(bool w, uint8_t op, Reg r, uint8_t imm)
+            {
+                rex(w, 0, r);
+                byte(0x83);
+                modrm(3, op, r);
+                byte(imm);
+            }
+
+            void sse(uint8_t prefix, uint8_t op, uint8_t dst, uint8_t src)
+            {
+                byte(prefix);
+                byte(0x0f);
+                byte(op);
+                modrm(3, dst, src);
+            }
+        };
+
+        void* allocateCode(std::size_t size)
+        {
+#    ifdef ARK_JIT_WIN64
+            return VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#    else
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return memory == MAP_FAILED ? nullptr : memory;
+#    endif
+        }
+
+        bool makeExecutable(void* memory, std::size_t size)
+        {
+#    ifdef ARK_JIT_WIN64
+            DWORD old;
+            return VirtualProtect(memory, size, PAGE_EXECUTE_READ, &old) != 0;
+#    else
+            return mprotect(memory, size, PROT_READ | PROT_EXEC) == 0;
+#    endif
+        }
+
+        void releaseCode(void* memory, [[maybe_unused]] std::size_t size)
+        {
+#    ifdef ARK_JIT_WIN64
+            VirtualFree(memory, 0, MEM_RELEASE);
+#    else
+            munmap(memory, size);
+#    endif
+        }
+    }
+#endif
+
+    JIT::JIT(VM* vm) noexcept
+    {
+        Value number(1.0);
+        Value ref(&number);
+
+        auto diff = [](const void* a, const void* b) {
+            return static_cast<int32_t>(reinterpret_cast<const char*>(a) - reinterpret_cast<const char*>(b));
+        };
+
+        m_layout.value_size = static_cast<int32_t>(sizeof(Value));
+        m_layout.type = diff(&number.m_const_type, &number);
+        m_layout.number = diff(std::get_if<double>(&number.m_value), &number);
+        m_layout.reference = diff(std::get_if<Value*>(&ref.m_value), &ref);
+        m_layout.vm_sp = diff(&vm->m_sp, vm);
+        m_layout.vm_ip = diff(&vm->m_ip, vm);
+        m_layout.vm_countdown = diff(&vm->m_countdown, vm);
+    }
+
+    JIT::~JIT()
+    {
+#ifdef ARK_JIT_X64
+        for (auto& block : m_blocks)
+            releaseCode(block.memory, block.size);
+#endif
+    }
+
+    bool JIT::available() noexcept
+    {
+#ifdef ARK_JIT_X64
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    NativePage_t JIT::hit(const bytecode_t& page, std::size_t page_id)
+    {
+        if (page_id >= m_calls.size())
+            m_calls.resize(page_id + 1, 0);
+
+        // compile only once, when reaching the threshold
+        if (++m_calls[page_id] != ArkJITCallThreshold)
+            return nullptr;
+        return compile(page);
+    }
+
+    NativePage_t JIT::compile([[maybe_unused]] const bytecode_t& page)
+    {
+#ifdef ARK_JIT_X64
+        using Label = Assembler::Label;
+
+        const Layout& L = m_layout;
+        const std::size_t size = page.size();
+        Assembler a;
+
+        // find the instructions boundaries, each one of them getting a label
+        std::vector<bool> is_start(size, false);
+        for (std::size_t i = 0; i < size; i += instructionSize(page[i]))
+            is_start[i] = true;
+
+        std::vector<Label> labels(size);
+        for (std::size_t i = 0; i < size; ++i)
+            labels[i] = a.newLabel();
+
+        // exits setting the instruction pointer, generated at the end
+        std::vector<std::pair<std::size_t, Label>> exits;
+        auto exitAt = [&](std::size_t ip) -> Label {
+            for (auto& [pos, label] : exits)
+            {
+                if (pos == ip)
+                    return label;
+            }
+            exits.emplace_back(ip, a.newLabel());
+            return exits.back().second;
+        };
+        auto target = [&](std::size_t ip) -> Label {
+            return (ip < size && is_start[ip]) ? labels[ip] : exitAt(ip);
+        };
+        // jumps going backward count the instructions of the loop against the budget of the VM, and exit when it's spent
+        std::vector<std::tuple<std::size_t, int32_t, Label>> back_edges;
+        auto branch = [&](std::size_t from, std::size_t to) -> Label {
+            if (to > from || to >= size || !is_start[to])
+                return target(to);
+
+            int32_t cost = 0;
+            for (std::size_t i = to; i <= from; i += instructionSize(page[i]))
+                ++cost;
+            back_edges.emplace_back(to, cost, a.newLabel());
+            return std::get<2>(back_edges.back());
+        };
+        auto argument = [&](std::size_t ip) -> uint16_t {
+            return static_cast<uint16_t>((static_cast<uint16_t>(page[ip + 1]) << 8) + page[ip + 2]);
+        };
+
+        const Label epilogue = a.newLabel();
+        const Label table = a.newLabel();
+
+        // ---------------- prologue ----------------
+        a.push(VMReg);
+        a.push(StackReg);
+        a.push(SPReg);
+        if constexpr (ShadowSpace != 0)
+            a.subImm64(RSP, ShadowSpace);
+        a.mov(VMReg, Arg0);
+        a.mov(StackReg, Arg1);
+        a.movsxd(RCX, Arg2);
+        a.movzxWord(SPReg, VMReg, L.vm_sp);
+        a.cmpImm64(RCX, static_cast<int32_t>(size));
+        a.jcc(CondAE, epilogue);
+        a.leaRip(RAX, table);
+        a.jmpTable();
+
+        // rax = &stack[sp]
+        auto stackTop = [&]() {
+            a.imul(RAX, SPReg, L.value_size);
+            a.add(RAX, StackReg);
+        };
+        // dst = the value at [rax + disp], resolved if it's a reference. ecx = its type
+        auto resolve = [&](Reg dst, int32_t disp) {
+            const Label direct = a.newLabel();
+            a.movzxByte(RCX, RAX, disp + L.type);
+            a.andImm(RCX, 0x7f);
+            a.lea(dst, RAX, disp);
+            a.cmpImm(RCX, static_cast<uint8_t>(ValueType::Reference));
+            a.jcc(CondNE, direct);
+            a.load(dst, RAX, disp + L.reference);
+            a.movzxByte(RCX, dst, L.type);
+            a.andImm(RCX, 0x7f);
+            a.bind(direct);
+        };
+        // xmm0 = a, xmm1 = b, both being numbers, or exit
+        auto loadNumbers = [&](std::size_t ip) {
+            stackTop();
+            resolve(RDX, -L.value_size);
+            a.cmpImm(RCX, static_cast<uint8_t>(ValueType::Number));
+            a.jcc(CondNE, exitAt(ip));
+            resolve(R8, -2 * L.value_size);
+            a.cmpImm(RCX, static_cast<uint8_t>(ValueType::Number));
+            a.jcc(CondNE, exitAt(ip));
+            a.movsdLoad(1, RDX, L.number);
+            a.movsdLoad(0, R8, L.number);
+        };
+        // calls a NativeOps helper working on the VM, with the stack pointer synchronized
+        auto callHelper = [&](const void* function, uint16_t id) {
+            a.storeWord(VMReg, L.vm_sp, SPReg);
+            a.mov(Arg0, VMReg);
+            a.movImm32(Arg1, id);
+            a.call(function);
+            a.movzxWord(SPReg, VMReg, L.vm_sp);
+        };
+
+        const void* load_symbol = reinterpret_cast<const void*>(&NativeOps::loadSymbol);
+        const void* load_const = reinterpret_cast<const void*>(&NativeOps::loadConst);
+        const void* store = reinterpret_cast<const void*>(&NativeOps::store);
+        const void* builtin = reinterpret_cast<const void*>(&NativeOps::builtin);
+        const void* set_number = reinterpret_cast<const void*>(&NativeOps::setNumber);
+        const void* set_bool = reinterpret_cast<const void*>(&NativeOps::setBool);
+
+        std::vector<bool> compiled(size, false);
+
+        // ---------------- body ----------------
+        for (std::size_t ip = 0; ip < size; ip += instructionSize(page[ip]))
+        {
+            const uint8_t inst = page[ip];
+            const std::size_t next = ip + instructionSize(inst);
+            a.bind(labels[ip]);
+            compiled[ip] = true;
+
+            switch (inst)
+            {
+                case Instruction::NOP:
+                    break;
+
+                case Instruction::LOAD_SYMBOL:
+                    callHelper(load_symbol, argument(ip));
+                    a.test8(RAX, RAX);
+                    a.jcc(CondE, exitAt(ip));
+                    break;
+
+                case Instruction::STORE:
+                    callHelper(store, argument(ip));
+                    a.test8(RAX, RAX);
+                    a.jcc(CondE, exitAt(ip));
+                    break;
+
+                case Instruction::LOAD_CONST:
+                    callHelper(load_const, argument(ip));
+                    a.test8(RAX, RAX);
+                    a.jcc(CondE, exitAt(ip));
+                    break;
+
+                case Instruction::BUILTIN:
+                    callHelper(builtin, argument(ip));
+                    break;
+
+                case Instruction::JUMP:
+                    a.jmp(branch(ip, argument(ip)));
+                    break;
+
+                case Instruction::POP_JUMP_IF_TRUE:
+                case Instruction::POP_JUMP_IF_FALSE:
+                    stackTop();
+                    resolve(RDX, -L.value_size);
+                    a.subImm(SPReg, 1);
+                    a.cmpImm(RCX, static_cast<uint8_t>(inst == Instruction::POP_JUMP_IF_TRUE ? ValueType::True : ValueType::False));
+                    a.jcc(CondE, branch(ip, argument(ip)));
+                    break;
+
+                case Instruction::ADD:
+                case Instruction::SUB:
+                case Instruction::MUL:
+                case Instruction::DIV:
+                {
+                    loadNumbers(ip);
+                    if (inst == Instruction::ADD)
+                        a.addsd(0, 1);
+                    else if (inst == Instruction::SUB)
+                        a.subsd(0, 1);
+                    else if (inst == Instruction::MUL)
+                        a.mulsd(0, 1);
+                    else
+                    {
+                        // the interpreter raises a ZeroDivisionError, but lets NaN through
+                        const Label non_zero = a.newLabel();
+                        a.xorpd(2, 2);
+                        a.ucomisd(1, 2);
+                        a.jcc(CondP, non_zero);
+                        a.jcc(CondE, exitAt(ip));
+                        a.bind(non_zero);
+                        a.divsd(0, 1);
+                    }
+
+                    // a number can be overwritten in place, anything else goes through the variant
+                    const Label slow = a.newLabel(), done = a.newLabel();
+                    const int32_t slot = -2 * L.value_size;
+                    a.movzxByte(RCX, RAX, slot + L.type);
+                    a.andImm(RCX, 0x7f);
+                    a.cmpImm(RCX, static_cast<uint8_t>(ValueType::Number));
+                    a.jcc(CondNE, slow);
+                    a.movsdStore(RAX, slot + L.number, 0);
+                    a.storeByteImm(RAX, slot + L.type, static_cast<uint8_t>(ValueType::Number));
+                    a.jmp(done);
+                    a.bind(slow);
+                    a.lea(Arg0, RAX, slot);
+#    ifdef ARK_JIT_WIN64
+                    a.movsd(1, 0);
+#    endif
+                    a.call(set_number);
+                    a.bind(done);
+                    a.subImm(SPReg, 1);
+                    break;
+                }
+
+                case Instruction::GT:
+                case Instruction::LT:
+                case Instruction::LE:
+                case Instruction::GE:
+                case Instruction::NEQ:
+                case Instruction::EQ:
+                {
+                    loadNumbers(ip);
+
+                    // fuse with a conditional jump right after, if any
+                    const bool fused = next < size && (page[next] == Instruction::POP_JUMP_IF_TRUE || page[next] == Instruction::POP_JUMP_IF_FALSE);
+                    const bool jump_if = fused && page[next] == Instruction::POP_JUMP_IF_TRUE;
+
+                    // the arithmetic on the stack pointer would clobber the flags
+                    if (fused)
+                        a.subImm(SPReg, 2);
+
+                    if (inst == Instruction::EQ || inst == Instruction::NEQ)
+                        a.ucomisd(0, 1);
+                    else  // mimic the NaN handling of the interpreter, which builds >, <= and >= on top of < and ==
+                        a.ucomisd(1, 0);
+
+                    if (fused)
+                    {
+                        const std::size_t after = next + instructionSize(page[next]);
+                        const Label taken = branch(next, argument(next)), not_taken = target(after);
+
+                        // the condition is true if we need to jump
+                        bool equal = inst == Instruction::EQ;
+                        switch (inst)
+                        {
+                            case Instruction::LT: a.jcc(jump_if ? CondA : CondBE, taken); break;
+                            case Instruction::LE: a.jcc(jump_if ? CondAE : CondB, taken); break;
+                            case Instruction::GT: a.jcc(jump_if ? CondB : CondAE, taken); break;
+                            case Instruction::GE: a.jcc(jump_if ? CondBE : CondA, taken); break;
+                            default:
+                                if (equal == jump_if)  // jump if ordered and equal
+                                {
+                                    a.jcc(CondP, not_taken);
+                                    a.jcc(CondE, taken);
+                                }
+                                else  // jump if unordered or not equal
+                                {
+                                    a.jcc(CondP, taken);
+                                    a.jcc(CondNE, taken);
+                                }
+                                break;
+                        }
+                        a.jmp(not_taken);
+                    }
+                    else
+                    {
+                        switch (inst)
+                        {
+                            case Instruction::LT: a.setcc(CondA, RAX); break;
+                            case Instruction::LE: a.setcc(CondAE, RAX); break;
+                            case Instruction::GT: a.setcc(CondB, RAX); break;
+                            case Instruction::GE: a.setcc(CondBE, RAX); break;
+                            case Instruction::EQ:
+                                a.setcc(CondE, RAX);
+                                a.setcc(CondNP, RCX);
+                                a.and8(RAX, RCX);
+                                break;
+                            default:
+                                a.setcc(CondNE, RAX);
+                                a.setcc(CondP, RCX);
+                                a.or8(RAX, RCX);
+                                break;
+                        }
+                        a.movzxByte(Arg1, RAX);
+                        a.imul(Arg0, SPReg, L.value_size);
+                        a.add(Arg0, StackReg);
+                        a.lea(Arg0, Arg0, -2 * L.value_size);
+                        a.call(set_bool);
+                        a.subImm(SPReg, 1);
+                    }
+                    break;
+                }
+
+                default:
+                    // handed back to the interpreter
+                    compiled[ip] = false;
+                    a.storeDwordImm(VMReg, L.vm_ip, static_cast<uint32_t>(ip));
+                    a.jmp(epilogue);
+                    break;
+            }
+        }
+        // falling off the end of the page, shouldn't happen since pages end with RET or HALT
+        a.storeDwordImm(VMReg, L.vm_ip, static_cast<uint32_t>(size));
+        a.jmp(epilogue);
+
+        for (auto& [to, cost, label] : back_edges)
+        {
+            a.bind(label);
+            a.subMemImm32(VMReg, L.vm_countdown, cost);
+            a.jcc(CondLE, exitAt(to));
+            a.jmp(labels[to]);
+        }
+
+        for (std::size_t i = 0; i < exits.size(); ++i)
+        {
+            a.bind(exits[i].second);
+            a.storeDwordImm(VMReg, L.vm_ip, static_cast<uint32_t>(exits[i].first));
+            a.jmp(epilogue);
+        }
+
+        // ---------------- epilogue ----------------
+        a.bind(epilogue);
+        a.storeWord(VMReg, L.vm_sp, SPReg);
+        if constexpr (ShadowSpace != 0)
+            a.addImm64(RSP, ShadowSpace);
+        a.pop(SPReg);
+        a.pop(StackReg);
+        a.pop(VMReg);
+        a.ret();
+
+        // dispatch table, one entry per byte of the page
+        a.align(8);
+        a.bind(table);
+        a.reserve(size * sizeof(uint64_t));
+        a.resolve();
+
+        const std::size_t code_size = a.size();
+        void* memory = allocateCode(code_size);
+        if (memory == nullptr)
+            return nullptr;
+
+        std::memcpy(memory, a.code().data(), code_size);
+        uint8_t* base = static_cast<uint8_t*>(memory);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            uint64_t entry = reinterpret_cast<uint64_t>(base + a.offset((is_start[i] && compiled[i]) ? labels[i] : epilogue));
+            std::memcpy(base + a.offset(table) + i * sizeof(uint64_t), &entry, sizeof(entry));
+        }
+
+        if (!makeExecutable(memory, code_size))
+        {
+            releaseCode(memory, code_size);
+            return nullptr;
+        }
+
+        m_blocks.push_back(CodeBlock { memory, code_size });
+        return reinterpret_cast<NativePage_t>(memory);
+#else
+        return nullptr;
+#endif
+    }
+}
@@ -0,0 +1,311 @@
+#include <Ark/VM/VM.hpp>
+
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+
+namespace Ark
+{
+    using namespace internal;
+
+    namespace internal
+    {
+        /**
+         * @brief Values, results and chunks shared by the workers of VM::parallelMap
+         *
+         */
+        struct ParallelMapJob
+        {
+            Value function;
+            std::vector<std::pair<uint16_t, Value>> variables;  ///< copies of the variables visible from the caller
+            const std::vector<Value>* values;
+            std::vector<Value> results;
+            void* user_pointer;
+            std::size_t chunk_size;
+            std::atomic<std::size_t> next = 0;  ///< first value of the next chunk to take
+            std::atomic<bool> failed = false;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+    }
+
+    std::vector<Value> VM::parallelMap(const Value& function, const std::vector<Value>& values, std::size_t workers)
+    {
+        const Value& fn = function.valueType() == ValueType::Reference ? *function.reference() : function;
+        if (!fn.isFunction())
+            throw TypeError("Can't map a " + types_to_str[static_cast<int>(fn.valueType())] + " in parallel, it isn't a Function");
+
+        const std::vector<bool> modified = modifiedSymbols();
+        if (auto reason = untransferableReason(fn, modified))
+            throwVMError("Can't call a function in parallel if " + reason.value());
+
+        if (values.empty())
+            return {};
+
+        // The workers share a single copy of the function and of the variables, which doesn't have slices, and in
+        // which nothing can be modified in place: the variables which can be modified (and the closures capturing
+        // them) are left out, since each worker would modify its own version. The lists, dicts, sets and arrays are
+        // copied on write, as their buffers are shared.
+        ParallelMapJob job;
+        job.function = deepCopy(fn);
+        std::vector<bool> visible(m_state->m_symbols.size(), false);
+        for (auto scope = m_locals.rbegin(), end = m_locals.rend(); scope != end; ++scope)
+        {
+            (*scope)->forEach([&](uint16_t id, const Value& value) {
+                if (!visible[id] && (value.isConst() || !modified[id]) && !untransferableReason(value, modified))
+                    job.variables.emplace_back(id, deepCopy(value));
+                visible[id] = true;
+            });
+        }
+        job.values = &values;
+        job.results.resize(values.size());
+        job.user_pointer = m_user_pointer;
+
+        if (workers == 0)
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        workers = std::min(workers, values.size());
+        // a few chunks per worker, for the ones finishing early to take the chunks left by the slower ones
+        job.chunk_size = std::max<std::size_t>(1, values.size() / (workers * 4));
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (std::size_t i = 1; i < workers; ++i)
+        {
+            try
+            {
+                threads.emplace_back([this, &job]() {
+                    VM worker(m_state);
+                    worker.parallelMapWorker(job);
+                });
+            }
+            catch (const std::system_error&)
+            {
+                // continue with the workers we already have
+                break;
+            }
+        }
+
+        // this thread works too instead of waiting
+        {
+            VM worker(m_state);
+            worker.parallelMapWorker(job);
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        if (job.error)
+            std::rethrow_exception(job.error);
+        return std::move(job.results);
+    }
+
+    std::vector<Value> VM::parallelMap(const std::string& name, const std::vector<Value>& values, std::size_t workers)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), name);
+        if (it == m_state->m_symbols.end())
+            throwVMError("unbound variable: " + name);
+
+        Value* var = findNearestVariable(static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it)));
+        if (var == nullptr)
+            throwVMError("Couldn't find variable " + name);
+
+        return parallelMap(*var, values, workers);
+    }
+
+    std::vector<bool> VM::modifiedSymbols() const
+    {
+        std::vector<bool> modified(m_state->m_symbols.size(), false);
+
+        for (const bytecode_t& page : m_state->m_pages)
+        {
+            std::size_t previous = page.size();
+            for (std::size_t i = 0; i < page.size(); i += instructionSize(page[i]))
+            {
+                const uint8_t inst = page[i];
+
+                // the list or dict modified by an in place instruction is its first argument, loaded right before it
+                if (inst == Instruction::APPEND_IN_PLACE || inst == Instruction::CONCAT_IN_PLACE ||
+                    inst == Instruction::POP_LIST_IN_PLACE || inst == Instruction::DICT_SET_IN_PLACE ||
+                    inst == Instruction::DICT_REMOVE_IN_PLACE)
+                {
+                    if (previous < page.size() && page[previous] == Instruction::LOAD_SYMBOL)
+                        modified[(static_cast<uint16_t>(page[previous + 1]) << 8) + page[previous + 2]] = true;
+                }
+                else if ((inst == Instruction::STORE || inst == Instruction::DEL) && i + 2 < page.size())
+                    modified[(static_cast<uint16_t>(page[i + 1]) << 8) + page[i + 2]] = true;
+
+                previous = i;
+            }
+        }
+
+        return modified;
+    }
+
+    std::optional<std::string> VM::untransferableReason(const Value& value, const std::vector<bool>& modified) const
+    {
+        switch (value.valueType())
+        {
+            case ValueType::List:
+                for (const Value& element : value.listView())
+                {
+                    if (auto reason = untransferableReason(element, modified))
+                        return reason;
+                }
+                break;
+
+            case ValueType::Dict:
+                for (const Dict::Entry& entry : value.dict().entries())
+                {
+                    if (auto reason = untransferableReason(entry.value, modified))
+                        return reason;
+                }
+                break;
+
+            case ValueType::Set:
+                for (const Set::Entry& entry : value.set().entries())
+                {
+                    if (auto reason = untransferableReason(entry.key, modified))
+                        return reason;
+                }
+                break;
+
+            case ValueType::Closure:
+            {
+                std::optional<std::string> reason;
+                value.closure().scope()->forEach([&](uint16_t id, const Value& captured) {
+                    if (reason)
+                        return;
+                    if (!captured.isConst() && modified[id])
+                        reason = "it captures the mutable variable '" + m_state->m_symbols[id] + "'";
+                    else
+                        reason = untransferableReason(captured, modified);
+                });
+                if (reason)
+                    return reason;
+                break;
+            }
+
+            case ValueType::User:
+                return "it holds a UserType, which can't be shared between threads"s;
+
+            case ValueType::Reference:
+                return untransferableReason(*value.reference(), modified);
+
+            default:
+                break;
+        }
+
+        return std::nullopt;
+    }
+
+    Value VM::deepCopy(const Value& value, bool usertypes)
+    {
+        Value copy;
+
+        switch (value.valueType())
+        {
+            case ValueType::List:
+            {
+                std::vector<Value> elements;
+                elements.reserve(value.listView().size());
+                for (const Value& element : value.listView())
+                    elements.push_back(deepCopy(element, usertypes));
+                copy = Value(std::move(elements));
+                break;
+            }
+
+            case ValueType::Dict:
+            {
+                Dict dict;
+                for (const Dict::Entry& entry : value.dict().entries())
+                    dict.set(deepCopy(entry.key, usertypes), deepCopy(entry.value, usertypes));
+                copy = Value(std::move(dict));
+                break;
+            }
+
+            case ValueType::Set:
+            {
+                Set set;
+                for (const Set::Entry& entry : value.set().entries())
+                    set.insert(deepCopy(entry.key, usertypes));
+                copy = Value(std::move(set));
+                break;
+            }
+
+            case ValueType::Array:
+                copy = Value(Array(std::vector<double>(value.array().get())));
+                break;
+
+            case ValueType::Closure:
+            {
+                Scope_t scope = makeShared<Scope>();
+                value.closure().scope()->forEach([&scope, usertypes](uint16_t id, const Value& captured) {
+                    scope->push_back(id, deepCopy(captured, usertypes));
+                });
+                copy = Value(Closure(std::move(scope), value.closure().pageAddr()));
+                break;
+            }
+
+            case ValueType::User:
+                if (!usertypes)
+                    throw std::runtime_error("A UserType can't be shared between threads");
+                return value;
+
+            case ValueType::Reference:
+                return deepCopy(*value.reference(), usertypes);
+
+            default:
+                return value;
+        }
+
+        copy.setConst(value.isConst());
+        return copy;
+    }
+
+    void VM::parallelMapWorker(ParallelMapJob& job)
+    {
+        try
+        {
+            init();
+            m_user_pointer = job.user_pointer;
+
+            Scope& globals = *m_locals[0];
+            for (const auto& [id, value] : job.variables)
+            {
+                if (!globals.has(id))
+                    globals.push_back(id, value);
+            }
+
+            const std::size_t size = job.values->size();
+            m_running = true;
+
+            std::size_t begin;
+            while (!job.failed && (begin = job.next.fetch_add(job.chunk_size)) < size)
+            {
+                const std::size_t end = std::min(begin + job.chunk_size, size);
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    // the arguments are copied since they can be slices of the caller's lists, the results
+                    // aren't used before all the workers are done
+                    job.results[i] = callback(job.function, deepCopy((*job.values)[i]));
+                    if (!m_running)
+                        throwVMError("Can't exit the VM from a function called in parallel");
+                }
+            }
+
+            m_running = false;
+        }
+        catch (...)
+        {
+            m_running = false;
+
+            const std::lock_guard<std::mutex> lock(job.error_mutex);
+            if (!job.error)
+                job.error = std::current_exception();
+            job.failed = true;
+        }
+    }
+}
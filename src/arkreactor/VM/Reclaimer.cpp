@@ -0,0 +1,110 @@
+#include <Ark/VM/Reclaimer.hpp>
+
+namespace Ark::internal
+{
+    Reclaimer::Reclaimer() noexcept :
+        m_stop(false), m_taken(0)
+    {}
+
+    Reclaimer::~Reclaimer()
+    {
+        if (!m_thread.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake_up.notify_one();
+        m_thread.join();
+    }
+
+    bool Reclaimer::take(Value& value)
+    {
+        if (!isLarge(value))
+            return false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(value));
+        }
+        value = Value();
+        ++m_taken;
+
+        if (!m_thread.joinable())
+            m_thread = std::thread(&Reclaimer::run, this);
+        m_wake_up.notify_one();
+        return true;
+    }
+
+    void Reclaimer::takeFrom(const Scope_t& scope)
+    {
+        // an open upvalue would be closed on an empty variable
+        if (scope.use_count() != 1 || !scope->m_open.empty())
+            return;
+
+        for (auto& [id, value] : scope->m_data)
+            take(value);
+    }
+
+    bool Reclaimer::isLarge(const Value& value) noexcept
+    {
+        switch (value.valueType())
+        {
+            case ValueType::List:
+            {
+                const SharedList& list = std::get<SharedList>(value.m_value);
+                return list.m_data != nullptr && list.m_data.use_count() == 1 && list.m_data->size() >= ArkReclaimerThreshold;
+            }
+
+            case ValueType::Dict:
+            {
+                const Dict& dict = std::get<Dict>(value.m_value);
+                return dict.m_table.use_count() == 1 && dict.size() >= ArkReclaimerThreshold;
+            }
+
+            case ValueType::Set:
+            {
+                const Set& set = std::get<Set>(value.m_value);
+                return set.m_table.use_count() == 1 && set.size() >= ArkReclaimerThreshold;
+            }
+
+            case ValueType::Closure:
+            {
+                // the scope of a closure is destroyed with it if it isn't shared
+                const Scope_t& scope = value.closure().scope();
+                if (scope.use_count() != 1 || !scope->m_open.empty())
+                    return false;
+
+                for (const auto& [id, captured] : scope->m_data)
+                {
+                    if (isLarge(captured))
+                        return true;
+                }
+                return false;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    void Reclaimer::run()
+    {
+        std::vector<Value> values;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake_up.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+                if (m_queue.empty())
+                    return;
+                values.swap(m_queue);
+            }
+
+            // destroyed without holding the lock, the VM can keep adding values
+            values.clear();
+        }
+    }
+}
@@ -0,0 +1,329 @@
+#include <Ark/VM/RegisterVM.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <Ark/Exceptions.hpp>
+#include <Ark/Builtins/Builtins.hpp>
+
+namespace Ark
+{
+    using namespace internal;
+
+    RegisterVM::RegisterVM(const RegisterCompiler& compiler) noexcept :
+        m_compiler(compiler), m_executed(0), m_no_value(Builtins::nil)
+    {}
+
+    int RegisterVM::run() noexcept
+    {
+        m_globals.assign(m_compiler.m_globals.size(), Value());
+        m_frames.clear();
+        m_executed = 0;
+
+        try
+        {
+            safeRun();
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%s\n", e.what());
+            return 1;
+        }
+        catch (...)
+        {
+            std::printf("Unknown error\n");
+            return 1;
+        }
+
+        return 0;
+    }
+
+    Value& RegisterVM::operator[](const std::string& name) noexcept
+    {
+        const std::vector<std::string>& globals = m_compiler.m_globals;
+
+        auto it = std::find(globals.begin(), globals.end(), name);
+        if (it == globals.end() || m_globals.size() != globals.size())
+        {
+            m_no_value = Builtins::nil;
+            return m_no_value;
+        }
+        return m_globals[static_cast<std::size_t>(std::distance(globals.begin(), it))];
+    }
+
+    unsigned long long RegisterVM::executedInstructions() const noexcept
+    {
+        return m_executed;
+    }
+
+    void RegisterVM::safeRun()
+    {
+        const std::vector<RegisterPage>& pages = m_compiler.m_pages;
+        const Value* k = m_compiler.m_constants.data();
+
+        std::size_t page = 0, ip = 0, base = 0;
+        m_registers.assign(std::max<std::size_t>(pages[0].registers, 256), Value());
+
+        const RegisterInst* code = pages[page].code.data();
+        Value* r = m_registers.data();
+
+        // RK operands refer either to a register or to a constant
+#define rk(operand) (((operand) & RegisterConstantBit) ? k[(operand) & ~RegisterConstantBit] : r[(operand)])
+
+        while (true)
+        {
+            const RegisterInst& inst = code[ip++];
+            ++m_executed;
+
+            switch (inst.op)
+            {
+                case R_NOP:
+                    break;
+
+                case R_LOADK:
+                    r[inst.a] = k[inst.b];
+                    break;
+
+                case R_MOVE:
+                    r[inst.a] = r[inst.b];
+                    break;
+
+                case R_GETG:
+                {
+                    const Value& global = m_globals[inst.b];
+                    if (global.valueType() == ValueType::Undefined)
+                        throwVMError("unbound variable: " + m_compiler.m_globals[inst.b]);
+                    r[inst.a] = global;
+                    break;
+                }
+
+                case R_SETG:
+                    m_globals[inst.a] = rk(inst.b);
+                    break;
+
+                case R_JUMP:
+                    ip = inst.a;
+                    break;
+
+                case R_JUMPT:
+                    if (rk(inst.a) == Builtins::trueSym)
+                        ip = inst.b;
+                    break;
+
+                case R_JUMPF:
+                    if (rk(inst.a) == Builtins::falseSym)
+                        ip = inst.b;
+                    break;
+
+                case R_CALL:
+                {
+                    const Value& function = r[inst.a];
+
+                    if (function.valueType() == ValueType::CProc)
+                    {
+                        std::vector<Value> args(r + inst.a + 1, r + inst.a + 1 + inst.b);
+                        r[inst.a] = function.proc()(args, nullptr);
+                        break;
+                    }
+                    else if (function.valueType() != ValueType::PageAddr)
+                        throwVMError("Can't call a " + types_to_str[static_cast<int>(function.valueType())] + ": it isn't a Function");
+
+                    const std::size_t new_page = function.pageAddr();
+                    if (pages[new_page].arity != inst.b)
+                        throwVMError(
+                            "Function needs " + std::to_string(pages[new_page].arity) +
+                            " arguments, but it received " + std::to_string(inst.b));
+                    if (m_frames.size() >= MaxFrames)
+                        throwVMError("maximum recursion depth exceeded");
+
+                    m_frames.push_back(Frame { page, ip, base });
+
+                    // the registers of the callee start with its arguments
+                    base += inst.a + 1;
+                    if (const std::size_t needed = base + pages[new_page].registers; needed > m_registers.size())
+                        m_registers.resize(std::max(needed, 2 * m_registers.size()));
+
+                    page = new_page;
+                    ip = 0;
+                    code = pages[page].code.data();
+                    r = m_registers.data() + base;
+                    break;
+                }
+
+                case R_RET:
+                {
+                    if (m_frames.empty())
+                        return;
+
+                    // the result goes in the register which was holding the function
+                    m_registers[base - 1] = rk(inst.a);
+
+                    const Frame& frame = m_frames.back();
+                    page = frame.page;
+                    ip = frame.ip;
+                    base = frame.base;
+                    m_frames.pop_back();
+
+                    code = pages[page].code.data();
+                    r = m_registers.data() + base;
+                    break;
+                }
+
+                case R_HALT:
+                    return;
+
+                case R_ADD:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+
+                    if (a.valueType() == ValueType::Number)
+                    {
+                        if (b.valueType() != ValueType::Number)
+                            throw TypeError("Arguments of + should have the same type");
+
+                        r[inst.a] = Value(a.number() + b.number());
+                        break;
+                    }
+                    else if (a.valueType() == ValueType::String)
+                    {
+                        if (b.valueType() != ValueType::String)
+                            throw TypeError("Arguments of + should have the same type");
+
+                        r[inst.a] = Value(a.string() + b.string());
+                        break;
+                    }
+                    throw TypeError("Arguments of + should be Numbers or Strings");
+                }
+
+                case R_SUB:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+
+                    if (a.valueType() != ValueType::Number || b.valueType() != ValueType::Number)
+                        throw TypeError("Arguments of - should be Numbers");
+
+                    r[inst.a] = Value(a.number() - b.number());
+                    break;
+                }
+
+                case R_MUL:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+
+                    if (a.valueType() != ValueType::Number || b.valueType() != ValueType::Number)
+                        throw TypeError("Arguments of * should be Numbers");
+
+                    r[inst.a] = Value(a.number() * b.number());
+                    break;
+                }
+
+                case R_DIV:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+
+                    if (a.valueType() != ValueType::Number || b.valueType() != ValueType::Number)
+                        throw TypeError("Arguments of / should be Numbers");
+
+                    auto d = b.number();
+                    if (d == 0)
+                        throw ZeroDivisionError();
+
+                    r[inst.a] = Value(a.number() / d);
+                    break;
+                }
+
+                case R_MOD:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+
+                    if (a.valueType() != ValueType::Number || b.valueType() != ValueType::Number)
+                        throw TypeError("Arguments of mod should be Numbers");
+
+                    r[inst.a] = Value(std::fmod(a.number(), b.number()));
+                    break;
+                }
+
+                case R_GT:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = (!(a == b) && !(a < b)) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_LT:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = (a < b) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_LE:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = ((a < b) || (a == b)) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_GE:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = !(a < b) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_NEQ:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = (a != b) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_EQ:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = (a == b) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_AND:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = (a == Builtins::trueSym && b == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_OR:
+                {
+                    const Value &a = rk(inst.b), &b = rk(inst.c);
+                    r[inst.a] = (a == Builtins::trueSym || b == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+                }
+
+                case R_NOT:
+                    r[inst.a] = !rk(inst.b) ? Builtins::trueSym : Builtins::falseSym;
+                    break;
+
+                case R_TO_STR:
+                {
+                    std::stringstream ss;
+                    ss << rk(inst.b);
+                    r[inst.a] = Value(ss.str());
+                    break;
+                }
+
+                default:
+                    throwVMError("unknown instruction: " + std::to_string(static_cast<std::size_t>(inst.op)));
+            }
+        }
+
+#undef rk
+    }
+
+    void RegisterVM::throwVMError(const std::string& message)
+    {
+        throw std::runtime_error(message);
+    }
+}
@@ -5,9 +5,45 @@
 
 namespace Ark::internal
 {
-    Scope::Scope() noexcept
+    Upvalue::Upvalue(Scope* frame, std::size_t index) noexcept :
+        m_frame(frame), m_index(index)
     {}
 
+    void Upvalue::close() noexcept
+    {
+        if (m_frame == nullptr)
+            return;
+
+        m_closed = std::move(m_frame->m_data[m_index].second);
+        m_frame = nullptr;
+    }
+
+    Scope::Scope() noexcept :
+        m_data(Variables_t::allocator_type(Allocator::current()))
+    {}
+
+    Scope::Scope(const Scope& other) :
+        m_data(other.m_data, Variables_t::allocator_type(Allocator::current())), m_upvalues(other.m_upvalues)
+    {}
+
+    Scope& Scope::operator=(const Scope& other)
+    {
+        // the variables of the upvalues may not exist anymore
+        for (Upvalue_t& upvalue : m_open)
+            upvalue->close();
+        m_open.clear();
+
+        m_data = other.m_data;
+        m_upvalues = other.m_upvalues;
+        return *this;
+    }
+
+    Scope::~Scope()
+    {
+        for (Upvalue_t& upvalue : m_open)
+            upvalue->close();
+    }
+
     void Scope::push_back(uint16_t id, Value&& val) noexcept
     {
         push_pair(std::move(id), std::move(val));
@@ -18,6 +54,35 @@ namespace Ark::internal
         push_pair(id, val);
     }
 
+    void Scope::capture(uint16_t id, const Upvalue_t& upvalue)
+    {
+        m_upvalues.emplace_back(id, upvalue);
+    }
+
+    Upvalue_t Scope::upvalue(uint16_t id)
+    {
+        for (std::size_t i = 0, end = m_data.size(); i < end; ++i)
+        {
+            if (m_data[i].first != id)
+                continue;
+
+            // closures capturing the same variable share it
+            for (const Upvalue_t& upvalue : m_open)
+            {
+                if (upvalue->m_index == i)
+                    return upvalue;
+            }
+            return m_open.emplace_back(makeShared<Upvalue>(this, i));
+        }
+
+        for (const auto& [upvalue_id, upvalue] : m_upvalues)
+        {
+            if (upvalue_id == id)
+                return upvalue;
+        }
+        return nullptr;
+    }
+
     bool Scope::has(uint16_t id) noexcept
     {
         return operator[](id) != nullptr;
@@ -30,6 +95,11 @@ namespace Ark::internal
             if (m_data[i].first == id)
                 return &m_data[i].second;
         }
+        for (std::size_t i = 0, end = m_upvalues.size(); i < end; ++i)
+        {
+            if (m_upvalues[i].first == id)
+                return m_upvalues[i].second->get();
+        }
         return nullptr;
     }
 
@@ -45,6 +115,6 @@ namespace Ark::internal
 
     const std::size_t Scope::size() const noexcept
     {
-        return m_data.size();
+        return m_data.size() + m_upvalues.size();
     }
 }
@@ -0,0 +1,110 @@
+#include <Ark/VM/Set.hpp>
+
+#include <algorithm>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Allocator.hpp>
+#include <Ark/VM/HashTable.hpp>
+
+namespace Ark::internal
+{
+    struct Set::Table : public HashTable<Set::Entry>
+    {};
+
+    Set::Set() noexcept :
+        m_table(makeShared<Table>())
+    {}
+
+    std::size_t Set::size() const noexcept
+    {
+        return m_table->entries.size();
+    }
+
+    const std::vector<Set::Entry>& Set::entries() const noexcept
+    {
+        return m_table->entries;
+    }
+
+    std::size_t Set::bytes() const noexcept
+    {
+        return sizeof(Table) + m_table->bytes();
+    }
+
+    bool Set::contains(const Value& value) const noexcept
+    {
+        return m_table->position(value, Table::hashOf(value)) >= 0;
+    }
+
+    bool Set::insert(const Value& value)
+    {
+        const std::size_t hash = Table::hashOf(value);
+        if (m_table->position(value, hash) >= 0)
+            return false;
+
+        Table& table = mut();
+        table.insert(table.prepare(value, hash), Entry { value, hash });
+        return true;
+    }
+
+    bool Set::remove(const Value& value)
+    {
+        const std::size_t hash = Table::hashOf(value);
+        if (m_table->position(value, hash) < 0)
+            return false;
+
+        Table& table = mut();
+        table.erase(table.find(value, hash));
+        return true;
+    }
+
+    Set::Table& Set::mut()
+    {
+        if (m_table.use_count() != 1)
+            m_table = makeShared<Table>(*m_table);
+        return *m_table;
+    }
+
+    bool operator==(const Set& A, const Set& B) noexcept
+    {
+        if (A.m_table == B.m_table)
+            return true;
+        if (A.size() != B.size())
+            return false;
+
+        for (const Set::Entry& entry : A.entries())
+        {
+            if (!B.contains(entry.key))
+                return false;
+        }
+        return true;
+    }
+
+    bool operator<(const Set& A, const Set& B) noexcept
+    {
+        if (A.m_table == B.m_table)
+            return false;
+        if (A.size() != B.size())
+            return A.size() < B.size();
+
+        // compare the values sorted, so that the order doesn't depend on the insertions, like operator==
+        auto sorted = [](const Set& set) {
+            std::vector<const Value*> values;
+            values.reserve(set.size());
+            for (const Set::Entry& entry : set.entries())
+                values.push_back(&entry.key);
+            std::sort(values.begin(), values.end(), [](const Value* a, const Value* b) {
+                return *a < *b;
+            });
+            return values;
+        };
+        const std::vector<const Value*> a_values = sorted(A), b_values = sorted(B);
+
+        for (std::size_t i = 0, end = A.size(); i < end; ++i)
+        {
+            const Value &a = *a_values[i], &b = *b_values[i];
+            if (a != b)
+                return a < b;
+        }
+        return false;
+    }
+}
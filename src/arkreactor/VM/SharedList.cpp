@@ -0,0 +1,74 @@
+#include <Ark/VM/SharedList.hpp>
+
+#include <algorithm>
+
+#include <Ark/VM/Value.hpp>
+#include <Ark/VM/Allocator.hpp>
+
+namespace Ark::internal
+{
+    namespace
+    {
+        /**
+         * @brief Elements of a list, with the memory they take counted by the allocator which created the list
+         *
+         */
+        struct Buffer : public std::vector<Value>
+        {
+            using std::vector<Value>::vector;
+
+            explicit Buffer(std::vector<Value>&& elements) noexcept :
+                std::vector<Value>(std::move(elements))
+            {}
+
+            MemoryMeter meter;
+        };
+    }
+
+    SharedList::SharedList() noexcept :
+        m_data(makeShared<Buffer>()), m_offset(0), m_size(Whole)
+    {}
+
+    SharedList::SharedList(std::vector<Value>&& data) noexcept :
+        m_data(makeShared<Buffer>(std::move(data))), m_offset(0), m_size(Whole)
+    {
+        measure();
+    }
+
+    SharedList::SharedList(const std::shared_ptr<std::vector<Value>>& data, uint32_t offset, uint32_t size) noexcept :
+        m_data(data), m_offset(offset), m_size(size)
+    {}
+
+    SharedList SharedList::view(std::size_t offset, std::size_t length) const noexcept
+    {
+        if (offset == 0 && length == size())
+            return *this;
+        return SharedList(m_data, m_offset + static_cast<uint32_t>(offset), static_cast<uint32_t>(length));
+    }
+
+    void SharedList::detach() const
+    {
+        m_data = makeShared<Buffer>(begin(), end());
+        m_offset = 0;
+        m_size = Whole;
+    }
+
+    void SharedList::measure() const noexcept
+    {
+        static_cast<Buffer&>(*m_data).meter.update(m_data->capacity() * sizeof(Value));
+    }
+
+    bool operator==(const SharedList& A, const SharedList& B) noexcept
+    {
+        if (A.begin() == B.begin() && A.size() == B.size())
+            return true;
+        return std::equal(A.begin(), A.end(), B.begin(), B.end());
+    }
+
+    bool operator<(const SharedList& A, const SharedList& B) noexcept
+    {
+        if (A.begin() == B.begin() && A.size() == B.size())
+            return false;
+        return std::lexicographical_compare(A.begin(), A.end(), B.begin(), B.end());
+    }
+}
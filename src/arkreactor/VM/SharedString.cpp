@@ -0,0 +1,270 @@
+#include <Ark/VM/SharedString.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <Ark/VM/Allocator.hpp>
+
+namespace Ark::internal
+{
+    namespace
+    {
+        /**
+         * @brief Characters of a string, with the memory they take counted by the allocator which created the string
+         *
+         */
+        template <typename T>
+        struct Metered : public T
+        {
+            template <typename... Args>
+            explicit Metered(Args&&... args) :
+                T(std::forward<Args>(args)...)
+            {
+                meter.update(T::text.size());
+            }
+
+            MemoryMeter meter;
+        };
+
+        // the capacity of the first buffer of a string which is appended to
+        constexpr std::size_t MinCapacity = 64;
+    }
+
+    SharedString::Buffer::Buffer(std::string_view first, std::string_view second, std::size_t capacity) :
+        text(capacity + 1, '\0'), used(static_cast<uint32_t>(first.size() + second.size()))
+    {
+        std::copy(first.begin(), first.end(), text.begin());
+        std::copy(second.begin(), second.end(), text.begin() + first.size());
+    }
+
+    SharedString::SharedString() noexcept
+    {
+        std::memset(m_storage, 0, StorageSize);
+    }
+
+    SharedString::SharedString(std::string_view str)
+    {
+        assign(str, {}, str.size());
+    }
+
+    SharedString::SharedString(const char* str)
+    {
+        std::string_view view(str);
+        assign(view, {}, view.size());
+    }
+
+    SharedString::SharedString(const std::string& str)
+    {
+        assign(str, {}, str.size());
+    }
+
+    SharedString::SharedString(const SharedString& other) noexcept
+    {
+        std::memcpy(m_storage, other.m_storage, StorageSize);
+        if (!other.isInline())
+            new (m_storage) std::shared_ptr<Buffer>(other.buffer());
+    }
+
+    SharedString::SharedString(SharedString&& other) noexcept
+    {
+        std::memcpy(m_storage, other.m_storage, StorageSize);
+        if (!other.isInline())
+        {
+            new (m_storage) std::shared_ptr<Buffer>(std::move(other.buffer()));
+
+            // the moved from string is left empty, not holding a null buffer
+            other.release();
+            std::memset(other.m_storage, 0, StorageSize);
+        }
+    }
+
+    SharedString& SharedString::operator=(const SharedString& other) noexcept
+    {
+        if (this != &other)
+        {
+            SharedString copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    SharedString& SharedString::operator=(SharedString&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            new (this) SharedString(std::move(other));
+        }
+        return *this;
+    }
+
+    SharedString::~SharedString()
+    {
+        release();
+    }
+
+    void SharedString::release() noexcept
+    {
+        if (!isInline())
+            buffer().~shared_ptr();
+    }
+
+    void SharedString::assign(std::string_view first, std::string_view second, std::size_t capacity, bool allocator)
+    {
+        const std::size_t size = first.size() + second.size();
+        if (size <= InlineCapacity)
+        {
+            std::memset(m_storage, 0, StorageSize);
+            std::memcpy(m_storage, first.data(), first.size());
+            std::memcpy(m_storage + first.size(), second.data(), second.size());
+            m_storage[StorageSize - 1] = static_cast<char>(size);
+            return;
+        }
+
+        if (size > UINT32_MAX)
+            throw std::length_error("string too long: " + std::to_string(size) + " bytes");
+        capacity = std::min<std::size_t>(std::max(capacity, size), UINT32_MAX);
+
+        if (allocator)
+            new (m_storage) std::shared_ptr<Buffer>(makeShared<Metered<Buffer>>(first, second, capacity));
+        else
+            new (m_storage) std::shared_ptr<Buffer>(std::make_shared<Buffer>(first, second, capacity));
+        setLength(static_cast<uint32_t>(size));
+        setStart(0);
+        m_storage[StorageSize - 1] = static_cast<char>(Shared);
+    }
+
+    void SharedString::detach() const
+    {
+        SharedString copy;
+        copy.assign(view(), {}, size());
+        const_cast<SharedString&>(*this) = std::move(copy);
+    }
+
+    void SharedString::append(std::string_view str)
+    {
+        if (str.empty())
+            return;
+
+        const std::size_t size = this->size() + str.size();
+        if (!isInline() && size <= UINT32_MAX)
+        {
+            Buffer& buf = *buffer();
+            const std::size_t new_end = start() + size;
+            uint32_t end = start() + length();
+
+            // claim the room after the string, if no other string was written there
+            if (new_end < buf.text.size() && buf.table == 0 && buf.used.compare_exchange_strong(end, static_cast<uint32_t>(new_end)))
+            {
+                std::copy(str.begin(), str.end(), buf.text.begin() + end);
+                buf.text[new_end] = '\0';
+                setLength(static_cast<uint32_t>(size));
+                return;
+            }
+        }
+
+        // str may be a view on this string, it's copied before the buffer is released
+        SharedString grown;
+        grown.assign(view(), str, std::max(2 * size, MinCapacity));
+        *this = std::move(grown);
+    }
+
+    int SharedString::find(const SharedString& str) const noexcept
+    {
+        std::size_t pos = view().find(str.view());
+        return (pos == std::string_view::npos) ? -1 : static_cast<int>(pos);
+    }
+
+    SharedString SharedString::substr(std::size_t pos, std::size_t length) const
+    {
+        if (pos == 0 && length >= size())
+            return *this;
+
+        // a table only holds whole strings, they are compared by buffer
+        const std::string_view part = view().substr(pos, length);
+        if (part.size() <= InlineCapacity || interned() || start() + pos > MaxStart)
+            return SharedString(part);
+
+        SharedString result(*this);
+        result.setStart(static_cast<uint32_t>(start() + pos));
+        result.setLength(static_cast<uint32_t>(part.size()));
+        return result;
+    }
+
+    bool SharedString::interned() const noexcept
+    {
+        return !isInline() && buffer()->table != 0;
+    }
+
+    std::size_t SharedString::capacity() const noexcept
+    {
+        return isInline() ? 0 : buffer()->text.size();
+    }
+
+    SharedString operator+(const SharedString& A, const SharedString& B)
+    {
+        SharedString result(A);
+        result.append(B.view());
+        return result;
+    }
+
+    bool operator==(const SharedString& A, const SharedString& B) noexcept
+    {
+        // the inline strings are padded with zeros and followed by their size, a short string is never in a buffer
+        if (A.isInline() || B.isInline())
+            return std::memcmp(A.m_storage, B.m_storage, SharedString::StorageSize) == 0;
+
+        if (A.length() != B.length())
+            return false;
+
+        const SharedString::Buffer* a = A.buffer().get();
+        const SharedString::Buffer* b = B.buffer().get();
+        if (a == b && A.start() == B.start())
+            return true;
+        // a table has a single buffer for each string
+        if (a->table != 0 && a->table == b->table)
+            return false;
+        return A.view() == B.view();
+    }
+
+    bool operator<(const SharedString& A, const SharedString& B) noexcept
+    {
+        return A.view() < B.view();
+    }
+
+    std::ostream& operator<<(std::ostream& os, const SharedString& S) noexcept
+    {
+        os << S.view();
+        return os;
+    }
+
+    // --------------------------
+
+    StringTable::StringTable() noexcept
+    {
+        static std::atomic<uint32_t> tables = 0;
+        m_id = ++tables;
+    }
+
+    SharedString StringTable::intern(std::string_view str)
+    {
+        if (str.size() <= SharedString::InlineCapacity)
+            return SharedString(str);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (auto it = m_strings.find(str); it != m_strings.end())
+            return it->second;
+
+        SharedString interned;
+        interned.assign(str, {}, str.size(), /* allocator= */ false);
+        interned.buffer()->table = m_id;
+        return m_strings.emplace(interned.view(), interned).first->second;
+    }
+
+    std::size_t StringTable::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_strings.size();
+    }
+}
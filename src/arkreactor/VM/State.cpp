@@ -200,6 +200,32 @@ namespace Ark
         m_libdir = libDir;
     }
 
+    bool State::loadNativePages(const std::string& module)
+    {
+        using namespace internal;
+
+        try
+        {
+            auto library = std::make_shared<SharedLibrary>(module);
+            const NativeModule* native = library->template get<const NativeModule* (*)()>("getNativePages")();
+
+            if (m_hash.empty() || native->hash != m_hash)
+                throwStateError("the native pages of '" + module + "' were generated from another program");
+            if (native->count != m_pages.size())
+                throwStateError("the native pages of '" + module + "' don't match the code pages");
+
+            m_native_pages.assign(native->pages, native->pages + native->count);
+            m_native_module = library;
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%s\n", e.what());
+            return false;
+        }
+
+        return true;
+    }
+
     void State::configure()
     {
         using namespace internal;
@@ -257,6 +283,10 @@ namespace Ark
                 throwStateError("Integrity check failed");
             ++i;
         }
+        m_hash = picosha2::bytes_to_hex_string(hash);
+        // pages translated from another bytecode can not be used anymore
+        m_native_pages.clear();
+        m_native_module.reset();
 
         if (m_bytecode[i] == Instruction::SYM_TABLE_START)
         {
@@ -306,7 +336,7 @@ namespace Ark
                         val.push_back(m_bytecode[i++]);
                     i++;
 
-                    m_constants.emplace_back(val);
+                    m_constants.emplace_back(m_strings.intern(val));
                 }
                 else if (type == Instruction::FUNC_TYPE)
                 {
@@ -339,11 +369,18 @@ namespace Ark
         }
     }
 
+    Value State::intern(const std::string& str)
+    {
+        return Value(m_strings.intern(str));
+    }
+
     void State::reset() noexcept
     {
         m_symbols.clear();
         m_constants.clear();
         m_pages.clear();
+        m_native_pages.clear();
+        m_native_module.reset();
         m_binded.clear();
     }
 }
@@ -1,7 +1,49 @@
 #include <Ark/VM/UserType.hpp>
 
+#include <atomic>
+#include <new>
+
 namespace Ark
 {
+    /**
+     * @brief Control functions of an object whose size is counted by an allocator, released by the last copy
+     *
+     */
+    struct UserType::Charge : UserType::ControlFuncs
+    {
+        std::atomic<std::size_t> owners { 1 };
+        internal::MemoryMeter meter;  ///< remembers the allocator charged and the size counted
+
+        explicit Charge(const ControlFuncs& funcs) noexcept :
+            ControlFuncs(funcs)
+        {}
+    };
+
+    UserType::UserType(const UserType& other) noexcept :
+        m_type_id(other.m_type_id), m_charged(other.m_charged), m_data(other.m_data), m_funcs(other.m_funcs)
+    {
+        if (m_charged)
+            static_cast<Charge*>(m_funcs)->owners.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    UserType& UserType::operator=(const UserType& other) noexcept
+    {
+        if (other.m_charged)
+            static_cast<Charge*>(other.m_funcs)->owners.fetch_add(1, std::memory_order_relaxed);
+        detach();
+
+        m_type_id = other.m_type_id;
+        m_charged = other.m_charged;
+        m_data = other.m_data;
+        m_funcs = other.m_funcs;
+        return *this;
+    }
+
+    UserType::~UserType()
+    {
+        detach();
+    }
+
     void UserType::del()
     {
         // call a custom deleter on the data held by the usertype
@@ -9,6 +51,35 @@ namespace Ark
             m_funcs->deleter(m_data);
     }
 
+    void UserType::setControlFuncs(ControlFuncs* block) noexcept
+    {
+        detach();
+        m_funcs = block;
+        if (m_funcs == nullptr || m_funcs->size == nullptr || Allocator::current() == nullptr)
+            return;
+
+        // without memory, the object just isn't counted
+        if (Charge* charge = new (std::nothrow) Charge(*block); charge != nullptr)
+        {
+            charge->meter.update(reportedSize());
+            m_funcs = charge;
+            m_charged = true;
+        }
+    }
+
+    std::size_t UserType::reportedSize() const
+    {
+        return (m_funcs != nullptr && m_funcs->size != nullptr) ? m_funcs->size(*this) : 0;
+    }
+
+    void UserType::detach() noexcept
+    {
+        if (m_charged && static_cast<Charge*>(m_funcs)->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete static_cast<Charge*>(m_funcs);
+        m_charged = false;
+        m_funcs = nullptr;
+    }
+
     bool operator==(const UserType& A, const UserType& B) noexcept
     {
         return (A.m_type_id == B.m_type_id) && (A.m_data == B.m_data);
@@ -15,13 +15,17 @@ namespace Ark
     VM::VM(State* state) noexcept :
         m_state(state), m_exit_code(0), m_ip(0), m_pp(0), m_sp(0), m_fc(0),
         m_running(false), m_last_sym_loaded(0),
-        m_until_frame_count(0), m_stack(nullptr), m_user_pointer(nullptr)
+        m_until_frame_count(0), m_stack(nullptr), m_execute_depth(0),
+        m_budget_instructions(0), m_budget_time(0), m_budget_left(INT64_MAX), m_budget_window(INT64_MAX), m_countdown(INT64_MAX),
+        m_stepping(false), m_allocator(nullptr), m_memory_limit(0), m_memory_outside_arena(0), m_user_pointer(nullptr)
     {
         m_locals.reserve(4);
     }
 
     void VM::init() noexcept
     {
+        AllocatorGuard allocator_guard(m_allocator);
+
         // initialize the stack
         if (m_stack == nullptr)
             m_stack = std::make_unique<std::array<Value, ArkVMStackSize>>();
@@ -36,6 +40,11 @@ namespace Ark
         m_saved_scope.reset();
         m_exit_code = 0;
 
+        m_scheduler.reset();
+        m_execute_depth = 0;
+        m_suspension.reset();
+        m_collector.clear();
+
         m_locals.clear();
         createNewScope();
 
@@ -53,6 +62,40 @@ namespace Ark
             if (it != m_state->m_symbols.end())
                 (*m_locals[0]).push_back(static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it)), name_val.second);
         }
+
+        // pages translated ahead of time, if any
+        m_native_pages = m_state->m_native_pages;
+
+#ifdef ARK_JIT
+        if ((m_state->m_options & FeatureJIT) && JIT::available())
+        {
+            if (m_jit == nullptr)
+                m_jit = std::make_unique<JIT>(this);
+            m_native_pages.resize(m_state->m_pages.size(), nullptr);
+        }
+#endif
+
+        if ((m_state->m_options & FeatureDeferredDestruction) && m_reclaimer == nullptr)
+            m_reclaimer = std::make_unique<Reclaimer>();
+    }
+
+    void VM::initFrom(const VM& other)
+    {
+        init();
+
+        m_shared_lib_objects = other.m_shared_lib_objects;
+        Scope& globals = *m_locals[0];
+        for (const auto& [id, value] : other.m_locals[0]->m_data)
+        {
+            if (!globals.has(id))
+                globals.push_back(id, deepCopy(value));
+        }
+    }
+
+    void VM::jitPageCall()
+    {
+        if (m_native_pages[m_pp] == nullptr)
+            m_native_pages[m_pp] = m_jit->hit(m_state->m_pages[m_pp], m_pp);
     }
 
     Value& VM::operator[](const std::string& name) noexcept
@@ -164,892 +207,1283 @@ namespace Ark
         init();
         safeRun();
 
-        // reset VM after each run
-        m_ip = 0;
-        m_pp = 0;
+        // reset VM after each run, unless it has to be resumed
+        if (!m_suspension)
+        {
+            m_ip = 0;
+            m_pp = 0;
+        }
 
         return m_exit_code;
     }
 
     int VM::safeRun(std::size_t untilFrameCount)
     {
-        m_until_frame_count = untilFrameCount;
+        AllocatorGuard allocator_guard(m_allocator);
+        const bool nested = m_running;
+        if (!nested)
+            startSlice();
 
         try
         {
             m_running = true;
-            while (m_running && m_fc > m_until_frame_count)
+            execute(untilFrameCount);
+
+            // keep running the outer code, unless the function asked to exit
+            if (nested)
+                m_running = m_running || m_fc == untilFrameCount;
+        }
+        catch (const std::exception& e)
+        {
+            if (nested)
+                throw;
+
+            std::printf("%s\n", e.what());
+            backtrace();
+            m_exit_code = 1;
+            m_running = false;
+            m_execute_depth = 0;
+            m_suspension.reset();
+        }
+        catch (...)
+        {
+            if (nested)
+                throw;
+
+            std::printf("Unknown error\n");
+            backtrace();
+            m_exit_code = 1;
+            m_running = false;
+            m_execute_depth = 0;
+            m_suspension.reset();
+        }
+
+        return m_exit_code;
+    }
+
+    void VM::execute(std::size_t untilFrameCount)
+    {
+        const std::size_t outer_until_frame_count = m_until_frame_count;
+        m_until_frame_count = untilFrameCount;
+        ++m_execute_depth;
+
+        // blocked coroutines left by VM::step: switch to the next one before running anything
+        if (m_execute_depth == 1 && m_scheduler != nullptr && m_scheduler->switch_requested)
+            m_running = false;
+
+        while ((m_running && m_fc > m_until_frame_count) || switchCoroutine())
+        {
+            // run as much as we can natively, the instruction pointer is left on the
+            // first instruction which the native code couldn't handle
+            if (m_pp < m_native_pages.size() && m_native_pages[m_pp] != nullptr)
+                m_native_pages[m_pp](this, m_stack->data(), m_ip);
+
+            // get current instruction
+            uint8_t inst = m_state->m_pages[m_pp][m_ip];
+
+            // and it's time to du-du-du-du-duel!
+            switch (inst)
             {
-                // get current instruction
-                uint8_t inst = m_state->m_pages[m_pp][m_ip];
+#pragma region "Instructions"
 
-                // and it's time to du-du-du-du-duel!
-                switch (inst)
+                case Instruction::LOAD_SYMBOL:
                 {
-#pragma region "Instructions"
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Load a symbol from its id onto the stack
+                    */
 
-                    case Instruction::LOAD_SYMBOL:
-                    {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Load a symbol from its id onto the stack
-                        */
+                    ++m_ip;
+                    m_last_sym_loaded = readNumber();
 
-                        ++m_ip;
-                        m_last_sym_loaded = readNumber();
+                    if (Value* var = findNearestVariable(m_last_sym_loaded); var != nullptr)
+                        // push internal reference, shouldn't break anything so far
+                        push(var);
+                    else
+                        throwVMError("unbound variable: " + m_state->m_symbols[m_last_sym_loaded]);
+
+                    COZ_PROGRESS_NAMED("ark vm load_symbol");
+                    break;
+                }
 
-                        if (Value* var = findNearestVariable(m_last_sym_loaded); var != nullptr)
-                            // push internal reference, shouldn't break anything so far
-                            push(var);
-                        else
-                            throwVMError("unbound variable: " + m_state->m_symbols[m_last_sym_loaded]);
+                case Instruction::LOAD_CONST:
+                {
+                    /*
+                        Argument: constant id (two bytes, big endian)
+                        Job: Load a constant from its id onto the stack. Should check for a saved environment
+                                and push a Closure with the page address + environment instead of the constant
+                    */
 
-                        COZ_PROGRESS_NAMED("ark vm load_symbol");
-                        break;
-                    }
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                    case Instruction::LOAD_CONST:
+                    if (m_saved_scope && m_state->m_constants[id].valueType() == ValueType::PageAddr)
                     {
-                        /*
-                            Argument: constant id (two bytes, big endian)
-                            Job: Load a constant from its id onto the stack. Should check for a saved environment
-                                    and push a Closure with the page address + environment instead of the constant
-                        */
+                        m_collector.track(m_saved_scope.value());
+                        push(Value(Closure(std::move(m_saved_scope.value()), m_state->m_constants[id].pageAddr())));
+                        m_saved_scope.reset();
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        if (m_collector.shouldCollect())
+                            m_collector.collect();
+                    }
+                    else
+                    {
+                        // push internal ref
+                        push(&(m_state->m_constants[id]));
+                    }
 
-                        if (m_saved_scope && m_state->m_constants[id].valueType() == ValueType::PageAddr)
-                        {
-                            push(Value(Closure(m_saved_scope.value(), m_state->m_constants[id].pageAddr())));
-                            m_saved_scope.reset();
-                        }
-                        else
-                        {
-                            // push internal ref
-                            push(&(m_state->m_constants[id]));
-                        }
+                    COZ_PROGRESS_NAMED("ark vm load_const");
+                    break;
+                }
 
-                        COZ_PROGRESS_NAMED("ark vm load_const");
-                        break;
-                    }
+                case Instruction::POP_JUMP_IF_TRUE:
+                {
+                    /*
+                        Argument: absolute address to jump to (two bytes, big endian)
+                        Job: Jump to the provided address if the last value on the stack was equal to true.
+                                Remove the value from the stack no matter what it is
+                    */
 
-                    case Instruction::POP_JUMP_IF_TRUE:
-                    {
-                        /*
-                            Argument: absolute address to jump to (two bytes, big endian)
-                            Job: Jump to the provided address if the last value on the stack was equal to true.
-                                    Remove the value from the stack no matter what it is
-                        */
+                    ++m_ip;
+                    uint16_t id = readNumber();
+
+                    if (*popAndResolveAsPtr() == Builtins::trueSym)
+                        m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
+                    break;
+                }
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                case Instruction::STORE:
+                {
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Take the value on top of the stack and put it inside a variable named following
+                                the symbol id (cf symbols table), in the nearest scope. Raise an error if it
+                                couldn't find a scope where the variable exists
+                    */
 
-                        if (*popAndResolveAsPtr() == Builtins::trueSym)
-                            m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
-                        break;
-                    }
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                    case Instruction::STORE:
+                    if (Value* var = findNearestVariable(id); var != nullptr)
                     {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Take the value on top of the stack and put it inside a variable named following
-                                    the symbol id (cf symbols table), in the nearest scope. Raise an error if it
-                                    couldn't find a scope where the variable exists
-                        */
+                        if (var->isConst())
+                            throwVMError("can not modify a constant: " + m_state->m_symbols[id]);
+
+                        Value value = popAndResolve();
+                        if (m_reclaimer)
+                            m_reclaimer->take(*var);
+                        *var = std::move(value);
+                        var->setConst(false);
+                        break;
+                    }
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                    COZ_PROGRESS_NAMED("ark vm store");
 
-                        if (Value* var = findNearestVariable(id); var != nullptr)
-                        {
-                            if (var->isConst())
-                                throwVMError("can not modify a constant: " + m_state->m_symbols[id]);
+                    throwVMError("unbound variable " + m_state->m_symbols[id] + ", can not change its value");
+                    break;
+                }
 
-                            *var = *popAndResolveAsPtr();
-                            var->setConst(false);
-                            break;
-                        }
+                case Instruction::LET:
+                {
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Take the value on top of the stack and create a constant in the current scope, named
+                                following the given symbol id (cf symbols table)
+                    */
 
-                        COZ_PROGRESS_NAMED("ark vm store");
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                        throwVMError("unbound variable " + m_state->m_symbols[id] + ", can not change its value");
-                        break;
-                    }
+                    // check if we are redefining a variable
+                    if (auto val = (*m_locals.back())[id]; val != nullptr)
+                        throwVMError("can not use 'let' to redefine the variable " + m_state->m_symbols[id]);
 
-                    case Instruction::LET:
-                    {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Take the value on top of the stack and create a constant in the current scope, named
-                                    following the given symbol id (cf symbols table)
-                        */
+                    Value val = popAndResolve();
+                    val.setConst(true);
+                    (*m_locals.back()).push_back(id, std::move(val));
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                    COZ_PROGRESS("ark vm let");
+                    break;
+                }
 
-                        // check if we are redefining a variable
-                        if (auto val = (*m_locals.back())[id]; val != nullptr)
-                            throwVMError("can not use 'let' to redefine the variable " + m_state->m_symbols[id]);
+                case Instruction::POP_JUMP_IF_FALSE:
+                {
+                    /*
+                        Argument: absolute address to jump to (two bytes, big endian)
+                        Job: Jump to the provided address if the last value on the stack was equal to false. Remove
+                                the value from the stack no matter what it is
+                    */
 
-                        Value val = *popAndResolveAsPtr();
-                        val.setConst(true);
-                        (*m_locals.back()).push_back(id, val);
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                        COZ_PROGRESS("ark vm let");
-                        break;
-                    }
+                    if (*popAndResolveAsPtr() == Builtins::falseSym)
+                        m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
+                    break;
+                }
 
-                    case Instruction::POP_JUMP_IF_FALSE:
-                    {
-                        /*
-                            Argument: absolute address to jump to (two bytes, big endian)
-                            Job: Jump to the provided address if the last value on the stack was equal to false. Remove
-                                    the value from the stack no matter what it is
-                        */
+                case Instruction::JUMP:
+                {
+                    /*
+                        Argument: absolute address to jump to (two byte, big endian)
+                        Job: Jump to the provided address
+                    */
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                        if (*popAndResolveAsPtr() == Builtins::falseSym)
-                            m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
-                        break;
-                    }
+                    m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
+                    break;
+                }
 
-                    case Instruction::JUMP:
+                case Instruction::RET:
+                {
+                    /*
+                        Argument: none
+                        Job: If in a code segment other than the main one, quit it, and push the value on top of
+                                the stack to the new stack ; should as well delete the current environment.
+                    */
+
+                    // the returned value is moved out of the stack, unless it's a variable of the function
+                    Value ip_or_val = popAndResolve();
+                    // no return value on the stack
+                    if (ip_or_val.valueType() == ValueType::InstPtr)
                     {
-                        /*
-                            Argument: absolute address to jump to (two byte, big endian)
-                            Job: Jump to the provided address
-                        */
+                        m_ip = ip_or_val.pageAddr();
+                        // we always push PP then IP, thus the next value
+                        // MUST be the page pointer
+                        m_pp = pop()->pageAddr();
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
-
-                        m_ip = static_cast<int16_t>(id) - 1;  // because we are doing a ++m_ip right after this
-                        break;
+                        returnFromFuncCall();
+                        push(Builtins::nil);
                     }
-
-                    case Instruction::RET:
+                    // value on the stack
+                    else
                     {
-                        /*
-                            Argument: none
-                            Job: If in a code segment other than the main one, quit it, and push the value on top of
-                                    the stack to the new stack ; should as well delete the current environment.
-                        */
-
-                        Value ip_or_val = *popAndResolveAsPtr();
-                        // no return value on the stack
-                        if (ip_or_val.valueType() == ValueType::InstPtr)
+                        Value* ip;
+                        do
                         {
-                            m_ip = ip_or_val.pageAddr();
-                            // we always push PP then IP, thus the next value
-                            // MUST be the page pointer
-                            m_pp = pop()->pageAddr();
+                            ip = popAndResolveAsPtr();
+                        } while (ip->valueType() != ValueType::InstPtr);
 
-                            returnFromFuncCall();
-                            push(Builtins::nil);
-                        }
-                        // value on the stack
-                        else
-                        {
-                            Value* ip;
-                            do
-                            {
-                                ip = popAndResolveAsPtr();
-                            } while (ip->valueType() != ValueType::InstPtr);
+                        m_ip = ip->pageAddr();
+                        m_pp = pop()->pageAddr();
 
-                            m_ip = ip->pageAddr();
-                            m_pp = pop()->pageAddr();
+                        returnFromFuncCall();
+                        push(std::move(ip_or_val));
+                    }
 
-                            returnFromFuncCall();
-                            push(std::move(ip_or_val));
-                        }
+                    COZ_PROGRESS_NAMED("ark vm ret");
+                    break;
+                }
 
-                        COZ_PROGRESS_NAMED("ark vm ret");
-                        break;
-                    }
+                case Instruction::HALT:
+                    m_running = false;
+                    break;
 
-                    case Instruction::HALT:
-                        m_running = false;
-                        break;
+                case Instruction::CALL:
+                    call();
+                    break;
 
-                    case Instruction::CALL:
-                        call();
-                        break;
+                case Instruction::CAPTURE:
+                {
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Used to tell the Virtual Machine to capture the variable from the current environment.
+                            Main goal is to be able to handle closures, which need to save the environment in which
+                            they were created
+                    */
 
-                    case Instruction::CAPTURE:
+                    ++m_ip;
+                    uint16_t id = readNumber();
+
+                    if (!m_saved_scope)
+                        m_saved_scope = makeShared<Scope>();
+
+                    if (m_state->m_options & FeatureSharedCaptures)
+                    {
+                        // the closure and the frame share the variable, through an upvalue closed when the frame is destroyed
+                        (*m_saved_scope.value()).capture(id, m_locals.back()->upvalue(id));
+                    }
+                    else
                     {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Used to tell the Virtual Machine to capture the variable from the current environment.
-                                Main goal is to be able to handle closures, which need to save the environment in which
-                                they were created
-                        */
-
-                        ++m_ip;
-                        uint16_t id = readNumber();
-
-                        if (!m_saved_scope)
-                            m_saved_scope = std::make_shared<Scope>();
                         // if it's a captured variable, it can not be nullptr
                         Value* ptr = (*m_locals.back())[id];
                         ptr = ptr->valueType() == ValueType::Reference ? ptr->reference() : ptr;
                         (*m_saved_scope.value()).push_back(id, *ptr);
-
-                        COZ_PROGRESS_NAMED("ark vm capture");
-                        break;
                     }
 
-                    case Instruction::BUILTIN:
-                    {
-                        /*
-                            Argument: id of builtin (two bytes, big endian)
-                            Job: Push the builtin function object on the stack
-                        */
+                    COZ_PROGRESS_NAMED("ark vm capture");
+                    break;
+                }
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                case Instruction::BUILTIN:
+                {
+                    /*
+                        Argument: id of builtin (two bytes, big endian)
+                        Job: Push the builtin function object on the stack
+                    */
 
-                        push(Builtins::builtins[id].second);
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                        COZ_PROGRESS_NAMED("ark vm builtin");
-                        break;
-                    }
+                    push(Builtins::builtins[id].second);
 
-                    case Instruction::MUT:
-                    {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Take the value on top of the stack and create a variable in the current scope,
-                                named following the given symbol id (cf symbols table)
-                        */
-
-                        ++m_ip;
-                        uint16_t id = readNumber();
-
-                        Value val = *popAndResolveAsPtr();
-                        val.setConst(false);
-
-                        // avoid adding the pair (id, _) multiple times, with different values
-                        Value* local = (*m_locals.back())[id];
-                        if (local == nullptr)
-                            (*m_locals.back()).push_back(id, val);
-                        else
-                            *local = val;
-
-                        COZ_PROGRESS_NAMED("ark vm mut");
-                        break;
-                    }
+                    COZ_PROGRESS_NAMED("ark vm builtin");
+                    break;
+                }
 
-                    case Instruction::DEL:
+                case Instruction::MUT:
+                {
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Take the value on top of the stack and create a variable in the current scope,
+                            named following the given symbol id (cf symbols table)
+                    */
+
+                    ++m_ip;
+                    uint16_t id = readNumber();
+
+                    Value val = popAndResolve();
+                    val.setConst(false);
+
+                    // avoid adding the pair (id, _) multiple times, with different values
+                    Value* local = (*m_locals.back())[id];
+                    if (local == nullptr)
+                        (*m_locals.back()).push_back(id, std::move(val));
+                    else
                     {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Remove a variable/constant named following the given symbol id (cf symbols table)
-                        */
-
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                        if (m_reclaimer)
+                            m_reclaimer->take(*local);
+                        *local = std::move(val);
+                    }
 
-                        if (Value* var = findNearestVariable(id); var != nullptr)
-                        {
-                            // free usertypes
-                            if (var->valueType() == ValueType::User)
-                                var->usertypeRef().del();
-                            *var = Value();
-                            break;
-                        }
+                    COZ_PROGRESS_NAMED("ark vm mut");
+                    break;
+                }
 
-                        COZ_PROGRESS_NAMED("ark vm del");
+                case Instruction::DEL:
+                {
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Remove a variable/constant named following the given symbol id (cf symbols table)
+                    */
 
-                        throwVMError("unbound variable: " + m_state->m_symbols[id]);
-                        break;
-                    }
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                    case Instruction::SAVE_ENV:
+                    if (Value* var = findNearestVariable(id); var != nullptr)
                     {
-                        /*
-                            Argument: none
-                            Job: Save the current environment, useful for quoted code
-                        */
-                        m_saved_scope = m_locals.back();
-
-                        COZ_PROGRESS("ark vm save_scope");
+                        // free usertypes
+                        if (var->valueType() == ValueType::User)
+                            var->usertypeRef().del();
+                        else if (m_reclaimer)
+                            m_reclaimer->take(*var);
+                        *var = Value();
                         break;
                     }
 
-                    case Instruction::GET_FIELD:
-                    {
-                        /*
-                            Argument: symbol id (two bytes, big endian)
-                            Job: Used to read the field named following the given symbol id (cf symbols table) of a `Closure`
-                                stored in TS. Pop TS and push the value of field read on the stack
-                        */
+                    COZ_PROGRESS_NAMED("ark vm del");
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                    throwVMError("unbound variable: " + m_state->m_symbols[id]);
+                    break;
+                }
 
-                        Value* var = popAndResolveAsPtr();
-                        if (var->valueType() != ValueType::Closure)
-                            throwVMError("the variable `" + m_state->m_symbols[m_last_sym_loaded] + "' isn't a closure, can not get the field `" + m_state->m_symbols[id] + "' from it");
+                case Instruction::SAVE_ENV:
+                {
+                    /*
+                        Argument: none
+                        Job: Save the current environment, useful for quoted code
+                    */
+                    m_saved_scope = m_locals.back();
 
-                        if (Value* field = (*var->refClosure().scope())[id]; field != nullptr)
-                        {
-                            // check for CALL instruction
-                            if (m_ip + 1 < m_state->m_pages[m_pp].size() && m_state->m_pages[m_pp][m_ip + 1] == Instruction::CALL)
-                            {
-                                m_locals.push_back(var->refClosure().scope());
-                                ++m_scope_count_to_delete.back();
-                            }
-
-                            push(field);
-                            break;
-                        }
+                    COZ_PROGRESS("ark vm save_scope");
+                    break;
+                }
 
-                        throwVMError("couldn't find the variable " + m_state->m_symbols[id] + " in the closure enviroment");
-                        break;
-                    }
+                case Instruction::GET_FIELD:
+                {
+                    /*
+                        Argument: symbol id (two bytes, big endian)
+                        Job: Used to read the field named following the given symbol id (cf symbols table) of a `Closure`
+                            stored in TS. Pop TS and push the value of field read on the stack
+                    */
 
-                    case Instruction::PLUGIN:
-                    {
-                        /*
-                            Argument: constant id (two bytes, big endian)
-                            Job: Load a module named following the constant id (cf constants table).
-                                 Raise an error if it couldn't find the module.
-                        */
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                        ++m_ip;
-                        uint16_t id = readNumber();
+                    Value* var = popAndResolveAsPtr();
+                    if (var->valueType() != ValueType::Closure)
+                        throwVMError("the variable `" + m_state->m_symbols[m_last_sym_loaded] + "' isn't a closure, can not get the field `" + m_state->m_symbols[id] + "' from it");
 
-                        loadPlugin(id);
+                    if (Value* field = (*var->refClosure().scope())[id]; field != nullptr)
+                    {
+                        // check for CALL instruction
+                        if (m_ip + 1 < m_state->m_pages[m_pp].size() && m_state->m_pages[m_pp][m_ip + 1] == Instruction::CALL)
+                        {
+                            m_locals.push_back(var->refClosure().scope());
+                            ++m_scope_count_to_delete.back();
+                        }
 
-                        COZ_PROGRESS("ark vm plugin");
+                        push(field);
                         break;
                     }
 
-                    case Instruction::LIST:
-                    {
-                        /*
-                            Takes at least 0 arguments and push a list on the stack.
-                            The content is pushed in reverse order
-                        */
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                    throwVMError("couldn't find the variable " + m_state->m_symbols[id] + " in the closure enviroment");
+                    break;
+                }
 
-                        Value l(ValueType::List);
-                        if (count != 0)
-                            l.list().reserve(count);
+                case Instruction::PLUGIN:
+                {
+                    /*
+                        Argument: constant id (two bytes, big endian)
+                        Job: Load a module named following the constant id (cf constants table).
+                             Raise an error if it couldn't find the module.
+                    */
 
-                        for (uint16_t i = 0; i < count; ++i)
-                            l.push_back(*popAndResolveAsPtr());
-                        push(std::move(l));
+                    ++m_ip;
+                    uint16_t id = readNumber();
 
-                        COZ_PROGRESS_NAMED("ark vm list");
-                        break;
-                    }
+                    loadPlugin(id);
 
-                    case Instruction::APPEND:
-                    {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                    COZ_PROGRESS("ark vm plugin");
+                    break;
+                }
 
-                        Value* list = popAndResolveAsPtr();
-                        if (list->valueType() != ValueType::List)
-                            throw TypeError("Argument 1 of append should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
-                        const uint16_t size = list->constList().size();
+                case Instruction::LIST:
+                {
+                    /*
+                        Takes at least 0 arguments and push a list on the stack.
+                        The content is pushed in reverse order
+                    */
+                    ++m_ip;
+                    uint16_t count = readNumber();
+
+                    Value l(ValueType::List);
+                    if (count != 0)
+                        l.list().reserve(count);
+
+                    for (uint16_t i = 0; i < count; ++i)
+                        l.push_back(popAndResolve());
+                    push(std::move(l));
+
+                    COZ_PROGRESS_NAMED("ark vm list");
+                    break;
+                }
 
-                        Value obj = Value(*list);
-                        obj.list().reserve(size + count);
+                case Instruction::APPEND:
+                {
+                    ++m_ip;
+                    uint16_t count = readNumber();
 
+                    // (set lst (append lst ...)) appends directly to lst, and skips the STORE
+                    if (Value* var = listStoredInPlace(); var != nullptr)
+                    {
+                        pop();
                         for (uint16_t i = 0; i < count; ++i)
-                            obj.push_back(*popAndResolveAsPtr());
-                        push(std::move(obj));
+                            var->push_back(popAndResolve());
+                        m_ip += 3;
 
                         COZ_PROGRESS_NAMED("ark vm append");
                         break;
                     }
 
-                    case Instruction::CONCAT:
-                    {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                    Value obj = popAndResolve();
+                    if (obj.valueType() != ValueType::List)
+                        throw TypeError("Argument 1 of append should be a List, got " + types_to_str[static_cast<unsigned>(obj.valueType())]);
 
-                        Value* list = popAndResolveAsPtr();
-                        if (list->valueType() != ValueType::List)
-                            throw TypeError("Argument 1 of concat should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
+                    // the elements are copied only if they are shared with another list
+                    obj.list().reserve(obj.listView().size() + count);
+                    for (uint16_t i = 0; i < count; ++i)
+                        obj.push_back(popAndResolve());
+                    push(std::move(obj));
 
-                        Value obj = Value(*list);
+                    COZ_PROGRESS_NAMED("ark vm append");
+                    break;
+                }
 
-                        for (uint16_t i = 0; i < count; ++i)
-                        {
-                            Value* next = popAndResolveAsPtr();
-                            if (next->valueType() != ValueType::List)
-                                throw TypeError("Arguments of concat should be Lists, got " + types_to_str[static_cast<unsigned>(next->valueType())]);
+                case Instruction::CONCAT:
+                {
+                    ++m_ip;
+                    uint16_t count = readNumber();
 
-                            for (auto it = next->list().begin(), end = next->list().end(); it != end; ++it)
-                                obj.push_back(*it);
-                        }
-                        push(std::move(obj));
+                    Value* var = listStoredInPlace();
+                    Value obj = popAndResolve();
+                    if (obj.valueType() != ValueType::List)
+                        throw TypeError("Argument 1 of concat should be a List, got " + types_to_str[static_cast<unsigned>(obj.valueType())]);
 
-                        COZ_PROGRESS_NAMED("ark vm concat");
-                        break;
-                    }
+                    // (set lst (concat lst ...)) concatenates directly to lst, and skips the STORE
+                    Value& target = (var != nullptr) ? *var : obj;
+                    if (var != nullptr)
+                        obj = Nil;  // release our copy so that the variable doesn't share its elements anymore
 
-                    case Instruction::APPEND_IN_PLACE:
+                    for (uint16_t i = 0; i < count; ++i)
                     {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                        // keep the next list alive while it's being read, it may be the same as target
+                        Value next = popAndResolve();
+                        if (next.valueType() != ValueType::List)
+                            throw TypeError("Arguments of concat should be Lists, got " + types_to_str[static_cast<unsigned>(next.valueType())]);
 
-                        Value* list = popAndResolveAsPtr();
+                        for (const Value& val : next.listView())
+                            target.push_back(val);
+                    }
 
-                        if (list->isConst())
-                            throwVMError("can not modify a constant list using `append!'");
-                        if (list->valueType() != ValueType::List)
-                            throw TypeError("Argument 1 of append! should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
+                    if (var != nullptr)
+                        m_ip += 3;
+                    else
+                        push(std::move(obj));
 
-                        for (uint16_t i = 0; i < count; ++i)
-                            list->push_back(*popAndResolveAsPtr());
+                    COZ_PROGRESS_NAMED("ark vm concat");
+                    break;
+                }
 
-                        push(Nil);
+                case Instruction::APPEND_IN_PLACE:
+                {
+                    ++m_ip;
+                    uint16_t count = readNumber();
 
-                        COZ_PROGRESS_NAMED("ark vm append!");
-                        break;
-                    }
+                    Value* list = popAndResolveAsPtr();
 
-                    case Instruction::CONCAT_IN_PLACE:
-                    {
-                        ++m_ip;
-                        uint16_t count = readNumber();
+                    if (list->isConst())
+                        throwVMError("can not modify a constant list using `append!'");
+                    if (list->valueType() != ValueType::List)
+                        throw TypeError("Argument 1 of append! should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
 
-                        Value* list = popAndResolveAsPtr();
+                    for (uint16_t i = 0; i < count; ++i)
+                        list->push_back(popAndResolve());
 
-                        if (list->isConst())
-                            throwVMError("can not modify a constant list using `concat!'");
-                        if (list->valueType() != ValueType::List)
-                            throw TypeError("Argument 1 of concat! should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
+                    push(Nil);
 
-                        for (uint16_t i = 0; i < count; ++i)
-                        {
-                            Value* next = popAndResolveAsPtr();
-                            if (next->valueType() != ValueType::List)
-                                throw TypeError("Arguments of concat! should be Lists, got " + types_to_str[static_cast<unsigned>(next->valueType())]);
+                    COZ_PROGRESS_NAMED("ark vm append!");
+                    break;
+                }
 
-                            for (auto it = next->list().begin(), end = next->list().end(); it != end; ++it)
-                                list->push_back(*it);
-                        }
+                case Instruction::CONCAT_IN_PLACE:
+                {
+                    ++m_ip;
+                    uint16_t count = readNumber();
 
-                        push(Nil);
+                    Value* list = popAndResolveAsPtr();
 
-                        COZ_PROGRESS_NAMED("ark vm concat!");
-                        break;
-                    }
+                    if (list->isConst())
+                        throwVMError("can not modify a constant list using `concat!'");
+                    if (list->valueType() != ValueType::List)
+                        throw TypeError("Argument 1 of concat! should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
 
-                    case Instruction::POP_LIST:
+                    for (uint16_t i = 0; i < count; ++i)
                     {
-                        Value list = *popAndResolveAsPtr();
-                        Value number = *popAndResolveAsPtr();
+                        // keep the next list alive while it's being read, it may be the same as list
+                        Value next = popAndResolve();
+                        if (next.valueType() != ValueType::List)
+                            throw TypeError("Arguments of concat! should be Lists, got " + types_to_str[static_cast<unsigned>(next.valueType())]);
 
-                        if (list.valueType() != ValueType::List)
-                            throw TypeError("Argument 1 of pop should be a List, got " + types_to_str[static_cast<unsigned>(list.valueType())]);
-                        if (number.valueType() != ValueType::Number)
-                            throw TypeError("Argument 2 of pop should be a Number, got " + types_to_str[static_cast<unsigned>(number.valueType())]);
+                        for (const Value& val : next.listView())
+                            list->push_back(val);
+                    }
 
-                        long idx = static_cast<long>(number.number());
-                        idx = (idx < 0 ? list.list().size() + idx : idx);
-                        if (idx >= list.list().size())
-                            throw std::runtime_error("pop: index out of range");
+                    push(Nil);
 
-                        list.list().erase(list.list().begin() + idx);
-                        push(list);
-                        break;
-                    }
+                    COZ_PROGRESS_NAMED("ark vm concat!");
+                    break;
+                }
 
-                    case Instruction::POP_LIST_IN_PLACE:
+                case Instruction::POP_LIST:
+                {
+                    Value* var = listStoredInPlace();
+                    Value list = popAndResolve();
+                    Value* number = popAndResolveAsPtr();
+
+                    if (list.valueType() != ValueType::List)
+                        throw TypeError("Argument 1 of pop should be a List, got " + types_to_str[static_cast<unsigned>(list.valueType())]);
+                    if (number->valueType() != ValueType::Number)
+                        throw TypeError("Argument 2 of pop should be a Number, got " + types_to_str[static_cast<unsigned>(number->valueType())]);
+
+                    long idx = static_cast<long>(number->number());
+                    idx = (idx < 0 ? list.listView().size() + idx : idx);
+                    if (idx >= list.listView().size())
+                        throw std::runtime_error("pop: index out of range");
+
+                    // (set lst (pop lst ...)) removes the element directly from lst, and skips the STORE
+                    if (var != nullptr)
                     {
-                        Value* list = popAndResolveAsPtr();
-                        Value number = *popAndResolveAsPtr();
-
-                        if (list->isConst())
-                            throwVMError("can not modify a constant list using `pop!'");
-                        if (list->valueType() != ValueType::List)
-                            throw TypeError("Argument 1 of pop! should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
-                        if (number.valueType() != ValueType::Number)
-                            throw TypeError("Argument 2 of pop! should be a Number, got " + types_to_str[static_cast<unsigned>(number.valueType())]);
-
-                        long idx = static_cast<long>(number.number());
-                        idx = (idx < 0 ? list->list().size() + idx : idx);
-                        if (idx >= list->list().size())
-                            throw std::runtime_error("pop!: index out of range");
-
-                        list->list().erase(list->list().begin() + idx);
+                        list = Nil;  // release our copy so that the variable doesn't share its elements anymore
+                        var->list().erase(var->list().begin() + idx);
+                        m_ip += 3;
                         break;
                     }
 
-#pragma endregion
-
-#pragma region "Operators"
-
-                    case Instruction::ADD:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
-
-                        if (a->valueType() == ValueType::Number)
-                        {
-                            if (b->valueType() != ValueType::Number)
-                                throw TypeError("Arguments of + should have the same type");
+                    list.list().erase(list.list().begin() + idx);
+                    push(std::move(list));
+                    break;
+                }
 
-                            push(Value(a->number() + b->number()));
-                            break;
-                        }
-                        else if (a->valueType() == ValueType::String)
-                        {
-                            if (b->valueType() != ValueType::String)
-                                throw TypeError("Arguments of + should have the same type");
+                case Instruction::POP_LIST_IN_PLACE:
+                {
+                    Value* list = popAndResolveAsPtr();
+                    Value number = *popAndResolveAsPtr();
+
+                    if (list->isConst())
+                        throwVMError("can not modify a constant list using `pop!'");
+                    if (list->valueType() != ValueType::List)
+                        throw TypeError("Argument 1 of pop! should be a List, got " + types_to_str[static_cast<unsigned>(list->valueType())]);
+                    if (number.valueType() != ValueType::Number)
+                        throw TypeError("Argument 2 of pop! should be a Number, got " + types_to_str[static_cast<unsigned>(number.valueType())]);
+
+                    long idx = static_cast<long>(number.number());
+                    idx = (idx < 0 ? list->listView().size() + idx : idx);
+                    if (idx >= list->listView().size())
+                        throw std::runtime_error("pop!: index out of range");
+
+                    list->list().erase(list->list().begin() + idx);
+                    break;
+                }
 
-                            push(Value(a->string() + b->string()));
-                            break;
-                        }
-                        throw TypeError("Arguments of + should be Numbers or Strings");
-                    }
+                case Instruction::DICT_SET_IN_PLACE:
+                {
+                    Value* dict = popAndResolveAsPtr();
+                    Value* key = popAndResolveAsPtr();
+                    Value value = popAndResolve();
 
-                    case Instruction::SUB:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                    if (dict->isConst())
+                        throwVMError("can not modify a constant dict using `dict:set!'");
+                    if (dict->valueType() != ValueType::Dict)
+                        throw TypeError("Argument 1 of dict:set! should be a Dict, got " + types_to_str[static_cast<unsigned>(dict->valueType())]);
 
-                        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of - should be Numbers");
+                    dict->dictRef().set(*key, value);
 
-                        push(Value(a->number() - b->number()));
-                        break;
-                    }
+                    COZ_PROGRESS_NAMED("ark vm dict:set!");
+                    break;
+                }
 
-                    case Instruction::MUL:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                case Instruction::DICT_REMOVE_IN_PLACE:
+                {
+                    Value* dict = popAndResolveAsPtr();
+                    Value* key = popAndResolveAsPtr();
 
-                        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of * should be Numbers");
+                    if (dict->isConst())
+                        throwVMError("can not modify a constant dict using `dict:remove!'");
+                    if (dict->valueType() != ValueType::Dict)
+                        throw TypeError("Argument 1 of dict:remove! should be a Dict, got " + types_to_str[static_cast<unsigned>(dict->valueType())]);
 
-                        push(Value(a->number() * b->number()));
-                        break;
-                    }
+                    dict->dictRef().remove(*key);
 
-                    case Instruction::DIV:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                    COZ_PROGRESS_NAMED("ark vm dict:remove!");
+                    break;
+                }
 
-                        if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of / should be Numbers");
+#pragma endregion
 
-                        auto d = b->number();
-                        if (d == 0)
-                            throw ZeroDivisionError();
+#pragma region "Operators"
 
-                        push(Value(a->number() / d));
-                        break;
-                    }
+                case Instruction::ADD:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                    case Instruction::GT:
+                    if (a->valueType() == ValueType::Number)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        if (b->valueType() != ValueType::Number)
+                            throw TypeError("Arguments of + should have the same type");
 
-                        push((!(*a == *b) && !(*a < *b)) ? Builtins::trueSym : Builtins::falseSym);
+                        push(Value(a->number() + b->number()));
                         break;
                     }
-
-                    case Instruction::LT:
+                    else if (a->valueType() == ValueType::String)
                     {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                        if (b->valueType() != ValueType::String)
+                            throw TypeError("Arguments of + should have the same type");
 
-                        push((*a < *b) ? Builtins::trueSym : Builtins::falseSym);
+                        push(Value(a->string() + b->string()));
                         break;
                     }
+                    throw TypeError("Arguments of + should be Numbers or Strings");
+                }
 
-                    case Instruction::LE:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                case Instruction::SUB:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                        push(((*a < *b) || (*a == *b)) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
-                    }
+                    if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
+                        throw TypeError("Arguments of - should be Numbers");
 
-                    case Instruction::GE:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                    push(Value(a->number() - b->number()));
+                    break;
+                }
 
-                        push(!(*a < *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
-                    }
+                case Instruction::MUL:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                    case Instruction::NEQ:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                    if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
+                        throw TypeError("Arguments of * should be Numbers");
 
-                        push((*a != *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
-                    }
+                    push(Value(a->number() * b->number()));
+                    break;
+                }
 
-                    case Instruction::EQ:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                case Instruction::DIV:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                        push((*a == *b) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
-                    }
+                    if (a->valueType() != ValueType::Number || b->valueType() != ValueType::Number)
+                        throw TypeError("Arguments of / should be Numbers");
 
-                    case Instruction::LEN:
-                    {
-                        Value* a = popAndResolveAsPtr();
-
-                        if (a->valueType() == ValueType::List)
-                            push(Value(static_cast<int>(a->constList().size())));
-                        else if (a->valueType() == ValueType::String)
-                            push(Value(static_cast<int>(a->string().size())));
-                        else
-                            throw TypeError("Argument of len must be a List or a String");
-                        break;
-                    }
+                    auto d = b->number();
+                    if (d == 0)
+                        throw ZeroDivisionError();
 
-                    case Instruction::EMPTY:
-                    {
-                        Value* a = popAndResolveAsPtr();
+                    push(Value(a->number() / d));
+                    break;
+                }
 
-                        if (a->valueType() == ValueType::List)
-                            push((a->constList().size() == 0) ? Builtins::trueSym : Builtins::falseSym);
-                        else if (a->valueType() == ValueType::String)
-                            push((a->string().size() == 0) ? Builtins::trueSym : Builtins::falseSym);
-                        else
-                            throw TypeError("Argument of empty? must be a List or a String");
+                case Instruction::GT:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                        break;
-                    }
+                    push((!(*a == *b) && !(*a < *b)) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
 
-                    case Instruction::TAIL:
-                    {
-                        Value* a = popAndResolveAsPtr();
+                case Instruction::LT:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+
+                    push((*a < *b) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
+
+                case Instruction::LE:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                        if (a->valueType() == ValueType::List)
+                    push(((*a < *b) || (*a == *b)) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
+
+                case Instruction::GE:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+
+                    push(!(*a < *b) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
+
+                case Instruction::NEQ:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+
+                    push((*a != *b) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
+
+                case Instruction::EQ:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+
+                    push((*a == *b) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
+
+                case Instruction::LEN:
+                {
+                    Value* a = popAndResolveAsPtr();
+
+                    if (a->valueType() == ValueType::List)
+                        push(Value(static_cast<int>(a->listView().size())));
+                    else if (a->valueType() == ValueType::String)
+                        push(Value(static_cast<int>(a->string().size())));
+                    else if (a->valueType() == ValueType::Array)
+                        push(Value(static_cast<int>(a->array().size())));
+                    else
+                        throw TypeError("Argument of len must be a List, a String or an Array");
+                    break;
+                }
+
+                case Instruction::EMPTY:
+                {
+                    Value* a = popAndResolveAsPtr();
+
+                    if (a->valueType() == ValueType::List)
+                        push(a->listView().empty() ? Builtins::trueSym : Builtins::falseSym);
+                    else if (a->valueType() == ValueType::String)
+                        push((a->string().size() == 0) ? Builtins::trueSym : Builtins::falseSym);
+                    else if (a->valueType() == ValueType::Array)
+                        push((a->array().size() == 0) ? Builtins::trueSym : Builtins::falseSym);
+                    else
+                        throw TypeError("Argument of empty? must be a List, a String or an Array");
+
+                    break;
+                }
+
+                case Instruction::TAIL:
+                {
+                    Value* a = popAndResolveAsPtr();
+
+                    if (a->valueType() == ValueType::List)
+                    {
+                        const SharedList& list = a->listView();
+                        if (list.size() < 2)
                         {
-                            if (a->constList().size() < 2)
-                            {
-                                push(Value(ValueType::List));
-                                break;
-                            }
-
-                            std::vector<Value> tmp(a->constList().size() - 1);
-                            for (std::size_t i = 1, end = a->constList().size(); i < end; ++i)
-                                tmp[i - 1] = a->constList()[i];
-                            push(Value(std::move(tmp)));
+                            push(Value(ValueType::List));
+                            break;
                         }
-                        else if (a->valueType() == ValueType::String)
+
+                        // the tail shares the elements of the list
+                        push(Value(list.view(1, list.size() - 1)));
+                    }
+                    else if (a->valueType() == ValueType::String)
+                    {
+                        if (a->string().size() < 2)
                         {
-                            if (a->string().size() < 2)
-                            {
-                                push(Value(ValueType::String));
-                                break;
-                            }
-
-                            Value b = *a;
-                            b.stringRef().erase_front(0);
-                            push(std::move(b));
+                            push(Value(ValueType::String));
+                            break;
                         }
-                        else
-                            throw TypeError("Argument of tail must be a List or a String");
 
-                        break;
+                        push(Value(a->string().substr(1)));
                     }
+                    else
+                        throw TypeError("Argument of tail must be a List or a String");
 
-                    case Instruction::HEAD:
-                    {
-                        Value* a = popAndResolveAsPtr();
+                    break;
+                }
 
-                        if (a->valueType() == ValueType::List)
+                case Instruction::HEAD:
+                {
+                    Value* a = popAndResolveAsPtr();
+
+                    if (a->valueType() == ValueType::List)
+                    {
+                        if (a->listView().empty())
                         {
-                            if (a->constList().size() == 0)
-                            {
-                                push(Builtins::nil);
-                                break;
-                            }
-
-                            Value b = a->constList()[0];
-                            push(b);
+                            push(Builtins::nil);
+                            break;
                         }
-                        else if (a->valueType() == ValueType::String)
-                        {
-                            if (a->string().size() == 0)
-                            {
-                                push(Value(ValueType::String));
-                                break;
-                            }
 
-                            push(Value(std::string(1, a->stringRef()[0])));
+                        Value b = a->listView()[0];  // a may be the stack slot we are pushing into
+                        push(std::move(b));
+                    }
+                    else if (a->valueType() == ValueType::String)
+                    {
+                        if (a->string().size() == 0)
+                        {
+                            push(Value(ValueType::String));
+                            break;
                         }
-                        else
-                            throw TypeError("Argument of head must be a List or a String");
 
-                        break;
+                        push(Value(std::string(1, a->stringRef()[0])));
                     }
+                    else
+                        throw TypeError("Argument of head must be a List or a String");
+
+                    break;
+                }
 
-                    case Instruction::ISNIL:
+                case Instruction::ISNIL:
+                {
+                    Value* a = popAndResolveAsPtr();
+                    push((*a == Builtins::nil) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
+
+                case Instruction::ASSERT:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+
+                    if (*a == Builtins::falseSym)
                     {
-                        Value* a = popAndResolveAsPtr();
-                        push((*a == Builtins::nil) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
+                        if (b->valueType() != ValueType::String)
+                            throw TypeError("Second argument of assert must be a String");
+
+                        throw AssertionFailed(b->stringRef().toString());
                     }
+                    break;
+                }
 
-                    case Instruction::ASSERT:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                case Instruction::TO_NUM:
+                {
+                    Value* a = popAndResolveAsPtr();
 
-                        if (*a == Builtins::falseSym)
-                        {
-                            if (b->valueType() != ValueType::String)
-                                throw TypeError("Second argument of assert must be a String");
+                    if (a->valueType() != ValueType::String)
+                        throw TypeError("Argument of toNumber must be a String");
 
-                            throw AssertionFailed(b->stringRef().toString());
-                        }
-                        break;
-                    }
+                    double val;
+                    if (Utils::isDouble(a->string().c_str(), &val))
+                        push(Value(val));
+                    else
+                        push(Builtins::nil);
+                    break;
+                }
 
-                    case Instruction::TO_NUM:
-                    {
-                        Value* a = popAndResolveAsPtr();
+                case Instruction::TO_STR:
+                {
+                    std::stringstream ss;
+                    Value* a = popAndResolveAsPtr();
+                    ss << (*a);
+                    push(Value(ss.str()));
+                    break;
+                }
 
-                        if (a->valueType() != ValueType::String)
-                            throw TypeError("Argument of toNumber must be a String");
+                case Instruction::AT:
+                {
+                    Value* b = popAndResolveAsPtr();
+                    Value a = popAndResolve();  // be careful, it's not a pointer
+
+                    if (b->valueType() != ValueType::Number)
+                        throw TypeError("Argument 2 of @ should be a Number");
+
+                    long idx = static_cast<long>(b->number());
+
+                    if (a.valueType() == ValueType::List)
+                        push(a.listView()[idx < 0 ? a.listView().size() + idx : idx]);
+                    else if (a.valueType() == ValueType::String)
+                        push(Value(std::string(1, a.string()[idx < 0 ? a.string().size() + idx : idx])));
+                    else if (a.valueType() == ValueType::Array)
+                        push(Value(a.array().get()[idx < 0 ? a.array().size() + idx : idx]));
+                    else
+                        throw TypeError("Argument 1 of @ should be a List, a String or an Array");
+                    break;
+                }
 
-                        double val;
-                        if (Utils::isDouble(a->string().c_str(), &val))
-                            push(Value(val));
-                        else
-                            push(Builtins::nil);
-                        break;
-                    }
+                case Instruction::AND_:
+                {
+                    Value *a = popAndResolveAsPtr(), *b = popAndResolveAsPtr();
 
-                    case Instruction::TO_STR:
-                    {
-                        std::stringstream ss;
-                        Value* a = popAndResolveAsPtr();
-                        ss << (*a);
-                        push(Value(ss.str()));
-                        break;
-                    }
+                    push((*a == Builtins::trueSym && *b == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
 
-                    case Instruction::AT:
-                    {
-                        Value* b = popAndResolveAsPtr();
-                        Value a = *popAndResolveAsPtr();  // be careful, it's not a pointer
+                case Instruction::OR_:
+                {
+                    Value *a = popAndResolveAsPtr(), *b = popAndResolveAsPtr();
 
-                        if (b->valueType() != ValueType::Number)
-                            throw TypeError("Argument 2 of @ should be a Number");
+                    push((*b == Builtins::trueSym || *a == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
 
-                        long idx = static_cast<long>(b->number());
+                case Instruction::MOD:
+                {
+                    Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
 
-                        if (a.valueType() == ValueType::List)
-                            push(a.list()[idx < 0 ? a.list().size() + idx : idx]);
-                        else if (a.valueType() == ValueType::String)
-                            push(Value(std::string(1, a.string()[idx < 0 ? a.string().size() + idx : idx])));
-                        else
-                            throw TypeError("Argument 1 of @ should be a List or a String");
-                        break;
-                    }
+                    if (a->valueType() != ValueType::Number)
+                        throw TypeError("Arguments of mod should be Numbers");
+                    if (b->valueType() != ValueType::Number)
+                        throw TypeError("Arguments of mod should be Numbers");
 
-                    case Instruction::AND_:
-                    {
-                        Value *a = popAndResolveAsPtr(), *b = popAndResolveAsPtr();
+                    push(Value(std::fmod(a->number(), b->number())));
+                    break;
+                }
 
-                        push((*a == Builtins::trueSym && *b == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
-                    }
+                case Instruction::TYPE:
+                {
+                    Value* a = popAndResolveAsPtr();
 
-                    case Instruction::OR_:
-                    {
-                        Value *a = popAndResolveAsPtr(), *b = popAndResolveAsPtr();
+                    push(Value(types_to_str[static_cast<unsigned>(a->valueType())]));
+                    break;
+                }
+
+                case Instruction::HASFIELD:
+                {
+                    Value *field = popAndResolveAsPtr(), *closure = popAndResolveAsPtr();
+
+                    if (closure->valueType() != ValueType::Closure)
+                        throw TypeError("Argument no 1 of hasField should be a Closure");
+                    if (field->valueType() != ValueType::String)
+                        throw TypeError("Argument no 2 of hasField should be a String");
 
-                        push((*b == Builtins::trueSym || *a == Builtins::trueSym) ? Builtins::trueSym : Builtins::falseSym);
+                    auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), field->stringRef().toString());
+                    if (it == m_state->m_symbols.end())
+                    {
+                        push(Builtins::falseSym);
                         break;
                     }
 
-                    case Instruction::MOD:
-                    {
-                        Value *b = popAndResolveAsPtr(), *a = popAndResolveAsPtr();
+                    uint16_t id = static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it));
+                    push((*closure->refClosure().refScope())[id] != nullptr ? Builtins::trueSym : Builtins::falseSym);
 
-                        if (a->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of mod should be Numbers");
-                        if (b->valueType() != ValueType::Number)
-                            throw TypeError("Arguments of mod should be Numbers");
+                    break;
+                }
 
-                        push(Value(std::fmod(a->number(), b->number())));
-                        break;
-                    }
+                case Instruction::NOT:
+                {
+                    Value* a = popAndResolveAsPtr();
 
-                    case Instruction::TYPE:
-                    {
-                        Value* a = popAndResolveAsPtr();
+                    push(!(*a) ? Builtins::trueSym : Builtins::falseSym);
+                    break;
+                }
 
-                        push(Value(types_to_str[static_cast<unsigned>(a->valueType())]));
-                        break;
-                    }
+#pragma endregion
 
-                    case Instruction::HASFIELD:
-                    {
-                        Value *field = popAndResolveAsPtr(), *closure = popAndResolveAsPtr();
+                default:
+                    throwVMError("unknown instruction: " + std::to_string(static_cast<std::size_t>(inst)));
+                    break;
+            }
 
-                        if (closure->valueType() != ValueType::Closure)
-                            throw TypeError("Argument no 1 of hasField should be a Closure");
-                        if (field->valueType() != ValueType::String)
-                            throw TypeError("Argument no 2 of hasField should be a String");
+            // move forward
+            ++m_ip;
 
-                        auto it = std::find(m_state->m_symbols.begin(), m_state->m_symbols.end(), field->stringRef().toString());
-                        if (it == m_state->m_symbols.end())
-                        {
-                            push(Builtins::falseSym);
-                            break;
-                        }
+            if (--m_countdown <= 0)
+                checkBudget();
+        }
 
-                        uint16_t id = static_cast<uint16_t>(std::distance(m_state->m_symbols.begin(), it));
-                        push((*closure->refClosure().refScope())[id] != nullptr ? Builtins::trueSym : Builtins::falseSym);
+        --m_execute_depth;
+        m_until_frame_count = outer_until_frame_count;
+    }
 
-                        break;
-                    }
+    // ------------------------------------------
+    //                preemption
+    // ------------------------------------------
 
-                    case Instruction::NOT:
-                    {
-                        Value* a = popAndResolveAsPtr();
+    void VM::setBudget(std::size_t instructions, std::chrono::steady_clock::duration time) noexcept
+    {
+        m_budget_instructions = instructions;
+        m_budget_time = time;
+    }
 
-                        push(!(*a) ? Builtins::trueSym : Builtins::falseSym);
-                        break;
-                    }
+    bool VM::preempted() const noexcept
+    {
+        return m_suspension.has_value();
+    }
 
-#pragma endregion
+    Value VM::resume()
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
 
-                    default:
-                        throwVMError("unknown instruction: " + std::to_string(static_cast<std::size_t>(inst)));
-                        break;
-                }
+        if (!m_suspension)
+            throw std::runtime_error("VM::resume: the VM wasn't stopped by its budget");
 
-                // move forward
-                ++m_ip;
-            }
+        const Suspension suspension = *m_suspension;
+        m_suspension.reset();
+
+        safeRun(suspension.until_frame_count);
+
+        if (m_suspension)
+        {
+            m_suspension->returns_value = suspension.returns_value;
+            m_suspension->restore_registers = suspension.restore_registers;
+            m_suspension->ip = suspension.ip;
+            m_suspension->pp = suspension.pp;
+            return Builtins::nil;
         }
-        catch (const std::exception& e)
+
+        if (suspension.restore_registers)
         {
-            std::printf("%s\n", e.what());
-            backtrace();
-            m_exit_code = 1;
+            m_ip = suspension.ip;
+            m_pp = suspension.pp;
         }
-        catch (...)
+        else if (!suspension.returns_value)
         {
-            std::printf("Unknown error\n");
-            backtrace();
-            m_exit_code = 1;
+            m_ip = 0;
+            m_pp = 0;
         }
 
+        if (suspension.returns_value)
+            return popAndResolve();
+        return Builtins::nil;
+    }
+
+    int VM::exitCode() const noexcept
+    {
         return m_exit_code;
     }
 
+    std::size_t VM::collectCycles()
+    {
+        return m_collector.collect();
+    }
+
+    const CycleCollectorStats& VM::cycleCollectorStats() const noexcept
+    {
+        return m_collector.stats();
+    }
+
+    std::size_t VM::compiledPages() const noexcept
+    {
+        return m_jit ? m_jit->compiledPages() : 0;
+    }
+
+    std::size_t VM::deferredDestructions() const noexcept
+    {
+        return m_reclaimer ? m_reclaimer->taken() : 0;
+    }
+
+    std::size_t VM::retainedArenas() const noexcept
+    {
+        return m_retired_arenas.size();
+    }
+
+    void VM::setAllocator(Allocator* allocator) noexcept
+    {
+        m_allocator = allocator;
+    }
+
+    Allocator* VM::allocator() const noexcept
+    {
+        return m_allocator;
+    }
+
+    void VM::setMemoryLimit(std::size_t bytes)
+    {
+        if (m_allocator == nullptr && bytes != 0)
+        {
+            m_own_allocator.reset(new MallocAllocator());
+            m_allocator = m_own_allocator.get();
+        }
+        m_memory_limit = bytes;
+    }
+
+    std::size_t VM::memoryUsage() const noexcept
+    {
+        std::size_t usage = m_memory_outside_arena;
+        if (m_allocator != nullptr)
+            usage += m_allocator->bytesInUse();
+        for (const std::unique_ptr<ArenaAllocator>& arena : m_retired_arenas)
+            usage += arena->bytesInUse();
+        return usage;
+    }
+
+    VM::ArenaCall VM::enterArena()
+    {
+        if (m_call_arena == nullptr)
+            m_call_arena = std::make_unique<ArenaAllocator>();
+
+        ArenaCall arena_call { m_allocator, std::move(m_reclaimer) };
+        if (m_allocator != nullptr)
+            m_memory_outside_arena = m_allocator->bytesInUse();
+        m_allocator = m_call_arena.get();
+        return arena_call;
+    }
+
+    Value VM::leaveArena(ArenaCall&& arena_call, Value&& result)
+    {
+        m_allocator = arena_call.allocator;
+        m_reclaimer = std::move(arena_call.reclaimer);
+        m_memory_outside_arena = 0;
+
+        Value copy;
+        {
+            AllocatorGuard allocator_guard(m_allocator);
+            copy = deepCopy(result, /* usertypes */ true);
+        }
+        result = Value();
+
+        // the scopes in a cycle were never freed
+        releaseMemory();
+        if (m_call_arena->bytesInUse() != 0)
+            m_collector.collect();
+
+        m_retired_arenas.erase(
+            std::remove_if(m_retired_arenas.begin(), m_retired_arenas.end(), [](const std::unique_ptr<ArenaAllocator>& arena) { return arena->bytesInUse() == 0; }),
+            m_retired_arenas.end());
+
+        // some objects are still used, by the global scope, a suspended call or a coroutine
+        if (m_call_arena->bytesInUse() == 0)
+            m_call_arena->reset();
+        else
+            m_retired_arenas.push_back(std::move(m_call_arena));
+
+        return copy;
+    }
+
+    VM::StepResult VM::step(std::size_t instructions)
+    {
+        const std::size_t budget_instructions = m_budget_instructions;
+        const Clock::duration budget_time = m_budget_time;
+        m_budget_instructions = instructions;
+        m_budget_time = Clock::duration::zero();
+        m_stepping = true;
+
+        if (m_suspension)
+            resume();
+        else
+            run();
+
+        m_stepping = false;
+        m_budget_instructions = budget_instructions;
+        m_budget_time = budget_time;
+
+        StepResult result;
+        if (!m_suspension)
+            result.status = StepResult::Status::Done;
+        else if (!m_suspension->blocked)
+            result.status = StepResult::Status::Running;
+        else
+        {
+            result.status = StepResult::Status::Blocked;
+            for (const Scheduler::PendingRead& pending : m_scheduler->reading)
+                result.fds.push_back(pending.fd);
+            if (!m_scheduler->sleeping.empty())
+                result.wake_up = m_scheduler->sleeping.top().first;
+        }
+        return result;
+    }
+
+    void VM::startSlice() noexcept
+    {
+        m_budget_left = m_budget_instructions != 0 ? static_cast<int64_t>(m_budget_instructions) : INT64_MAX;
+        if (m_budget_time != Clock::duration::zero())
+        {
+            m_deadline = Clock::now() + m_budget_time;
+            m_budget_window = std::min(m_budget_left, ArkVMDeadlineCheckInterval);
+        }
+        else
+            m_budget_window = m_budget_left;
+        if (m_memory_limit != 0)
+            m_budget_window = std::min(m_budget_window, ArkVMMemoryCheckInterval);
+        m_countdown = m_budget_window;
+    }
+
+    void VM::checkBudget()
+    {
+        // requested by the native code, which can't run a collection itself
+        if (m_collector.shouldCollect())
+            m_collector.collect();
+        if (m_memory_limit != 0)
+            checkMemoryLimit();
+
+        // the countdown can go below 0 when the native code ran a loop
+        m_budget_left -= m_budget_window - m_countdown;
+
+        const bool has_deadline = m_budget_time != Clock::duration::zero();
+        const bool spent = m_budget_left <= 0 || (has_deadline && Clock::now() >= m_deadline);
+
+        if (spent && m_running && m_execute_depth == 1)
+        {
+            m_suspension = Suspension { m_until_frame_count };
+            m_running = false;
+        }
+
+        // once spent, check on each instruction until the VM can stop: out of the functions called by builtins
+        if (spent)
+            m_budget_window = 1;
+        else
+            m_budget_window = has_deadline ? std::min(m_budget_left, ArkVMDeadlineCheckInterval) : m_budget_left;
+        if (m_memory_limit != 0)
+            m_budget_window = std::min(m_budget_window, ArkVMMemoryCheckInterval);
+        m_countdown = m_budget_window;
+    }
+
+    void VM::checkMemoryLimit()
+    {
+        if (memoryUsage() <= m_memory_limit)
+            return;
+
+        // the memory kept by the VM without using it is freed before giving up
+        releaseMemory();
+        if (memoryUsage() > m_memory_limit)
+            m_collector.collect();
+        if (memoryUsage() > m_memory_limit)
+            throw MemoryLimitError(m_memory_limit);
+    }
+
+    void VM::releaseMemory()
+    {
+        // the values popped are still in the stack, until other ones are pushed
+        for (std::size_t i = m_sp; i < ArkVMStackSize && (*m_stack)[i].valueType() != ValueType::Undefined; ++i)
+            (*m_stack)[i] = Value();
+
+        // the expired scopes tracked by the collector are kept by the control block of their std::shared_ptr
+        m_collector.purge();
+    }
+
     // ------------------------------------------
     //             error handling
     // ------------------------------------------
@@ -1122,9 +1556,10 @@ namespace Ark
 
             // display variables values in the current scope
             std::printf("\nCurrent scope variables values:\n");
-            for (std::size_t i = 0, size = old_scope.size(); i < size; ++i)
-                std::cerr << termcolor::cyan << m_state->m_symbols[old_scope.m_data[i].first] << termcolor::reset
-                          << " = " << old_scope.m_data[i].second << "\n";
+            old_scope.forEach([this](uint16_t id, const Value& value) {
+                std::cerr << termcolor::cyan << m_state->m_symbols[id] << termcolor::reset
+                          << " = " << value << "\n";
+            });
 
             while (m_fc != 1)
             {
@@ -0,0 +1,313 @@
+#include <Ark/VM/VMPool.hpp>
+
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+namespace Ark
+{
+    using namespace internal;
+
+    /**
+     * @brief Copies a scope of global variables, and the scopes and upvalues of the closures found in it
+     * @details A scope or an upvalue shared by several closures is copied once, and shared by their copies. An upvalue
+     *          open on the copied scope is open on the copy.
+     *
+     */
+    class VMPool::GlobalsCopier
+    {
+    public:
+        GlobalsCopier(const Scope& from, Scope& to) noexcept :
+            m_from(from), m_to(to)
+        {}
+
+        /**
+         * @brief Copy a value if it holds closures
+         *
+         * @param value
+         * @return std::optional<Value> nothing if the value can be shared with the copy
+         */
+        std::optional<Value> copy(const Value& value)
+        {
+            std::optional<Value> copy;
+
+            switch (value.valueType())
+            {
+                case ValueType::Closure:
+                    copy = Value(Closure(scope(value.closure().scope().get()), value.closure().pageAddr()));
+                    break;
+
+                case ValueType::List:
+                {
+                    const SharedList& list = value.listView();
+                    std::vector<Value> elements;
+                    for (std::size_t i = 0, end = list.size(); i < end; ++i)
+                    {
+                        std::optional<Value> element = this->copy(list[i]);
+                        if (element.has_value() && elements.empty())
+                        {
+                            elements.reserve(end);
+                            elements.insert(elements.end(), list.begin(), list.begin() + i);
+                        }
+                        if (element.has_value())
+                            elements.push_back(std::move(element.value()));
+                        else if (!elements.empty())
+                            elements.push_back(list[i]);
+                    }
+                    if (!elements.empty())
+                        copy = Value(std::move(elements));
+                    break;
+                }
+
+                case ValueType::Dict:
+                {
+                    std::optional<Dict> dict;
+                    for (const Dict::Entry& entry : value.dict().entries())
+                    {
+                        if (std::optional<Value> element = this->copy(entry.value); element.has_value())
+                        {
+                            if (!dict.has_value())
+                                dict = value.dict();
+                            dict->set(entry.key, element.value());
+                        }
+                    }
+                    if (dict.has_value())
+                        copy = Value(std::move(dict.value()));
+                    break;
+                }
+
+                case ValueType::Set:
+                {
+                    // the closures are hashed by scope, the set is built again with the copies
+                    bool closures = false;
+                    std::vector<Value> elements;
+                    for (const Set::Entry& entry : value.set().entries())
+                    {
+                        std::optional<Value> element = this->copy(entry.key);
+                        closures = closures || element.has_value();
+                        elements.push_back(element.has_value() ? std::move(element.value()) : entry.key);
+                    }
+                    if (closures)
+                    {
+                        Set set;
+                        for (const Value& element : elements)
+                            set.insert(element);
+                        copy = Value(std::move(set));
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+            }
+
+            if (copy.has_value())
+                copy->setConst(value.isConst());
+            return copy;
+        }
+
+    private:
+        const Scope& m_from;
+        Scope& m_to;
+        std::unordered_map<const Scope*, Scope_t> m_scopes;
+        std::unordered_map<const Upvalue*, Upvalue_t> m_upvalues;
+
+        /**
+         * @brief Copy the variables and the captured variables of a scope in an empty one, at the same indices
+         *
+         * @param from
+         * @param to
+         */
+        void fill(const Scope& from, Scope& to)
+        {
+            to.m_data.reserve(from.m_data.size());
+            for (const auto& [id, value] : from.m_data)
+            {
+                std::optional<Value> copy = this->copy(value);
+                to.m_data.emplace_back(id, copy.has_value() ? std::move(copy.value()) : value);
+            }
+            for (const auto& [id, captured] : from.m_upvalues)
+                to.m_upvalues.emplace_back(id, upvalue(captured));
+        }
+
+        Scope* frame(const Scope* from)
+        {
+            return (from == &m_from) ? &m_to : scope(from).get();
+        }
+
+        Scope_t scope(const Scope* from)
+        {
+            if (auto it = m_scopes.find(from); it != m_scopes.end())
+                return it->second;
+
+            // registered before being filled, for the closures stored in the scope they captured
+            Scope_t copy = makeShared<Scope>();
+            m_scopes.emplace(from, copy);
+            fill(*from, *copy);
+            return copy;
+        }
+
+        Upvalue_t upvalue(const Upvalue_t& from)
+        {
+            if (auto it = m_upvalues.find(from.get()); it != m_upvalues.end())
+                return it->second;
+
+            Upvalue_t copy;
+            if (from->isOpen())
+            {
+                Scope* scope = frame(from->m_frame);
+                copy = scope->m_open.emplace_back(makeShared<Upvalue>(scope, from->m_index));
+                m_upvalues.emplace(from.get(), copy);
+            }
+            else
+            {
+                copy = makeShared<Upvalue>(nullptr, 0);
+                m_upvalues.emplace(from.get(), copy);
+                std::optional<Value> value = this->copy(from->m_closed);
+                copy->m_closed = value.has_value() ? std::move(value.value()) : from->m_closed;
+            }
+            return copy;
+        }
+    };
+
+    VMPool::Handle::Handle(VMPool* pool, Slot* slot) noexcept :
+        m_pool(pool), m_slot(slot)
+    {}
+
+    VMPool::Handle::Handle(Handle&& other) noexcept :
+        m_pool(other.m_pool), m_slot(other.m_slot)
+    {
+        other.m_slot = nullptr;
+    }
+
+    VMPool::Handle::~Handle()
+    {
+        if (m_slot != nullptr)
+            m_pool->release(*m_slot);
+    }
+
+    VMPool::VMPool(State* state, std::size_t size) :
+        m_size(size != 0 ? size : std::max(1u, std::thread::hardware_concurrency())),
+        m_next(0)
+    {
+        m_slots = std::make_unique<Slot[]>(m_size);
+
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            Slot& slot = m_slots[i];
+            slot.vm = std::make_unique<VM>(state);
+
+            bool initialized = false;
+            if (i > 0)
+            {
+                try
+                {
+                    slot.vm->initFrom(*m_slots[0].vm);
+                    initialized = true;
+                }
+                catch (const std::exception&)
+                {
+                    // the global variables can't be copied, run the program again instead
+                }
+            }
+
+            if (!initialized)
+            {
+                if (int code = slot.vm->run(); code != 0)
+                    throw std::runtime_error("VMPool: the program exited with code " + std::to_string(code));
+            }
+
+            copyGlobals(slot, true);
+        }
+    }
+
+    VMPool::~VMPool() = default;
+
+    VMPool::Handle VMPool::acquire()
+    {
+        // each thread starts at a different VM, to avoid trying the same ones
+        const std::size_t start = m_next.fetch_add(1, std::memory_order_relaxed);
+
+        while (true)
+        {
+            for (std::size_t i = 0; i < m_size; ++i)
+            {
+                Slot& slot = m_slots[(start + i) % m_size];
+
+                bool used = false;
+                if (slot.used.load(std::memory_order_relaxed) ||
+                    !slot.used.compare_exchange_strong(used, true, std::memory_order_acquire))
+                    continue;
+
+                if (slot.dirty)
+                {
+                    try
+                    {
+                        copyGlobals(slot, false);
+                    }
+                    catch (...)
+                    {
+                        slot.used.store(false, std::memory_order_release);
+                        throw;
+                    }
+                    slot.dirty = false;
+                }
+                return Handle(this, &slot);
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    void VMPool::copyGlobals(Slot& slot, bool save)
+    {
+        Scope& live = *slot.vm->m_locals[0];
+        const Scope& from = save ? live : slot.globals;
+        Scope& to = save ? slot.globals : live;
+
+        // the closures of the previous use may still hold upvalues opened on the variables
+        for (Upvalue_t& upvalue : to.m_open)
+            upvalue->close();
+        to.m_open.clear();
+        to.m_data.clear();
+        to.m_upvalues.clear();
+
+        GlobalsCopier copier(from, to);
+        if (save)
+            slot.with_closures.clear();
+
+        // when restoring, the variables without closures share their buffers with the saved ones, copied on write
+        to.m_data.reserve(from.m_data.size());
+        for (std::size_t i = 0, end = from.m_data.size(); i < end; ++i)
+        {
+            const auto& [id, value] = from.m_data[i];
+            std::optional<Value> copy = (save || slot.with_closures[i]) ? copier.copy(value) : std::nullopt;
+            if (save)
+                slot.with_closures.push_back(copy.has_value());
+            to.m_data.emplace_back(id, copy.has_value() ? std::move(copy.value()) : value);
+        }
+        to.m_upvalues = from.m_upvalues;
+    }
+
+    void VMPool::release(Slot& slot) noexcept
+    {
+        VM& vm = *slot.vm;
+
+        // back to the state in which the VM was after running the program, its globals are restored by acquire
+        vm.m_ip = 0;
+        vm.m_pp = 0;
+        vm.m_sp = 0;
+        vm.m_fc = 1;
+        vm.m_running = false;
+        vm.m_exit_code = 0;
+        vm.m_saved_scope.reset();
+        vm.m_scheduler.reset();
+        vm.m_suspension.reset();
+        vm.m_scope_count_to_delete.resize(1);
+        vm.m_scope_count_to_delete[0] = 0;
+        vm.m_locals.resize(1);
+        slot.dirty = true;
+
+        slot.used.store(false, std::memory_order_release);
+    }
+}
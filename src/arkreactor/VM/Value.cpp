@@ -2,6 +2,9 @@
 
 #include <Ark/Utils.hpp>
 
+#include <string_view>
+#include <functional>
+
 #define init_const_type(is_const, type) ((is_const ? (1 << 7) : 0) | static_cast<uint8_t>(type))
 
 namespace Ark
@@ -16,9 +19,15 @@ namespace Ark
         m_const_type(init_const_type(false, type))
     {
         if (type == ValueType::List)
-            m_value = std::vector<Value>();
+            m_value = internal::SharedList();
+        else if (type == ValueType::Dict)
+            m_value = internal::Dict();
+        else if (type == ValueType::Set)
+            m_value = internal::Set();
+        else if (type == ValueType::Array)
+            m_value = internal::Array();
         else if (type == ValueType::String)
-            m_value = "";
+            m_value = internal::SharedString();
 
 #ifdef ARK_PROFILER_COUNT
         value_creations++;
@@ -26,9 +35,9 @@ namespace Ark
     }
 
 #ifdef ARK_PROFILER_COUNT
-    extern unsigned value_creations = 0;
-    extern unsigned value_copies = 0;
-    extern unsigned value_moves = 0;
+    unsigned value_creations = 0;
+    unsigned value_copies = 0;
+    unsigned value_moves = 0;
 
     Value::Value(const Value& val) noexcept :
         m_value(val.m_value),
@@ -57,6 +66,17 @@ namespace Ark
 
         return *this;
     }
+
+    Value& Value::operator=(Value&& other) noexcept
+    {
+        m_value = std::move(other.m_value);
+        m_const_type = std::move(other.m_const_type);
+
+        if (valueType() != ValueType::Reference)
+            value_moves++;
+
+        return *this;
+    }
 #endif
 
     Value::Value(int value) noexcept :
@@ -72,15 +92,19 @@ namespace Ark
     {}
 
     Value::Value(const std::string& value) noexcept :
-        m_value(value.c_str()), m_const_type(init_const_type(false, ValueType::String))
+        m_value(internal::SharedString(value)), m_const_type(init_const_type(false, ValueType::String))
     {}
 
     Value::Value(const String& value) noexcept :
-        m_value(value), m_const_type(init_const_type(false, ValueType::String))
+        m_value(internal::SharedString(std::string_view(value.c_str(), value.size()))), m_const_type(init_const_type(false, ValueType::String))
     {}
 
     Value::Value(const char* value) noexcept :
-        m_value(value), m_const_type(init_const_type(false, ValueType::String))
+        m_value(internal::SharedString(value)), m_const_type(init_const_type(false, ValueType::String))
+    {}
+
+    Value::Value(internal::SharedString&& value) noexcept :
+        m_value(std::move(value)), m_const_type(init_const_type(false, ValueType::String))
     {}
 
     Value::Value(internal::PageAddr_t value) noexcept :
@@ -92,7 +116,11 @@ namespace Ark
     {}
 
     Value::Value(std::vector<Value>&& value) noexcept :
-        m_value(value), m_const_type(init_const_type(false, ValueType::List))
+        m_value(internal::SharedList(std::move(value))), m_const_type(init_const_type(false, ValueType::List))
+    {}
+
+    Value::Value(internal::SharedList&& value) noexcept :
+        m_value(std::move(value)), m_const_type(init_const_type(false, ValueType::List))
     {}
 
     Value::Value(internal::Closure&& value) noexcept :
@@ -103,6 +131,18 @@ namespace Ark
         m_value(value), m_const_type(init_const_type(false, ValueType::User))
     {}
 
+    Value::Value(internal::Dict&& value) noexcept :
+        m_value(std::move(value)), m_const_type(init_const_type(false, ValueType::Dict))
+    {}
+
+    Value::Value(internal::Set&& value) noexcept :
+        m_value(std::move(value)), m_const_type(init_const_type(false, ValueType::Set))
+    {}
+
+    Value::Value(internal::Array&& value) noexcept :
+        m_value(std::move(value)), m_const_type(init_const_type(false, ValueType::Array))
+    {}
+
     Value::Value(Value* ref) noexcept :
         m_value(ref), m_const_type(init_const_type(true, ValueType::Reference))
     {}
@@ -111,7 +151,7 @@ namespace Ark
 
     std::vector<Value>& Value::list()
     {
-        return std::get<std::vector<Value>>(m_value);
+        return std::get<internal::SharedList>(m_value).mut();
     }
 
     internal::Closure& Value::refClosure()
@@ -119,9 +159,9 @@ namespace Ark
         return std::get<internal::Closure>(m_value);
     }
 
-    String& Value::stringRef()
+    internal::SharedString& Value::stringRef()
     {
-        return std::get<String>(m_value);
+        return std::get<internal::SharedString>(m_value);
     }
 
     UserType& Value::usertypeRef()
@@ -129,6 +169,21 @@ namespace Ark
         return std::get<UserType>(m_value);
     }
 
+    internal::Dict& Value::dictRef()
+    {
+        return std::get<internal::Dict>(m_value);
+    }
+
+    internal::Set& Value::setRef()
+    {
+        return std::get<internal::Set>(m_value);
+    }
+
+    internal::Array& Value::arrayRef()
+    {
+        return std::get<internal::Array>(m_value);
+    }
+
     Value* Value::reference() const
     {
         return std::get<Value*>(m_value);
@@ -136,14 +191,103 @@ namespace Ark
 
     // --------------------------
 
+    namespace
+    {
+        inline std::size_t hashCombine(std::size_t seed, std::size_t hash) noexcept
+        {
+            return seed ^ (hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+        }
+
+        inline std::size_t hashNumber(double d) noexcept
+        {
+            return std::hash<double> {}(d == 0.0 ? 0.0 : d);  // -0.0 == 0.0
+        }
+    }
+
+    std::size_t Value::hash() const noexcept
+    {
+        const std::size_t seed = static_cast<std::size_t>(valueType());
+
+        switch (valueType())
+        {
+            case ValueType::Number:
+                return hashCombine(seed, hashNumber(number()));
+
+            case ValueType::String:
+                return hashCombine(seed, std::hash<std::string_view> {}(string().view()));
+
+            case ValueType::PageAddr:
+                return hashCombine(seed, pageAddr());
+
+            case ValueType::CProc:
+                return hashCombine(seed, std::hash<ProcType> {}(proc()));
+
+            case ValueType::Closure:
+                return hashCombine(seed, std::hash<const void*> {}(closure().scope().get()));
+
+            case ValueType::User:
+                return hashCombine(seed, std::hash<const void*> {}(usertype().data()));
+
+            case ValueType::List:
+            {
+                std::size_t h = hashCombine(seed, listView().size());
+                for (const Value& item : listView())
+                    h = hashCombine(h, item.hash());
+                return h;
+            }
+
+            case ValueType::Array:
+            {
+                std::size_t h = hashCombine(seed, array().size());
+                for (double d : array().get())
+                    h = hashCombine(h, hashNumber(d));
+                return h;
+            }
+
+            // dicts and sets are equal regardless of the order of their entries
+            case ValueType::Dict:
+            {
+                std::size_t h = 0;
+                for (const internal::Dict::Entry& entry : dict().entries())
+                    h += hashCombine(entry.key.hash(), entry.value.hash());
+                return hashCombine(seed, h);
+            }
+
+            case ValueType::Set:
+            {
+                std::size_t h = 0;
+                for (const internal::Set::Entry& entry : set().entries())
+                    h += entry.key.hash();
+                return hashCombine(seed, h);
+            }
+
+            case ValueType::Reference:
+                return hashCombine(seed, std::hash<const void*> {}(reference()));
+
+            // the other types are equal when their types are
+            default:
+                return seed;
+        }
+    }
+
+    // --------------------------
+
     void Value::push_back(const Value& value)
     {
-        list().push_back(value);
+        // take a copy first when appending a list to itself, so that its buffer is shared and copied
+        // instead of being modified in place (the list would end up containing itself)
+        if (&value == this)
+        {
+            Value copy = value;
+            list().push_back(std::move(copy));
+        }
+        else
+            list().push_back(value);
     }
 
     void Value::push_back(Value&& value)
     {
-        list().push_back(value);
+        list().push_back(std::move(value));
     }
 
     // --------------------------
@@ -161,7 +305,7 @@ namespace Ark
             }
 
             case ValueType::String:
-                os << V.string().c_str();
+                os << V.string();
                 break;
 
             case ValueType::PageAddr:
@@ -175,7 +319,7 @@ namespace Ark
             case ValueType::List:
             {
                 os << "[";
-                for (auto it = V.constList().begin(), it_end = V.constList().end(); it != it_end; ++it)
+                for (auto it = V.listView().begin(), it_end = V.listView().end(); it != it_end; ++it)
                 {
                     if (it->valueType() == ValueType::String)
                         os << "\"" << (*it) << "\"";
@@ -196,6 +340,62 @@ namespace Ark
                 os << V.usertype();
                 break;
 
+            case ValueType::Array:
+            {
+                os << "#[";
+                const std::vector<double>& data = V.array().get();
+                for (std::size_t i = 0, end = data.size(); i < end; ++i)
+                {
+                    if (i != 0)
+                        os << " ";
+                    os.precision(Utils::digPlaces(data[i]) + Utils::decPlaces(data[i]));
+                    os << data[i];
+                }
+                os << "]";
+                break;
+            }
+
+            case ValueType::Set:
+            {
+                os << "{";
+                const std::vector<internal::Set::Entry>& entries = V.set().entries();
+                for (std::size_t i = 0, end = entries.size(); i < end; ++i)
+                {
+                    if (i != 0)
+                        os << " ";
+                    if (entries[i].key.valueType() == ValueType::String)
+                        os << "\"" << entries[i].key << "\"";
+                    else
+                        os << entries[i].key;
+                }
+                os << "}";
+                break;
+            }
+
+            case ValueType::Dict:
+            {
+                // strings are quoted, like in lists
+                auto display = [&os](const Value& item) {
+                    if (item.valueType() == ValueType::String)
+                        os << "\"" << item << "\"";
+                    else
+                        os << item;
+                };
+
+                os << "{";
+                const std::vector<internal::Dict::Entry>& entries = V.dict().entries();
+                for (std::size_t i = 0, end = entries.size(); i < end; ++i)
+                {
+                    if (i != 0)
+                        os << ", ";
+                    display(entries[i].key);
+                    os << ": ";
+                    display(entries[i].value);
+                }
+                os << "}";
+                break;
+            }
+
             case ValueType::Nil:
                 os << "nil";
                 break;
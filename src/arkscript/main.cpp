@@ -1,7 +1,9 @@
 #include <cstdio>
 #include <iostream>
 #include <optional>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
 
 #include <clipp.h>
 #include <termcolor/termcolor.hpp>
@@ -32,16 +34,22 @@ int main(int argc, char** argv)
         run,
         repl,
         compile,
-        eval
+        eval,
+        emit_cpp,
+        compare_engines
     };
     mode selected = mode::repl;
     uint16_t options = Ark::DefaultFeatures;
 
     std::string file = "",
                 lib_dir = "?",
-                eval_expresion = "";
+                eval_expresion = "",
+                output = "",
+                native_module = "",
+                heap_profile = "";
 
     unsigned debug = 0;
+    std::size_t memory_limit = 0;
 
     uint16_t bcr_page = ~0,
              bcr_start = ~0,
@@ -64,6 +72,19 @@ int main(int argc, char** argv)
             & value("file", file)
             , joinable(repeatable(option("-d", "--debug").call([&]{ debug++; }).doc("Increase debug level (default: 0)")))
         )
+        | (
+            required("--emit-cpp").set(selected, mode::emit_cpp).doc("Translate the given program to C++, to be built as a shared library loaded with --native")
+            & value("file", file)
+            & value("output", output)
+            , option("-L", "--lib").doc("Set the location of the ArkScript standard library")
+                & value("lib_dir", lib_dir)
+        )
+        | (
+            required("--compare-engines").set(selected, mode::compare_engines).doc("Run the given program with the stack VM and the register VM, then compare their instructions counts and runtime")
+            & value("file", file)
+            , option("-L", "--lib").doc("Set the location of the ArkScript standard library")
+                & value("lib_dir", lib_dir)
+        )
         | (
             required("-bcr", "--bytecode-reader").set(selected, mode::bytecode_reader).doc("Launch the bytecode reader")
             & value("file", file)
@@ -96,6 +117,18 @@ int main(int argc, char** argv)
                     option("-L", "--lib").doc("Set the location of the ArkScript standard library")
                     & value("lib_dir", lib_dir)
                 )
+                , (
+                    option("--native").doc("Load the code pages translated with --emit-cpp from a shared library")
+                    & value("module", native_module)
+                )
+                , (
+                    option("--memory-limit").doc("Stop the program with an error once its objects use more than the given number of bytes")
+                    & value("bytes", memory_limit)
+                )
+                , (
+                    option("--heap-profile").doc("Write a census of the objects alive at the end of the program to the given file")
+                    & value("output", heap_profile)
+                )
             )
             , any_other(script_args)
         )
@@ -147,6 +180,7 @@ int main(int argc, char** argv)
                     "    sizeof(vector<Ark::Value>) = %zuB\n"
                     "    sizeof(std::string)   = %zuB\n"
                     "    sizeof(String)        = %zuB\n"
+                    "    sizeof(Ark::SharedString) = %zuB\n"
                     "    sizeof(char)          = %zuB\n",
                     ARK_COMPILER, ARK_COMPILATION_OPTIONS,
                     // value
@@ -164,6 +198,7 @@ int main(int argc, char** argv)
                     sizeof(std::vector<Ark::Value>),
                     sizeof(std::string),
                     sizeof(String),
+                    sizeof(Ark::internal::SharedString),
                     sizeof(char));
                 break;
             }
@@ -201,18 +236,36 @@ int main(int argc, char** argv)
                     return -1;
                 }
 
+                if (!native_module.empty() && !state.loadNativePages(native_module))
+                {
+                    std::cerr << "Could not load native pages from " << native_module << "\n";
+                    return -1;
+                }
+
                 Ark::VM vm(&state);
+                vm.setMemoryLimit(memory_limit);
                 int out = vm.run();
 
+                if (!heap_profile.empty())
+                {
+                    std::ofstream profile_file(heap_profile);
+                    if (!profile_file.is_open())
+                    {
+                        std::cerr << "Could not write the heap profile to " << heap_profile << "\n";
+                        return -1;
+                    }
+                    vm.heapProfile().write(profile_file);
+                }
+
 #ifdef ARK_PROFILER_COUNT
                 std::printf(
                     "\n\nValue\n"
                     "=====\n"
                     "\tCreations: %u\n\tCopies: %u\n\tMoves: %u\n\n\tCopy coeff: %f",
-                    Ark::internal::value_creations,
-                    Ark::internal::value_copies,
-                    Ark::internal::value_moves,
-                    static_cast<float>(Ark::internal::value_copies) / Ark::internal::value_creations);
+                    Ark::value_creations,
+                    Ark::value_copies,
+                    Ark::value_moves,
+                    static_cast<float>(Ark::value_copies) / Ark::value_creations);
 #endif
 
                 return out;
@@ -233,6 +286,73 @@ int main(int argc, char** argv)
                 return vm.run();
             }
 
+            case mode::emit_cpp:
+            {
+                Ark::State state(options, lib_dir);
+                state.setDebug(debug);
+
+                if (!state.doFile(file))
+                {
+                    std::cerr << "Could not compile file at " << file << "\n";
+                    return -1;
+                }
+
+                if (!Ark::CppEmitter(state).saveTo(output))
+                {
+                    std::cerr << "Could not write C++ code to " << output << "\n";
+                    return -1;
+                }
+
+                break;
+            }
+
+            case mode::compare_engines:
+            {
+                using clock = std::chrono::steady_clock;
+                auto elapsed = [](clock::time_point start) {
+                    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+                };
+
+                Ark::Compiler compiler(debug, lib_dir, options);
+                Ark::RegisterCompiler register_compiler(compiler);
+                try
+                {
+                    compiler.feed(Ark::Utils::readFile(file), file);
+                    compiler.compile();
+                    register_compiler.compile();
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << e.what() << "\n";
+                    return -1;
+                }
+
+                Ark::State state(options, lib_dir);
+                state.setDebug(debug);
+                if (!state.feed(compiler.bytecode()))
+                    return -1;
+
+                Ark::VM vm(&state);
+                clock::time_point start = clock::now();
+                int stack_out = vm.run();
+                double stack_time = elapsed(start);
+
+                Ark::RegisterVM register_vm(register_compiler);
+                start = clock::now();
+                int register_out = register_vm.run();
+                double register_time = elapsed(start);
+
+                std::printf(
+                    "\n%-12s %14s %14s %12s\n"
+                    "%-12s %14zu %14s %10.3fms\n"
+                    "%-12s %14zu %14llu %10.3fms\n",
+                    "engine", "instructions", "executed", "time",
+                    "stack", compiler.instructionsCount(), "-", stack_time,
+                    "register", register_compiler.instructionsCount(), register_vm.executedInstructions(), register_time);
+
+                return (stack_out != 0) ? stack_out : register_out;
+            }
+
             case mode::bytecode_reader:
             {
                 uint16_t not_0 = ~0;
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+// functions are called more than ArkJITCallThreshold times, to be sure that they get compiled to native code
+const std::string code = R"code(
+(let fib (fun (n)
+    (if (< n 2)
+        n
+        (+ (fib (- n 1)) (fib (- n 2))))))
+
+(let loop (fun (n) {
+    (mut i 0)
+    (mut acc 0)
+    (while (< i n) {
+        (if (>= (/ i 2) 3)
+            (set acc (+ acc (* i 1.5)))
+            (set acc (- acc 1)))
+        (if (!= i 7)
+            (set acc (+ acc 1)))
+        (set i (+ i 1)) })
+    acc }))
+
+(let compare (fun (a b) [(< a b) (<= a b) (> a b) (>= a b) (= a b) (!= a b)]))
+(let branches (fun (a b) [
+    (if (< a b) 1 0)
+    (if (<= a b) 1 0)
+    (if (> a b) 1 0)
+    (if (>= a b) 1 0)
+    (if (= a b) 1 0)
+    (if (!= a b) 1 0)]))
+(let add (fun (a b) (+ a b)))
+
+(mut total 0)
+(mut comparisons [])
+(mut strings "")
+(mut i 0)
+(while (< i 100) {
+    (set total (+ total (loop 20)))
+    (set comparisons (compare (mod i 3) 1))
+    (branches (mod i 3) 1)
+    (set strings (add "a" (add (toString (mod i 2)) "b")))
+    (set i (+ i 1)) })
+
+(let result [
+    (fib 18)
+    total
+    comparisons
+    (compare 1 1)
+    (compare math:NaN 1)
+    (compare 1 math:NaN)
+    (branches 1 1)
+    (branches math:NaN 1)
+    (branches 1 math:NaN)
+    strings])
+)code";
+
+std::string run(uint16_t options, std::size_t* compiled = nullptr)
+{
+    Ark::State state(options);
+    if (!state.doString(code))
+        return "state.doString() failed";
+
+    Ark::VM vm(&state);
+    if (vm.run() != 0)
+        return "vm.run() failed";
+
+    if (compiled != nullptr)
+        *compiled = vm.compiledPages();
+
+    std::stringstream ss;
+    ss << vm["result"];
+    return ss.str();
+}
+
+int main()
+{
+    std::size_t compiled = 0;
+    std::string jit = run(Ark::DefaultFeatures, &compiled);
+    std::string interpreted = run(Ark::DefaultFeatures & ~Ark::FeatureJIT);
+
+    if (jit != interpreted)
+    {
+        std::cerr << "native code returned " << jit << "\n"
+                  << "interpreter returned  " << interpreted << "\n";
+        return 1;
+    }
+#ifdef ARK_JIT
+    // otherwise the interpreter was compared with itself
+    if (compiled == 0)
+    {
+        std::cerr << "no code page was compiled to native code\n";
+        return 1;
+    }
+#endif
+    std::cout << jit;
+
+    RETURN_PASSED()
+}
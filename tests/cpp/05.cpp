@@ -0,0 +1,130 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+const std::string code = R"code(
+(let fib (fun (n)
+    (if (< n 2)
+        n
+        (+ (fib (- n 1)) (fib (- n 2))))))
+
+(let loop (fun (n) {
+    (mut i 0)
+    (mut acc 0)
+    (while (< i n) {
+        (if (>= (/ i 2) 3)
+            (set acc (+ acc (* i 1.5)))
+            (set acc (- acc 1)))
+        (if (!= i 7)
+            (set acc (+ acc 1)))
+        (set i (+ i 1)) })
+    acc }))
+
+(let compare (fun (a b)
+    (+ (toString (< a b)) (toString (<= a b)) (toString (> a b)) (toString (>= a b)) (toString (= a b)) (toString (!= a b)))))
+(let logic (fun (a b)
+    (+ (toString (and a b)) (toString (or a b)) (toString (not a)))))
+
+(mut total 0)
+(mut i 0)
+(while (< i 10) {
+    (set total (+ total (loop 20) (mod i 3)))
+    (set i (+ i 1)) })
+
+(mut swap 1)
+(set swap (- 10 swap swap))
+
+(let result (+
+    (toString (fib 15)) " "
+    (toString total) " "
+    (toString swap) " "
+    (compare 1 2) " "
+    (compare 1 math:NaN) " "
+    (logic true false) " "
+    (logic true true) " "
+    (toString ((fun (x) (* x x)) 12))))
+)code";
+
+std::string runStack()
+{
+    Ark::State state;
+    if (!state.doString(code))
+        return "state.doString() failed";
+
+    Ark::VM vm(&state);
+    if (vm.run() != 0)
+        return "vm.run() failed";
+
+    std::stringstream ss;
+    ss << vm["result"];
+    return ss.str();
+}
+
+std::string runRegister()
+{
+    Ark::Compiler compiler(0, "?");
+    Ark::RegisterCompiler register_compiler(compiler);
+    try
+    {
+        compiler.feed(code);
+        register_compiler.compile();
+    }
+    catch (const std::exception& e)
+    {
+        return e.what();
+    }
+
+    Ark::RegisterVM vm(register_compiler);
+    if (vm.run() != 0)
+        return "vm.run() failed";
+
+    std::stringstream ss;
+    ss << vm["result"];
+    return ss.str();
+}
+
+// the builtins calling functions, suspending or exiting need a VM, which the register engine doesn't give them
+bool rejected(const std::string& program)
+{
+    Ark::Compiler compiler(0, "?");
+    Ark::RegisterCompiler register_compiler(compiler);
+    try
+    {
+        compiler.feed(program);
+        register_compiler.compile();
+    }
+    catch (const Ark::CompilationError&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    std::string stack = runStack();
+    std::string registers = runRegister();
+
+    if (stack != registers)
+    {
+        std::cerr << "register VM returned " << registers << "\n"
+                  << "stack VM returned    " << stack << "\n";
+        return 1;
+    }
+    std::cout << stack << "\n";
+
+    for (const std::string& program : {
+             "(sys:exit 0)",
+             "(let f sys:exit) (f 0)",
+             "(list:map 1 (fun (x) (+ x 1)))",
+             "(let g (fun (f) (f 1))) (g list:reduce)",
+             "(await (async (fun () (+ 1 1))))",
+             "(yield)" })
+        std::cout << program << " rejected: " << std::boolalpha << rejected(program) << "\n";
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(R"code(
+(let offsets [1 2 3])
+(let fib (fun (n)
+    (if (< n 2)
+        n
+        (+ (fib (- n 1)) (fib (- n 2))))))
+(let work (fun (n) (+ (fib n) (@ offsets (mod n 3)))))
+
+(mut calls 0)
+(let counting (fun (n &calls) {
+    (set calls (+ 1 calls))
+    n }))
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    std::vector<Ark::Value> values;
+    for (int i = 0; i < 100; ++i)
+        values.emplace_back(i % 20);
+
+    // a few chunks per worker, which they take from a shared counter
+    std::vector<Ark::Value> results = vm.parallelMap("work", values, 8);
+    if (results.size() != values.size())
+    {
+        std::cerr << "parallelMap returned " << results.size() << " values instead of " << values.size() << "\n";
+        return 1;
+    }
+
+    double total = 0;
+    for (const Ark::Value& result : results)
+        total += result.number();
+    std::cout << total << "\n";
+
+    Ark::Value first = results[19];
+    CHECK_VALUE_NUMBER(first, 4181 + 2)
+
+    try
+    {
+        vm.parallelMap("counting", values, 8);
+        std::cerr << "parallelMap accepted a closure capturing a mutable variable\n";
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << "\n";
+    }
+
+    RETURN_PASSED()
+}
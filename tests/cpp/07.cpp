@@ -0,0 +1,90 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(R"code(
+(print "initialized")
+(let square (fun (x) (* x x)))
+
+(mut calls 0)
+(let count-calls (fun () {
+    (set calls (+ 1 calls))
+    calls }))
+)code");
+
+    // the program is run only once, by the first VM
+    Ark::VMPool pool(&state, 4);
+
+    std::vector<double> totals(8, 0.0);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < totals.size(); ++t)
+    {
+        threads.emplace_back([&pool, &totals, t]() {
+            for (int i = 0; i < 100; ++i)
+                totals[t] += pool.call("square", i).number();
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (double total : totals)
+        std::cout << total << " ";
+    std::cout << "\n";
+
+    // the VMs are reset to their global variables after each call
+    auto first = pool.call("count-calls");
+    auto second = pool.call("count-calls");
+    CHECK_VALUE_NUMBER(first, 1)
+    CHECK_VALUE_NUMBER(second, 1)
+
+    {
+        Ark::VMPool::Handle vm = pool.acquire();
+        vm->call("count-calls");
+        auto calls = vm->call("count-calls");
+        CHECK_VALUE_NUMBER(calls, 2)
+    }
+
+    // what a call changes through a closure doesn't leak into the next one either
+    for (uint16_t options : { Ark::DefaultFeatures, static_cast<uint16_t>(Ark::DefaultFeatures | Ark::FeatureSharedCaptures) })
+    {
+        Ark::State closures(options);
+        closures.doString(R"code(
+(let make-counter (fun () {
+    (mut n 0)
+    (fun (&n) {
+        (set n (+ 1 n))
+        n })}))
+(let counter (make-counter))
+(let counters [(make-counter)])
+(let first-counter (fun () ((@ counters 0))))
+
+(mut total 0)
+(let adder (fun (x &total) {
+    (set total (+ total x))
+    total }))
+)code");
+
+        Ark::VMPool single(&closures, 1);
+        for (int i = 0; i < 2; ++i)
+        {
+            Ark::VMPool::Handle vm = single.acquire();
+            auto count = vm->call("counter");
+            auto in_list = vm->call("first-counter");
+            vm->call("counter");
+            auto added = vm->call("adder", 5);
+            CHECK_VALUE_NUMBER(count, 1)
+            CHECK_VALUE_NUMBER(in_list, 1)
+            CHECK_VALUE_NUMBER(added, 5)
+        }
+    }
+
+    RETURN_PASSED()
+}
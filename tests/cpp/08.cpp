@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(R"code(
+(let sum (fun (n) {
+    (mut total 0)
+    (mut i 0)
+    (while (< i n) {
+        (set total (+ total i))
+        (set i (+ 1 i)) })
+    total }))
+(mut loops 0)
+(let forever (fun () (while true (set loops (+ 1 loops)))))
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    // enough calls for sum to be compiled to native code, when the JIT is enabled
+    for (int i = 0; i < 100; ++i)
+        vm.call("sum", 10);
+
+    // a function is run by slices of 1000 instructions
+    vm.setBudget(1000);
+    Ark::Value result = vm.call("sum", 10000);
+    int slices = 1;
+    while (vm.preempted())
+    {
+        result = vm.resume();
+        ++slices;
+    }
+    CHECK_VALUE_NUMBER(result, 49995000)
+    if (slices < 10)
+    {
+        std::cerr << "sum(10000) ran in " << slices << " slices\n";
+        return 1;
+    }
+    std::cout << "sum: " << result << "\n";
+
+    // a function which never returns is stopped by the time budget
+    vm.setBudget(0, std::chrono::milliseconds(5));
+    vm.call("forever");
+    for (int i = 0; i < 3; ++i)
+    {
+        if (!vm.preempted())
+        {
+            std::cerr << "forever returned\n";
+            return 1;
+        }
+        vm.resume();
+    }
+    std::cout << "forever: preempted\n";
+
+    // a runaway program as well
+    Ark::State runaway;
+    runaway.doString("(mut i 0) (while true (set i (+ 1 i)))");
+    Ark::VM other(&runaway);
+    other.setBudget(100000);
+    if (int code = other.run(); code != 0 || !other.preempted())
+    {
+        std::cerr << "the runaway program wasn't preempted\n";
+        return 1;
+    }
+    other.resume();
+    std::cout << "runaway: preempted " << other.preempted() << "\n";
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(R"code(
+(let work (fun (name delay) {
+    (sys:sleep delay)
+    (mut i 0)
+    (while (< i 100)
+        (set i (+ 1 i)))
+    name }))
+(let a (async work "a" 20))
+(let b (async work "b" 10))
+(let first (await b))
+(let second (await a))
+)code");
+
+    Ark::VM vm(&state);
+
+    // the host waits for the coroutines instead of the VM
+    int running = 0, blocked = 0;
+    Ark::VM::StepResult result = vm.step(50);
+    while (result.status != Ark::VM::StepResult::Status::Done)
+    {
+        if (result.status == Ark::VM::StepResult::Status::Blocked)
+        {
+            ++blocked;
+            if (!result.wake_up || !result.fds.empty())
+            {
+                std::cerr << "blocked without a timer\n";
+                return 1;
+            }
+            std::this_thread::sleep_until(*result.wake_up);
+        }
+        else
+            ++running;
+
+        result = vm.step(50);
+    }
+
+    if (vm.exitCode() != 0)
+        return 1;
+    std::cout << vm["first"] << " " << vm["second"] << "\n";
+    std::cout << (blocked >= 2 ? "blocked twice" : "not blocked") << ", " << (running >= 4 ? "ran by steps" : "ran at once") << "\n";
+
+    RETURN_PASSED()
+}
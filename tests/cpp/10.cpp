@@ -0,0 +1,56 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+
+    state.doString(R"code(
+(let make (fun (name) {
+    (mut other nil)
+    (let set-other (fun (o) (set other o)))
+    (fun (&name &other &set-other) ()) }))
+(let kept (make "kept"))
+(kept.set-other kept)
+(let name-of (fun () {
+    (let other kept.other)
+    other.name }))
+(let leak (fun (n) {
+    (mut i 0)
+    (mut object nil)
+    (while (< i n) {
+        (set object (make i))
+        (object.set-other object)
+        (set i (+ 1 i)) })
+    n }))
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    // each object references itself through the scope of its closure
+    Ark::Value result = vm.call("leak", 5000);
+    CHECK_VALUE_NUMBER(result, 5000)
+    if (vm.cycleCollectorStats().collections == 0)
+    {
+        std::cerr << "the cycle collector didn't run by itself\n";
+        return 1;
+    }
+
+    vm.collectCycles();
+    const Ark::CycleCollectorStats& stats = vm.cycleCollectorStats();
+    std::cout << "collected: " << stats.scopes_collected << "\n";
+    if (stats.max_pause < stats.last_pause || stats.total_pause < stats.max_pause)
+    {
+        std::cerr << "inconsistent pause times\n";
+        return 1;
+    }
+
+    // a cycle referenced by a variable is kept
+    std::cout << "alive: " << vm.call("name-of").string() << "\n";
+
+    RETURN_PASSED()
+}
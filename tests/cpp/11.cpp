@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+const std::string code = R"code(
+(let counter (fun () {
+    (mut n 0)
+    (let inc (fun (&n) (set n (+ 1 n))))
+    (inc)
+    (inc)
+    n }))
+(let make-pair (fun () {
+    (mut n 0)
+    (let get (fun (&n) { n }))
+    (let add (fun (&n) (set n (+ 1 n))))
+    [get add] }))
+(let closed (fun () {
+    (let pair (make-pair))
+    (let get (@ pair 0))
+    (let add (@ pair 1))
+    (add)
+    (add)
+    (add)
+    (get) }))
+(let make (fun (name) {
+    (mut other nil)
+    (let set-other (fun (o) (set other o)))
+    (fun (&name &other &set-other) ()) }))
+(let leak (fun (n) {
+    (mut i 0)
+    (mut object nil)
+    (while (< i n) {
+        (set object (make i))
+        (object.set-other object)
+        (set i (+ 1 i)) })
+    n }))
+)code";
+
+int main()
+{
+    // captured variables are copied by default
+    Ark::State copying;
+    copying.doString(code);
+    Ark::VM copying_vm(&copying);
+    CHECK_VM_RUN(copying_vm)
+    Ark::Value copied = copying_vm.call("counter");
+    CHECK_VALUE_NUMBER(copied, 0)
+
+    Ark::State state(Ark::DefaultFeatures | Ark::FeatureSharedCaptures);
+    state.doString(code);
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    // the closure modifies the variable of its frame
+    Ark::Value counted = vm.call("counter");
+    CHECK_VALUE_NUMBER(counted, 2)
+    std::cout << "counter: " << counted << "\n";
+
+    // two closures share the variable, once their frame is gone
+    Ark::Value shared = vm.call("closed");
+    CHECK_VALUE_NUMBER(shared, 3)
+    std::cout << "closed: " << shared << "\n";
+
+    // the cycles going through the upvalues are collected
+    vm.call("leak", 3000);
+    vm.collectCycles();
+    std::cout << "collected: " << vm.cycleCollectorStats().scopes_collected << "\n";
+
+    RETURN_PASSED()
+}
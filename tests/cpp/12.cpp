@@ -0,0 +1,57 @@
+#include <iostream>
+#include <string>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+const std::string code = R"code(
+(let build (fun (n) {
+    (mut lst [])
+    (mut i 0)
+    (while (< i n) {
+        (set lst (append lst [i]))
+        (set i (+ 1 i)) })
+    lst }))
+(let work (fun () {
+    (mut data (build 10000))
+    (let first (len data))
+    # overwriting the variable gives up the first list
+    (set data (build 5000))
+    (+ first (len data)) }))
+(let keep (fun () {
+    (let data (build 10000))
+    # returning the list gives it to the caller, it isn't destroyed
+    data }))
+)code";
+
+int main()
+{
+    Ark::State state(Ark::DefaultFeatures | Ark::FeatureDeferredDestruction);
+    state.doString(code);
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    Ark::Value result = vm.call("work");
+    CHECK_VALUE_NUMBER(result, 15000)
+    // the list overwritten and the one left in the frame
+    std::cout << "work: " << result << ", deferred " << vm.deferredDestructions() << "\n";
+
+    Ark::Value kept = vm.call("keep");
+    if (kept.valueType() != Ark::ValueType::List || kept.constList().size() != 10000)
+    {
+        std::cerr << "the list returned by keep was modified\n";
+        return 1;
+    }
+    std::cout << "keep: " << kept.constList().size() << ", deferred " << vm.deferredDestructions() << "\n";
+
+    // without the option, everything is destroyed by the VM
+    Ark::State default_state;
+    default_state.doString(code);
+    Ark::VM default_vm(&default_state);
+    CHECK_VM_RUN(default_vm)
+    default_vm.call("work");
+    std::cout << "default: deferred " << default_vm.deferredDestructions() << "\n";
+
+    RETURN_PASSED()
+}
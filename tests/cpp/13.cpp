@@ -0,0 +1,77 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+namespace
+{
+    int mallocs = 0;
+    int frees = 0;
+
+    void* countingMalloc(std::size_t size)
+    {
+        ++mallocs;
+        return std::malloc(size);
+    }
+
+    void countingFree(void* ptr)
+    {
+        ++frees;
+        std::free(ptr);
+    }
+}
+
+int main()
+{
+    Ark::State state;
+    state.doString(R"code(
+(let make-counter (fun (start) (fun (&start) { start })))
+(let work (fun (n) {
+    (mut lst [])
+    (mut d (dict))
+    (mut i 0)
+    (while (< i n) {
+        (set lst (append lst [i (make-counter i)]))
+        (set d (dict:set d i (len lst)))
+        (set i (+ 1 i)) })
+    (+ (len lst) (dict:size d)) }))
+)code");
+
+    // the memory is given back to the allocator which created it
+    Ark::PoolAllocator pool;
+    {
+        Ark::VM vm(&state);
+        vm.setAllocator(&pool);
+        CHECK_VM_RUN(vm)
+        Ark::Value result = vm.call("work", 1000);
+        CHECK_VALUE_NUMBER(result, 2000)
+        if (pool.bytesAllocated() == 0 || pool.bytesInUse() == 0)
+        {
+            std::cerr << "the pool wasn't used\n";
+            return 1;
+        }
+    }
+    std::cout << "pool: " << pool.bytesInUse() << " bytes in use\n";
+
+    Ark::MallocAllocator counting(&countingMalloc, &countingFree);
+    {
+        Ark::VM vm(&state);
+        vm.setAllocator(&counting);
+        CHECK_VM_RUN(vm)
+        vm.call("work", 100);
+    }
+    std::cout << "malloc: " << (mallocs > 0 && mallocs == frees ? "balanced" : "unbalanced") << "\n";
+
+    Ark::ArenaAllocator arena;
+    {
+        Ark::VM vm(&state);
+        vm.setAllocator(&arena);
+        CHECK_VM_RUN(vm)
+        vm.call("work", 100);
+    }
+    std::cout << "arena: " << arena.bytesInUse() << " bytes in use, reserved " << (arena.bytesReserved() > 0) << "\n";
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+    state.doString(R"code(
+(mut kept nil)
+(let make-counter (fun (start) (fun (&start) { start })))
+(let handle (fun (n) {
+    (mut lst [])
+    (mut d (dict))
+    (mut i 0)
+    (while (< i n) {
+        (set lst (append lst [i (make-counter i)]))
+        (set d (dict:set d i (len lst)))
+        (set i (+ 1 i)) })
+    [(len lst) (dict:size d) ((@ (@ lst (- n 1)) 1))] }))
+(let keep (fun (n) {
+    (set kept (handle n))
+    (len kept) }))
+(let forget (fun () (set kept nil)))
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    // the temporaries of each call are thrown away, the result is copied out of the arena
+    for (int i = 0; i < 100; ++i)
+    {
+        Ark::Value result = vm.callInArena("handle", 200);
+        if (result.valueType() != Ark::ValueType::List || result.constList().size() != 3)
+        {
+            std::cerr << "unexpected result\n";
+            return 1;
+        }
+        CHECK_VALUE_NUMBER(result.constList()[0], 200)
+        CHECK_VALUE_NUMBER(result.constList()[2], 199)
+    }
+    std::cout << "handle: retained " << vm.retainedArenas() << "\n";
+
+    // a value stored in a global variable keeps its arena alive, until it's replaced
+    Ark::Value length = vm.callInArena("keep", 50);
+    CHECK_VALUE_NUMBER(length, 3)
+    std::cout << "keep: retained " << vm.retainedArenas() << "\n";
+
+    vm.call("forget");
+    vm.callInArena("handle", 10);
+    std::cout << "forget: retained " << vm.retainedArenas() << "\n";
+
+    RETURN_PASSED()
+}
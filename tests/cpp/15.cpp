@@ -0,0 +1,94 @@
+#include <iostream>
+#include <vector>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+namespace
+{
+    struct Image
+    {
+        std::vector<unsigned char> pixels = std::vector<unsigned char>(64 * 1024);
+    };
+
+    Ark::UserType::ControlFuncs* imageFuncs()
+    {
+        static Ark::UserType::ControlFuncs cfs;
+        cfs.size = [](const Ark::UserType& a) -> std::size_t {
+            return a.as<Image>().pixels.size();
+        };
+        return &cfs;
+    }
+}
+
+int main()
+{
+    Ark::State state;
+    state.loadFunction("load-image", [](std::vector<Ark::Value>& n, Ark::VM* vm) -> Ark::Value {
+        static Image image;
+        Ark::Value v = Ark::Value(Ark::UserType(&image));
+        v.usertypeRef().setControlFuncs(imageFuncs());
+        return v;
+    });
+
+    state.doString(R"code(
+(let grow (fun (n) {
+    (mut lst [])
+    (mut i 0)
+    (while (< i n) {
+        (set lst (append lst [i (fun (&i) { i })]))
+        (set i (+ 1 i)) })
+    (len lst) }))
+(let fill (fun (n) (list:fill n [n n])))
+(mut image nil)
+(let open (fun () (set image (load-image))))
+(let close (fun () (del image)))
+(let scoped (fun () { (let local (load-image)) 1 }))
+(let twice (fun () { (let a (load-image)) (let b a) (del a) (del b) }))
+)code");
+
+    Ark::VM vm(&state);
+    vm.setMemoryLimit(1024 * 1024);
+    CHECK_VM_RUN(vm)
+
+    // the temporaries are counted while they exist
+    const std::size_t before = vm.memoryUsage();
+    Ark::Value length = vm.call("grow", 1000);
+    CHECK_VALUE_NUMBER(length, 1000)
+    vm.collectCycles();
+    std::cout << "grow: " << (vm.memoryUsage() - before < 1024 ? "freed" : "leaked") << "\n";
+
+    // the size reported by a UserType is counted until it's deleted
+    vm.call("open");
+    std::cout << "open: " << (vm.memoryUsage() - before >= 64 * 1024 ? "counted" : "missing") << "\n";
+    vm.call("close");
+    std::cout << "close: " << (vm.memoryUsage() - before < 1024 ? "freed" : "leaked") << "\n";
+    // or until its last copy is gone, and only once
+    vm.call("scoped");
+    std::cout << "scoped: " << (vm.memoryUsage() - before < 1024 ? "freed" : "leaked") << "\n";
+    vm.call("twice");
+    std::cout << "twice: " << (vm.memoryUsage() - before < 1024 ? "freed" : "leaked") << "\n";
+
+    // going over the limit stops the program with an error, and the VM can be used again
+    Ark::VM limited(&state);
+    limited.setMemoryLimit(64 * 1024);
+    CHECK_VM_RUN(limited)
+    limited.call("fill", 100000);
+    std::cout << "limit: exit code " << limited.exitCode() << "\n";
+    length = limited.call("grow", 10);
+    CHECK_VALUE_NUMBER(length, 10)
+
+    // the values can outlive the VM and the allocator it created
+    Ark::Value kept;
+    {
+        Ark::VM short_lived(&state);
+        short_lived.setMemoryLimit(1024 * 1024);
+        CHECK_VM_RUN(short_lived)
+        kept = short_lived.call("fill", 2);
+    }
+    std::cout << "kept: " << kept << "\n";
+    kept = Ark::Value();
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <sstream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+    state.doString(R"code(
+(let big (list:fill 1000 "element"))
+(let small ["a" "b"])
+(let holder [big])
+(let d (dict:set (dict) "key" [1 2 3]))
+(let make-counter (fun (start) (fun (&start) { start })))
+(let counters [(make-counter 1) (make-counter 2) (make-counter 3)])
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    const Ark::HeapProfile profile = vm.heapProfile();
+    auto of = [&profile](Ark::ValueType type) -> const Ark::HeapStats& {
+        return profile.by_type[static_cast<std::size_t>(type)];
+    };
+
+    // big and holder share a list, which is counted once
+    std::cout << "lists: " << of(Ark::ValueType::List).count << "\n";
+    std::cout << "dicts: " << of(Ark::ValueType::Dict).count << "\n";
+    std::cout << "closures: " << of(Ark::ValueType::Closure).count << " from " << profile.closures.size() << " function\n";
+
+    // a shared list isn't retained by any of its holders
+    std::cout << "big retained: " << (profile.globals.at("big") == 0 ? "none" : "some") << "\n";
+    std::cout << "small retained: " << (profile.globals.at("small") > 0 ? "some" : "none") << "\n";
+    std::cout << "d retained: " << (profile.globals.at("d") > of(Ark::ValueType::Dict).shallow ? "table and list" : "table") << "\n";
+
+    const Ark::HeapStats total = profile.total();
+    std::cout << "total: " << (total.retained == total.shallow && total.shallow > 1000 * sizeof(Ark::Value) ? "ok" : "wrong") << "\n";
+
+    // the report is the same from one census to another
+    std::ostringstream first, second;
+    profile.write(first);
+    vm.heapProfile().write(second);
+    std::cout << "stable: " << std::boolalpha << (first.str() == second.str()) << "\n";
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,49 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+    state.doString(R"code(
+(let key "name")
+(let text "a string longer than twenty two bytes")
+(let joined (+ "a string longer " "than twenty two bytes"))
+(let pair (+ "abc" "def"))
+(let rest (tail "hello"))
+(let removed (str:removeAt "hello" 1))
+(let used [key text])
+(let sliced (tail (tail joined)))
+(let grown (+ sliced "!"))
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    std::cout << "Value_t size: " << sizeof(Ark::Value::Value_t) << "\n";
+    std::cout << "short inline: " << std::boolalpha << vm["key"].string().isInline() << "\n";
+    std::cout << "long inline: " << vm["text"].string().isInline() << "\n";
+    std::cout << "concatenation inline: " << vm["pair"].string().isInline() << " " << vm["pair"] << "\n";
+    std::cout << "tail and removeAt: " << vm["rest"] << " " << vm["removed"] << "\n";
+
+    // the string constants are interned when the bytecode is loaded
+    Ark::Value text = vm["text"];
+    Ark::Value interned = state.intern("a string longer than twenty two bytes");
+    std::cout << "constant interned: " << text.string().interned() << "\n";
+    std::cout << "same buffer: " << (text.string().c_str() == interned.string().c_str()) << "\n";
+
+    // a string built at runtime isn't interned, it's compared by content
+    Ark::Value joined = vm["joined"];
+    std::cout << "built interned: " << joined.string().interned() << "\n";
+    std::cout << "equal: " << (joined == text) << " " << (vm["key"] == Ark::Value("name")) << "\n";
+
+    // the tail of a long string is a view on its buffer, which can still be appended to
+    Ark::Value sliced = vm["sliced"];
+    std::cout << "tail shared: " << (sliced.string().view().data() == joined.string().view().data() + 2) << "\n";
+    std::cout << "tail: " << sliced.string().c_str() << " | " << vm["grown"].string().c_str() << " | " << joined.string().c_str() << "\n";
+    std::cout << "tail equal: " << (sliced == Ark::Value("string longer than twenty two bytes")) << " " << (sliced == joined) << "\n";
+
+    RETURN_PASSED()
+}
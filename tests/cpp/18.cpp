@@ -0,0 +1,47 @@
+#include <iostream>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    Ark::State state;
+    state.doString(R"code(
+(let s (+ "a string longer than " "twenty two bytes"))
+(let a (+ s " and a"))
+(let b (+ s " and b"))
+
+(mut out "")
+(mut i 0)
+(while (< i 1000) {
+    (set out (+ out "line " (toString i) "\n"))
+    (set i (+ 1 i))
+})
+)code");
+
+    Ark::VM vm(&state);
+    CHECK_VM_RUN(vm)
+
+    // a and b were both built from s, the first one in the buffer of s
+    Ark::Value s = vm["s"];
+    Ark::Value a = vm["a"];
+    Ark::Value b = vm["b"];
+    std::cout << s << "\n" << a << "\n" << b << "\n";
+    std::cout << "shared buffer: " << std::boolalpha << (s.string().view().data() == a.string().view().data()) << "\n";
+    std::cout << "c strings: " << s.string().c_str() << " | " << a.string().c_str() << "\n";
+
+    Ark::Value out = vm["out"];
+    std::cout << "built size: " << out.string().size() << "\n";
+    std::cout << "last line: " << out.string().view().substr(out.string().size() - 9);
+    std::cout << "capacity under twice the size: " << (out.string().capacity() <= 2 * out.string().size() + 1) << "\n";
+
+    // appending to a copy doesn't modify the original string
+    Ark::internal::SharedString first = a.string();
+    Ark::internal::SharedString second = first;
+    first.append(" and more");
+    second.append(" and others");
+    std::cout << first << "\n" << second << "\n" << a << "\n";
+
+    RETURN_PASSED()
+}
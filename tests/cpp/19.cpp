@@ -0,0 +1,144 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <Ark/Ark.hpp>
+#include <Ark/Compiler/CppEmitter.hpp>
+
+#include "Tests.hpp"
+
+const std::string code = R"code(
+(let fib (fun (n)
+    (if (< n 2)
+        n
+        (+ (fib (- n 1)) (fib (- n 2))))))
+
+(let loop (fun (n) {
+    (mut i 0)
+    (mut acc 0)
+    (while (< i n) {
+        (if (>= (/ i 2) 3)
+            (set acc (+ acc (* i 1.5)))
+            (set acc (- acc 1)))
+        (set i (+ i 1)) })
+    acc }))
+
+(let sum (fun (n) {
+    (mut total 0)
+    (mut i 0)
+    (while (< i n) {
+        (set total (+ total i))
+        (set i (+ 1 i)) })
+    total }))
+
+(let compare (fun (a b) [(< a b) (<= a b) (> a b) (>= a b) (= a b) (!= a b)]))
+
+(let result [
+    (fib 15)
+    (loop 20)
+    (compare 1 2)
+    (compare "b" "a")
+    (compare math:NaN 1)
+    (/ 1 0.5)])
+)code";
+
+// the module is built in the current directory, a path without a slash would be looked up in the library paths
+const std::string source = "./19-native.cpp";
+const std::string module = "./19-native.so";
+
+std::string run(Ark::State& state)
+{
+    Ark::VM vm(&state);
+    if (vm.run() != 0)
+        return "vm.run() failed";
+
+    std::stringstream ss;
+    ss << vm["result"];
+    return ss.str();
+}
+
+// the loops of the native code are preempted like the interpreted ones
+std::string preempt(Ark::State& state)
+{
+    Ark::VM vm(&state);
+    if (vm.run() != 0)
+        return "vm.run() failed";
+
+    vm.setBudget(1000);
+    Ark::Value result = vm.call("sum", 10000);
+    int slices = 1;
+    while (vm.preempted())
+    {
+        result = vm.resume();
+        ++slices;
+    }
+
+    std::stringstream ss;
+    ss << result << (slices >= 10 ? " in slices" : " without being preempted");
+    return ss.str();
+}
+
+bool build()
+{
+    std::string command = std::string(ARK_TEST_CXX) + " -std=c++17 -shared -fPIC " + ARK_TEST_INCLUDES +
+        " " + source + " " + ARK_TEST_LIBRARY + " -o " + module;
+    return std::system(command.c_str()) == 0;
+}
+
+int main()
+{
+    std::string interpreted;
+    {
+        Ark::State state;
+        if (!state.doString(code))
+            return 1;
+        interpreted = run(state);
+
+        if (!Ark::CppEmitter(state).saveTo(source))
+        {
+            std::cerr << "couldn't write " << source << "\n";
+            return 1;
+        }
+    }
+
+    if (!build())
+    {
+        std::cerr << "couldn't build " << source << "\n";
+        return 1;
+    }
+
+    {
+        Ark::State state;
+        if (!state.doString(code))
+            return 1;
+        if (!state.loadNativePages(module))
+            return 1;
+
+        std::string native = run(state);
+        if (native != interpreted)
+        {
+            std::cerr << "native code returned " << native << "\n"
+                      << "interpreter returned  " << interpreted << "\n";
+            return 1;
+        }
+        std::cout << native << "\n";
+        std::cout << "sum: " << preempt(state) << "\n";
+    }
+
+    // a module generated from another program is rejected
+    {
+        Ark::State state;
+        if (!state.doString("(let result (+ 1 2))"))
+            return 1;
+        bool loaded = state.loadNativePages(module);
+        std::cout << "other program loaded: " << std::boolalpha << loaded << "\n";
+        std::cout << "still runs: " << run(state) << "\n";
+    }
+
+    std::filesystem::remove(source);
+    std::filesystem::remove(module);
+
+    RETURN_PASSED()
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <Ark/Ark.hpp>
+
+#include "Tests.hpp"
+
+int main()
+{
+    // both lines are written at once, reading the first one must not hide the second one from poll
+    int fds[2];
+    if (pipe(fds) != 0 || dup2(fds[0], 0) < 0)
+        return 1;
+    close(fds[0]);
+    const char lines[] = "first\nsecond\n";
+    if (write(fds[1], lines, sizeof(lines) - 1) != sizeof(lines) - 1)
+        return 1;
+
+    Ark::State state;
+    state.doString(R"code(
+(let a (input))
+(let b (input))
+)code");
+
+    Ark::VM vm(&state);
+
+    Ark::VM::StepResult result = vm.step(50);
+    while (result.status != Ark::VM::StepResult::Status::Done)
+    {
+        if (result.status == Ark::VM::StepResult::Status::Blocked)
+        {
+            // the write end stays open, the host would wait forever for a line already sent
+            pollfd fd { 0, POLLIN, 0 };
+            if (poll(&fd, 1, 100) <= 0)
+            {
+                std::cerr << "blocked on stdin with a line available\n";
+                return 1;
+            }
+        }
+
+        result = vm.step(50);
+    }
+
+    if (vm.exitCode() != 0)
+        return 1;
+    std::cout << vm["a"] << " " << vm["b"] << "\n";
+
+    close(fds[1]);
+
+    RETURN_PASSED()
+}